@@ -0,0 +1,21 @@
+// STM32G4 implementation of the TFLM timer functions, on the Cortex-M4 DWT
+// cycle counter through con4/system/cycle_timer.c. Build it instead of the
+// reference tensorflow/lite/micro/micro_time.cc (which returns 0, so the
+// MicroProfiler sees no time) when TFLM runs on the board; ticks are CPU
+// cycles, so profiler numbers match the firmware's own cycle timers.
+//
+// GetCurrentTimeTicks() wraps every ~25 s at 170 MHz, like CYCLE_now().
+
+#include "tensorflow/lite/micro/micro_time.h"
+
+extern "C" {
+#include "cycle_timer.h"
+}
+
+namespace tflite {
+
+uint32_t ticks_per_second() { return CYCLE_hz(); }
+
+uint32_t GetCurrentTimeTicks() { return CYCLE_now(); }
+
+}  // namespace tflite
@@ -7,9 +7,16 @@
 
 
 #include "DEBUG_functions.h"
+#include "game.h"
+#include "trace_events.h"
 
-/* Print probabilities for debugging.*/
+/* Print probabilities for debugging.
+ * With tracing enabled only the raw outputs are logged; the host decoder prints them. */
 void DEBUG_printf_nodes(float* probabilities) {
+#if TRACE_ENABLED
+    TRACE_record(TRACE_AI_OUTPUT, probabilities, COLS * sizeof(float));
+    return;
+#endif
     for (int i = 1; i < 8; i++) {
         int integer = (int)probabilities[i];
         int decimal = (int)(probabilities[i] * 100) % 100;
@@ -21,6 +28,11 @@ void DEBUG_printf_nodes(float* probabilities) {
 void visualize_state(ai_i8 state[147]) {
     int num;
 
+#if TRACE_ENABLED
+    TRACE_record(TRACE_AI_INPUT, state, 147);
+    return;
+#endif
+
     // First 126 elements
     for (num = 0; num < 126; num++) {
         printf("%d, ", state[num]);
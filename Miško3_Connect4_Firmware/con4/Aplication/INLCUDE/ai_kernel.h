@@ -0,0 +1,45 @@
+/*
+ * ai_kernel.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INLCUDE_AI_KERNEL_H_
+#define INLCUDE_AI_KERNEL_H_
+
+#include "game.h"
+
+/*
+ * Portable float implementation of python_model: 147 inputs, two hidden
+ * dense layers of 100 with ReLU, 7 outputs (one per column, no softmax).
+ * The weights are read straight from the X-CUBE-AI blob
+ * s_python_model_weights_array_u64 at the offsets of the generated
+ * python_model_configure_weights(), so a regenerated model is picked up
+ * without conversion. HAL-free: used by the host tools, and its input copy
+ * and move choice by ai_model.c on the board.
+ */
+
+#define AI_KERNEL_INPUTS     147
+#define AI_KERNEL_HIDDEN     100
+#define AI_KERNEL_OUTPUTS    COLS
+#define AI_KERNEL_LAYERS     3
+#define AI_KERNEL_BLOCK      8       // positions per weight pass in ai_kernel_run_batch()
+
+// One dense layer: weights[out * inputs + in] (ONNX Gemm layout), bias[out]
+typedef struct {
+    const float* weights;
+    const float* bias;
+    int inputs;
+    int outputs;
+    int relu;
+} ai_kernel_layer_t;
+
+const ai_kernel_layer_t* ai_kernel_layer(int index);
+
+void ai_kernel_input_from_state(const ai_i8* state, float* input);
+void ai_kernel_dense(const ai_kernel_layer_t* layer, const float* in, float* out);
+void ai_kernel_run(const float* input, float* output);
+void ai_kernel_run_batch(const float* inputs, float* outputs, int count);
+int ai_kernel_best_move(const float* values);
+
+#endif /* INLCUDE_AI_KERNEL_H_ */
@@ -9,6 +9,7 @@ extern "C" {
 
 void MX_X_CUBE_AI_Init(void);
 int get_action(ai_i8* state);
+int get_action_values(ai_i8* state, float* values);
 
 #ifdef __cplusplus
 }
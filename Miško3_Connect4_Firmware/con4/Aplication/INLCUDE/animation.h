@@ -0,0 +1,29 @@
+/*
+ * animation.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INLCUDE_ANIMATION_H_
+#define INLCUDE_ANIMATION_H_
+
+#include <stdint.h>
+
+#define ANIMATION_FPS      60
+#define DROP_GRAVITY       3200    // px/s^2, a full column falls in ~350 ms
+
+typedef struct {
+    uint32_t frames;               // frames drawn
+    uint32_t missed_frames;        // frame slots skipped because the loop was late
+    uint32_t worst_frame_ms;       // longest time spent drawing one frame
+    uint32_t duration_ms;          // length of the whole drop
+} animation_stats_t;
+
+void drop_animation_start(int col, int row, uint16_t colour);
+int drop_animation_update(void);
+int drop_animation_running(void);
+uint32_t drop_animation_ms_to_next_frame(void);
+const animation_stats_t* drop_animation_stats(void);
+void drop_animation_print_stats(void);
+
+#endif /* INLCUDE_ANIMATION_H_ */
@@ -0,0 +1,35 @@
+/*
+ * bench.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INLCUDE_BENCH_H_
+#define INLCUDE_BENCH_H_
+
+#include <stdint.h>
+
+/*
+ * Micro-benchmarks of the engine hot paths on a fixed corpus of positions,
+ * timed with cycle_timer.c: DWT cycles on the board (serial command 'b'),
+ * host clock nanoseconds in tools/bench.
+ */
+
+#define BENCH_CORPUS_SIZE    32      // positions, generated from a fixed seed
+#define BENCH_REPEAT         16      // operations per position per timed batch
+
+typedef struct {
+    const char* name;
+    uint64_t ops;
+    uint64_t cycles;
+    uint32_t min_batch;              // fastest and slowest batch of BENCH_REPEAT ops
+    uint32_t max_batch;
+} bench_result_t;
+
+typedef void (*bench_report_t)(const bench_result_t* result);
+
+int bench_run(uint32_t passes, bench_report_t report);
+void bench_print_csv_header(void);
+void bench_print_csv(const bench_result_t* result);
+
+#endif /* INLCUDE_BENCH_H_ */
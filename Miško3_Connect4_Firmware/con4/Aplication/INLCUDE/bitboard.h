@@ -0,0 +1,111 @@
+/*
+ * bitboard.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INLCUDE_BITBOARD_H_
+#define INLCUDE_BITBOARD_H_
+
+#include <stdint.h>
+
+#include "game.h"
+
+/*
+ * Connect 4 position packed into two 64-bit words, for the search.
+ * Each column takes BB_HEIGHT bits, bottom row first; the extra bit on top
+ * of every column stays empty so that a shifted line never wraps into the
+ * next column:
+ *
+ *   bit = col * BB_HEIGHT + row        (row 0 is the bottom, as in game.board)
+ *
+ * `current` holds the discs of the player to move, `mask` all discs.
+ */
+
+#define BB_HEIGHT    (ROWS + 1)
+#define BB_CELLS     (ROWS * COLS)
+
+typedef struct {
+    uint64_t current;
+    uint64_t mask;
+    int moves;
+} bitboard_t;
+
+static inline uint64_t bb_bottom_mask(int col) {
+    return 1ULL << (col * BB_HEIGHT);
+}
+
+static inline uint64_t bb_top_mask(int col) {
+    return 1ULL << (ROWS - 1 + col * BB_HEIGHT);
+}
+
+static inline uint64_t bb_column_mask(int col) {
+    return ((1ULL << ROWS) - 1) << (col * BB_HEIGHT);
+}
+
+static inline int bb_can_play(const bitboard_t* b, int col) {
+    return (b->mask & bb_top_mask(col)) == 0;
+}
+
+// Drop a disc for the player to move; the other player is to move afterwards
+static inline void bb_play(bitboard_t* b, int col) {
+    b->current ^= b->mask;
+    b->mask |= b->mask + bb_bottom_mask(col);
+    b->moves++;
+}
+
+// Non-zero if `discs` contains four in a row
+static inline int bb_has_four(uint64_t discs) {
+    static const int directions[4] = { 1, BB_HEIGHT - 1, BB_HEIGHT, BB_HEIGHT + 1 };
+
+    for (int i = 0; i < 4; i++) {
+        uint64_t pairs = discs & (discs >> directions[i]);
+        if (pairs & (pairs >> (2 * directions[i]))) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Would the player to move win by playing `col`? `col` must be playable.
+static inline int bb_is_winning_move(const bitboard_t* b, int col) {
+    uint64_t discs = b->current | ((b->mask + bb_bottom_mask(col)) & bb_column_mask(col));
+    return bb_has_four(discs);
+}
+
+// Build from a game.board style array. Cells holding neither `player`
+// (to move) nor `opponent`, such as the pre-move, count as empty.
+static inline void bb_from_board(bitboard_t* b, const int board[ROWS][COLS], int player, int opponent) {
+    b->current = 0;
+    b->mask = 0;
+    b->moves = 0;
+
+    for (int col = 0; col < COLS; col++) {
+        for (int row = 0; row < ROWS; row++) {
+            uint64_t bit = 1ULL << (col * BB_HEIGHT + row);
+            if (board[row][col] == player) {
+                b->current |= bit;
+            } else if (board[row][col] != opponent) {
+                continue;
+            }
+            b->mask |= bit;
+            b->moves++;
+        }
+    }
+}
+
+// The reverse: the player to move as `player`, the other as `opponent`
+static inline void bb_to_board(const bitboard_t* b, int board[ROWS][COLS], int player, int opponent) {
+    for (int col = 0; col < COLS; col++) {
+        for (int row = 0; row < ROWS; row++) {
+            uint64_t bit = 1ULL << (col * BB_HEIGHT + row);
+            if (!(b->mask & bit)) {
+                board[row][col] = 0;
+            } else {
+                board[row][col] = (b->current & bit) ? player : opponent;
+            }
+        }
+    }
+}
+
+#endif /* INLCUDE_BITBOARD_H_ */
@@ -33,22 +33,33 @@ typedef struct {
 
 } Connect4;
 
+// Host tools play several games at once, one per thread: tools/CMakeLists.txt
+// defines this as _Thread_local for the engine state (game, search.c)
+#ifndef ENGINE_THREAD_LOCAL
+#define ENGINE_THREAD_LOCAL
+#endif
+
 //making the game struct global across .c files
-extern Connect4 game;
+extern ENGINE_THREAD_LOCAL Connect4 game;
 
 
 
 
+// board.c: board logic and network input, no hardware (also built on the host)
 void reset_board(void);
 void printf_render();
 int make_move(int move_col, int player);
 int subtract_move(int col);
-int got_human_move(int* human_move );
 void delete_pre_move(void);
-int got_ai_move(ai_i8 state[147], int*move);
 int check_win(int player);
 int check_draw(void);
 int check_if_valid(int move_col);
 int get_state(ai_i8* state);
 
+// game.c: keyboard, LCD and trace
+void log_board(void);
+int got_human_move(int* human_move );
+void update_pre_move(int* human_move);
+int got_ai_move(ai_i8 state[147], int*move);
+
 #endif /* GAME_H */
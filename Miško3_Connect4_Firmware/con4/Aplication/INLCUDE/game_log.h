@@ -0,0 +1,37 @@
+/*
+ * game_log.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INLCUDE_GAME_LOG_H_
+#define INLCUDE_GAME_LOG_H_
+
+#include <stdint.h>
+
+#include "game_record.h"
+
+// The flash ring (erase and program from the game task) has not been run on a
+// board yet. Until it has, the records only go out in the trace; build with
+// GAME_LOG_FLASH_WRITE=1 to store them in the GAMELOG region as well.
+#ifndef GAME_LOG_FLASH_WRITE
+#define GAME_LOG_FLASH_WRITE 0
+#endif
+
+typedef struct {
+    uint32_t slots;                // records the flash ring holds
+    uint32_t stored;               // valid records in it now
+    uint32_t appended;             // records written since reset
+    uint32_t write_errors;         // erase, program or read-back failures
+    uint32_t erase_us;             // last page erase
+    uint32_t program_us;           // last record write
+} game_log_stats_t;
+
+void game_log_init(void);
+uint32_t game_log_next_sequence(void);
+int game_log_append(const game_record_t* rec);
+void game_log_dump(void);
+void game_log_service(void);
+const game_log_stats_t* game_log_stats(void);
+
+#endif /* INLCUDE_GAME_LOG_H_ */
@@ -0,0 +1,79 @@
+/*
+ * game_record.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INLCUDE_GAME_RECORD_H_
+#define INLCUDE_GAME_RECORD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "game.h"
+
+/*
+ * One played game, written by state_machine.c and kept by game_log.c (flash
+ * ring, trace stream). The record is enough to replay the game through the
+ * engine and reproduce every AI decision (tools/replay): the moves, and per
+ * AI move the search_step() count of the search behind it and whether the
+ * network ranked the unproven moves.
+ *
+ * Fixed size, little-endian, no padding: the same bytes on the board and on
+ * the host. Only append fields at the end and raise GAME_RECORD_VERSION.
+ */
+
+#define GAME_RECORD_MAGIC        0x5247          // "GR"
+#define GAME_RECORD_VERSION      1
+#define GAME_RECORD_MAX_PLIES    (ROWS * COLS)
+#define GAME_RECORD_MAX_AI       ((GAME_RECORD_MAX_PLIES + 1) / 2)
+#define GAME_RECORD_MOVE_BYTES   ((3 * GAME_RECORD_MAX_PLIES + 7) / 8)
+
+typedef enum {
+    GAME_RECORD_HUMAN_WON = 0,     // same values as TRACE_GAME_RESULT
+    GAME_RECORD_AI_WON,
+    GAME_RECORD_DRAW,
+    GAME_RECORD_UNFINISHED
+} game_record_result_t;
+
+typedef struct {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t plies;
+    uint32_t sequence;             // games recorded on this board, from 0
+    uint32_t start_ms;             // HAL_GetTick() when the game started
+    uint8_t result;                // game_record_result_t
+    uint8_t ai_first;              // 1: the AI made ply 0
+    uint8_t ai_moves;
+    uint8_t reserved;
+    uint32_t prior_mask;           // bit n: AI move n was ranked by the network, else centre first
+    uint8_t moves[GAME_RECORD_MOVE_BYTES];        // 3 bits per ply, ply n in bits 3n..3n+2
+    uint16_t ply_ms[GAME_RECORD_MAX_PLIES];       // time to choose the move: think or human time, saturated
+    uint32_t search_steps[GAME_RECORD_MAX_AI];    // search_stats_t.steps of each AI move
+    uint32_t crc;                  // CRC-32 (zlib) of everything before it
+} game_record_t;
+
+_Static_assert(sizeof(game_record_t) == 208, "game_record_t layout changed");
+_Static_assert(sizeof(game_record_t) % 8 == 0, "flash is programmed in double words");
+
+// Column of ply `ply`
+static inline int game_record_move(const game_record_t* rec, int ply) {
+    unsigned bit = 3u * ply;
+    unsigned bits = rec->moves[bit / 8] | ((bit / 8 + 1 < GAME_RECORD_MOVE_BYTES) ? rec->moves[bit / 8 + 1] << 8 : 0);
+
+    return (bits >> (bit % 8)) & 7;
+}
+
+// AI move number of ply `ply`, or -1 if the human made it
+static inline int game_record_ai_index(const game_record_t* rec, int ply) {
+    return ((ply & 1) == (rec->ai_first ? 0 : 1)) ? ply / 2 : -1;
+}
+
+void game_record_start(game_record_t* rec, uint32_t sequence, uint32_t start_ms, int ai_first);
+int game_record_add_move(game_record_t* rec, int col, uint32_t ms);
+void game_record_set_search(game_record_t* rec, uint32_t steps, int used_prior);
+void game_record_finish(game_record_t* rec, game_record_result_t result);
+int game_record_is_valid(const game_record_t* rec);
+uint32_t game_record_crc32(const void* data, size_t size);
+
+#endif /* INLCUDE_GAME_RECORD_H_ */
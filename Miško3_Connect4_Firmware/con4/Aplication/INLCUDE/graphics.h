@@ -12,8 +12,12 @@
 #define PIECE_RADIUS 17
 #define SHIFT_X 0
 #define SHIFT_Y -17
+#define PIECE_STEP (WALL_WITH + PIECE_RADIUS * 2)
 
 void draw_circle(int x0, int y0, int radius, uint16_t piece_colour);
+int circle_half_width(int radius, int dy);
+int piece_centre_x(int col);
+int piece_centre_y(int row);
 void render_empty_board(void);
 void render_pieces(void);
 void render_ai_won(void);
@@ -0,0 +1,33 @@
+/*
+ * image_decoder.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INLCUDE_IMAGE_DECODER_H_
+#define INLCUDE_IMAGE_DECODER_H_
+
+#include <stdint.h>
+
+#define IMAGE_MAX_WIDTH 320       // size of the line buffers
+
+// Palette + line based RLE image, produced by tools/img_pack
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    const uint16_t* palette;   // RGB565 colours
+    const uint8_t* data;       // token stream
+    uint32_t size;             // length of data in bytes
+} packed_image_t;
+
+typedef struct {
+    const packed_image_t* image;
+    const uint8_t* next;       // next token to decode
+    uint16_t line;             // next line to decode
+} image_decoder_t;
+
+void image_decoder_init(image_decoder_t* decoder, const packed_image_t* image);
+int image_decode_line(image_decoder_t* decoder, const uint16_t* above, uint16_t* line);
+void draw_packed_image(const packed_image_t* image, int x, int y);
+
+#endif /* INLCUDE_IMAGE_DECODER_H_ */
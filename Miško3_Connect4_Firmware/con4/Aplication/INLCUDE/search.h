@@ -0,0 +1,46 @@
+/*
+ * search.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INLCUDE_SEARCH_H_
+#define INLCUDE_SEARCH_H_
+
+#include <stdint.h>
+
+#include "bitboard.h"
+
+#define SEARCH_SLICE_US    2000    // longest the search runs before it yields to the other tasks
+#define SEARCH_THINK_MS    1500    // think time per AI move
+
+// What the search has proven about a root move
+typedef enum {
+    SEARCH_UNKNOWN = 0,            // no forced result within the searched depth
+    SEARCH_WIN,
+    SEARCH_LOSS,
+    SEARCH_ILLEGAL                 // column full
+} search_result_t;
+
+typedef struct {
+    uint32_t nodes;
+    uint32_t steps;                // search_step() calls, see search_set_max_steps()
+    uint32_t depth;                // deepest fully searched iteration (plies)
+    uint32_t slices;               // search_run() calls
+    uint32_t busy_cycles;          // time spent inside search_run()
+    uint32_t max_slice_cycles;
+    uint32_t wall_cycles;          // search_start() until the search finished
+} search_stats_t;
+
+void search_start(const bitboard_t* root, uint32_t think_ms);
+void search_set_max_depth(uint8_t depth);
+void search_set_max_steps(uint32_t steps);
+int search_run(uint32_t slice_us);
+void search_stop(void);
+int search_running(void);
+
+search_result_t search_get_result(int col);
+int search_best_move(const float* prior);
+const search_stats_t* search_get_stats(void);
+
+#endif /* INLCUDE_SEARCH_H_ */
@@ -10,7 +10,13 @@
 
 #include "stm32g4xx_hal.h"
 
-void Game(void);
+#define GAME_WAIT_KEY      (-1)    // nothing to do until a key is pressed
+#define GAME_WAIT_EVENT    (-2)    // nothing to do until another task wakes the game
+
+// Runs one step of the game. Returns how long the game task may sleep:
+// 0 to run the next step right away, a number of milliseconds,
+// GAME_WAIT_KEY or GAME_WAIT_EVENT.
+int32_t Game(void);
 
 
 
@@ -0,0 +1,51 @@
+/*
+ * tasks.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INLCUDE_TASKS_H_
+#define INLCUDE_TASKS_H_
+
+#include "scheduler.h"
+#include "ai_model.h"
+
+typedef enum {
+    SIG_STEP = SCHED_SIG_USER,     // game: run the next step of the state machine
+    SIG_AI_REQUEST,                // ai: choose a move for the stored position
+    SIG_AI_SLICE,                  // ai: run the next slice of the search
+    SIG_PONDER_START,              // ai: ponder the human's replies
+    SIG_ANIMATION_START,           // render: a drop animation was started
+    SIG_FRAME,                     // render: the next animation frame is due
+    SIG_SERVICE                    // log: periodic serial and trace service
+} app_signal_t;
+
+typedef struct {
+    uint32_t requests;             // AI moves asked for after pondering
+    uint32_t hits;                 // answer was ready
+    uint32_t partial_hits;         // answer was being searched and carried on
+    uint32_t misses;
+    uint64_t saved_cycles;         // search time done while the human was choosing
+} ponder_stats_t;
+
+// Replaying the search with search_set_max_steps(search_steps) and the same
+// prior gives the same move (game_record.h)
+typedef struct {
+    uint32_t search_steps;         // search_stats_t.steps of the search behind the move
+    uint8_t used_prior;            // the network ranked the unproven moves
+} ai_decision_t;
+
+#define SERVICE_PERIOD_MS    10    // 115200 baud fills the 256 B DMA staging buffer in ~22 ms
+
+void tasks_init(void);
+
+void tasks_request_ai_move(const ai_i8* state);
+void tasks_stop_ai_move(void);
+int tasks_ai_move_ready(int* move);
+const ai_decision_t* tasks_get_ai_decision(void);
+void tasks_start_ponder(int likely_col);
+void tasks_stop_ponder(void);
+const ponder_stats_t* tasks_get_ponder_stats(void);
+void tasks_start_drop_animation(void);
+
+#endif /* INLCUDE_TASKS_H_ */
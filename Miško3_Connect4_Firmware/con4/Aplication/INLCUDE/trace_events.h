@@ -0,0 +1,43 @@
+/*
+ * trace_events.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INLCUDE_TRACE_EVENTS_H_
+#define INLCUDE_TRACE_EVENTS_H_
+
+#include "trace.h"
+
+/*
+ * Game trace events, shared with the host decoder (tools/trace_decode).
+ * X(id, format): events with a format carry up to four uint32_t arguments
+ * (TRACE_EVENT0..4) that the decoder prints with that format. Events with
+ * a NULL format carry a raw payload and have their own printer in the decoder.
+ * Only append to the list, so old captures keep decoding.
+ */
+#define TRACE_EVENT_LIST(X) \
+    X(TRACE_GAME_START,  "game start") \
+    X(TRACE_MOVE,        "move player=%u col=%u row=%u") \
+    X(TRACE_BOARD,       NULL)   /* int8_t[ROWS][COLS], row 0 (bottom) first */ \
+    X(TRACE_AI_INPUT,    NULL)   /* ai_i8[147] network input */ \
+    X(TRACE_AI_OUTPUT,   NULL)   /* float[COLS] network output */ \
+    X(TRACE_AI_TIME,     "ai inference %u cycles") \
+    X(TRACE_GAME_RESULT, "game result=%u (0 human won, 1 AI won, 2 draw)") \
+    X(TRACE_DROP_STATS,  "drop: %u frames in %u ms, %u missed, worst frame %u ms") \
+    X(TRACE_SEARCH,      "search move=%u depth=%u nodes=%u slices=%u") \
+    X(TRACE_SEARCH_TIME, "search wall %u us, busy %u us, max slice %u us, overhead %u cycles/slice") \
+    X(TRACE_PONDER,      "ponder result=%u (0 miss, 1 hit, 2 partial hit), saved %u us, hits %u of %u") \
+    X(TRACE_JOY_SAMPLES, NULL)   /* uint16_t[JOY_DMA_BLOCK][2] raw joystick samples, X then Y */ \
+    X(TRACE_IDLE_STOP,   "stop %u ms, wake-up %u us, reason=%u (0 key, 1 timer)") \
+    X(TRACE_GAME_RECORD, NULL)   /* game_record_t of a finished or stored game */
+
+#define TRACE_EVENT_ENUM(id, format) id,
+
+typedef enum {
+    TRACE_EVENT_BASE = TRACE_ID_USER - 1,
+    TRACE_EVENT_LIST(TRACE_EVENT_ENUM)
+    TRACE_EVENT_END
+} trace_event_t;
+
+#endif /* INLCUDE_TRACE_EVENTS_H_ */
@@ -0,0 +1,120 @@
+/*
+ * ai_kernel.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Portable float kernel for python_model, see ai_kernel.h.
+ *
+ * The byte offsets below come from python_model_configure_weights() in
+ * X-CUBE-AI/App/python_model.c and the shapes from the generate report;
+ * keep them in step when the model is regenerated. The blob is an array of
+ * little-endian 64-bit words holding the float32 tensors back to back, so
+ * on a little-endian host it reads exactly as on the board.
+ */
+
+#include <stdint.h>
+
+#include "ai_kernel.h"
+#include "python_model_data_params.h"
+
+// python_model_data_params.c
+extern const ai_u64 s_python_model_weights_array_u64[];
+
+#define WEIGHTS(offset)    ((const float*)((const uint8_t*)s_python_model_weights_array_u64 + (offset)))
+
+static const ai_kernel_layer_t layers[AI_KERNEL_LAYERS] = {
+    { WEIGHTS(0),     WEIGHTS(58800),  AI_KERNEL_INPUTS, AI_KERNEL_HIDDEN,  1 },   // fc1 + ReLU
+    { WEIGHTS(59200), WEIGHTS(99200),  AI_KERNEL_HIDDEN, AI_KERNEL_HIDDEN,  1 },   // fc2 + ReLU
+    { WEIGHTS(99600), WEIGHTS(102400), AI_KERNEL_HIDDEN, AI_KERNEL_OUTPUTS, 0 },   // output_0
+};
+
+const ai_kernel_layer_t* ai_kernel_layer(int index) {
+    return &layers[index];
+}
+
+// The network input as get_action_values() feeds it: one float per state byte
+void ai_kernel_input_from_state(const ai_i8* state, float* input) {
+    for (int i = 0; i < AI_KERNEL_INPUTS; i++) {
+        input[i] = state[i];
+    }
+}
+
+void ai_kernel_dense(const ai_kernel_layer_t* layer, const float* in, float* out) {
+    for (int o = 0; o < layer->outputs; o++) {
+        const float* w = &layer->weights[o * layer->inputs];
+        float acc = layer->bias[o];
+
+        for (int i = 0; i < layer->inputs; i++) {
+            acc += w[i] * in[i];
+        }
+        out[o] = (layer->relu && acc < 0.0f) ? 0.0f : acc;
+    }
+}
+
+void ai_kernel_run(const float* input, float* output) {
+    float hidden1[AI_KERNEL_HIDDEN];
+    float hidden2[AI_KERNEL_HIDDEN];
+
+    ai_kernel_dense(&layers[0], input, hidden1);
+    ai_kernel_dense(&layers[1], hidden1, hidden2);
+    ai_kernel_dense(&layers[2], hidden2, output);
+}
+
+// ai_kernel_dense() for n <= AI_KERNEL_BLOCK positions, in and out one row
+// per position. Every weight is loaded once for the block and the positions
+// accumulate side by side, each in the same order as ai_kernel_dense(), so
+// the results are bit for bit the same, only without the serial add chain.
+static void dense_block(const ai_kernel_layer_t* layer, const float* in, float* out, int n) {
+    float x[AI_KERNEL_INPUTS][AI_KERNEL_BLOCK] = { { 0 } };
+
+    for (int k = 0; k < n; k++) {
+        for (int i = 0; i < layer->inputs; i++) {
+            x[i][k] = in[k * layer->inputs + i];
+        }
+    }
+    for (int o = 0; o < layer->outputs; o++) {
+        const float* w = &layer->weights[o * layer->inputs];
+        float acc[AI_KERNEL_BLOCK];
+
+        for (int k = 0; k < AI_KERNEL_BLOCK; k++) {
+            acc[k] = layer->bias[o];
+        }
+        for (int i = 0; i < layer->inputs; i++) {
+            for (int k = 0; k < AI_KERNEL_BLOCK; k++) {
+                acc[k] += w[i] * x[i][k];
+            }
+        }
+        for (int k = 0; k < n; k++) {
+            out[k * layer->outputs + o] = (layer->relu && acc[k] < 0.0f) ? 0.0f : acc[k];
+        }
+    }
+}
+
+// ai_kernel_run() on `count` positions, AI_KERNEL_INPUTS floats each in and
+// AI_KERNEL_OUTPUTS out. For the host tools: it needs ~11 KB of stack.
+void ai_kernel_run_batch(const float* inputs, float* outputs, int count) {
+    float hidden1[AI_KERNEL_BLOCK * AI_KERNEL_HIDDEN];
+    float hidden2[AI_KERNEL_BLOCK * AI_KERNEL_HIDDEN];
+
+    for (int b = 0; b < count; b += AI_KERNEL_BLOCK) {
+        int n = (count - b < AI_KERNEL_BLOCK) ? count - b : AI_KERNEL_BLOCK;
+
+        dense_block(&layers[0], &inputs[b * AI_KERNEL_INPUTS], hidden1, n);
+        dense_block(&layers[1], hidden1, hidden2, n);
+        dense_block(&layers[2], hidden2, &outputs[b * AI_KERNEL_OUTPUTS], n);
+    }
+}
+
+// The valid column of game.board with the highest value, -1 if the board is full
+int ai_kernel_best_move(const float* values) {
+    float max_value = -1000;
+    int move = -1;
+
+    for (int i = 0; i < COLS; i++) {
+        if (values[i] > max_value && check_if_valid(i)) {
+            max_value = values[i];
+            move = i;
+        }
+    }
+    return move;
+}
@@ -16,8 +16,18 @@
 #include "ai_datatypes_defines.h"
 #include "python_model.h"
 #include "python_model_data.h"
+#include "ai_platform_interface.h"
 #include "game.h"
+#include "ai_kernel.h"
 #include "DEBUG_functions.h"
+#include "trace_events.h"
+#include "cycle_timer.h"
+
+// Time every layer through the X-CUBE-AI observer (costs a callback per layer)
+#ifndef AI_NODE_TIMING
+#define AI_NODE_TIMING 1
+#endif
+#define AI_MAX_TIMED_NODES 8
 
 // Input/output buffers
 ai_i8 data_in_1[AI_PYTHON_MODEL_IN_1_SIZE_BYTES];
@@ -33,8 +43,50 @@ static ai_handle python_model = AI_HANDLE_NULL;
 static ai_buffer* ai_input;
 static ai_buffer* ai_output;
 
+// Inference time, for the whole network and per c-node (layer)
+static cycle_timer_t inference_timer;
+#if AI_NODE_TIMING
+static cycle_timer_t node_timers[AI_MAX_TIMED_NODES];
+static const char* const node_timer_names[AI_MAX_TIMED_NODES] = {
+    "ai_node0", "ai_node1", "ai_node2", "ai_node3",
+    "ai_node4", "ai_node5", "ai_node6", "ai_node7"
+};
+#endif
+
 // ---------------- Private Functions ----------------
 
+#if AI_NODE_TIMING
+static ai_u32 node_observer(const ai_handle cookie, const ai_u32 flags, const ai_observer_node* node) {
+    (void)cookie;
+
+    if (node->c_idx >= AI_MAX_TIMED_NODES) {
+        return 0;
+    }
+    if (flags & AI_OBSERVER_PRE_EVT) {
+        CYCLE_timer_start(&node_timers[node->c_idx]);
+    } else if (flags & AI_OBSERVER_POST_EVT) {
+        CYCLE_timer_stop(&node_timers[node->c_idx]);
+    }
+    return 0;
+}
+
+static void init_node_timing(void) {
+    ai_observer_node node_info;
+
+    for (int i = 0; i < AI_MAX_TIMED_NODES; i++) {
+        node_info.c_idx = i;
+        if (!ai_platform_observer_node_info(python_model, &node_info)) {
+            break;
+        }
+        CYCLE_timer_init(&node_timers[i], node_timer_names[i]);
+    }
+    if (!ai_platform_observer_register(python_model, node_observer, NULL,
+                                       AI_OBSERVER_PRE_EVT | AI_OBSERVER_POST_EVT)) {
+        printf("Error registering AI observer\n");
+    }
+}
+#endif
+
 static int INIT_AI_Model(ai_handle *act_addr) {
     ai_error err = ai_python_model_create_and_init(&python_model, act_addr, NULL);
     if (err.type != AI_ERROR_NONE) {
@@ -52,6 +104,12 @@ static int INIT_AI_Model(ai_handle *act_addr) {
         ai_output[i].data = data_outs[i];
     }
 
+    CYCLE_init();
+    CYCLE_timer_init(&inference_timer, "ai_inference");
+#if AI_NODE_TIMING
+    init_node_timing();
+#endif
+
     return 0;
 }
 
@@ -65,16 +123,7 @@ static int ai_run(void) {
 }
 
 static int choose_highest_node(ai_i8* data[]) {
-    float max_value = -1000;
-    int move = -1;
-    float* probabilities = (float*)data[0];
-
-    for (int i = 0; i < COLS; i++) {
-        if (probabilities[i] > max_value && check_if_valid(i)) {
-            max_value = probabilities[i];
-            move = i;
-        }
-    }
+    int move = ai_kernel_best_move((const float*)data[0]);
 
     if (move == -1) {
         while(1) {
@@ -91,18 +140,34 @@ void MX_X_CUBE_AI_Init(void) {
     INIT_AI_Model(activation_buffer);
 }
 
+// Run the network on `state` and copy its COLS outputs to `values`. Returns 0 on success.
+int get_action_values(ai_i8* state, float* values) {
+    if (!python_model) {
+        return -1;
+    }
+
+    // Copy state to AI input
+    ai_kernel_input_from_state(state, (float*)ai_input[0].data);
+    TRACE_record(TRACE_AI_INPUT, state, AI_PYTHON_MODEL_IN_1_SIZE);
+
+    CYCLE_timer_start(&inference_timer);
+    if (ai_run() != 0) {
+        return -1;
+    }
+    CYCLE_timer_stop(&inference_timer);
+    TRACE_EVENT1(TRACE_AI_TIME, inference_timer.last);
+    TRACE_record(TRACE_AI_OUTPUT, data_outs[0], COLS * sizeof(float));
+
+    memcpy(values, data_outs[0], COLS * sizeof(float));
+    return 0;
+}
+
 int get_action(ai_i8* state) {
     int best_move = -1;
+    float values[COLS];
 
-    if (python_model) {
-        // Copy state to AI input
-        for (int i = 0; i < AI_PYTHON_MODEL_IN_1_SIZE; i++) {
-            ((float*)ai_input[0].data)[i] = state[i];
-        }
-
-        if (ai_run() == 0) {
-            best_move = choose_highest_node(data_outs);
-        }
+    if (get_action_values(state, values) == 0) {
+        best_move = choose_highest_node(data_outs);
     }
 
     if (best_move == -1) {
@@ -0,0 +1,182 @@
+/*
+ * animation.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Falling-disc animation. The disc accelerates down its column and every
+ * frame only the pixels it vacates and enters are redrawn, so a frame costs
+ * a few hundred pixel writes instead of a full render_pieces().
+ * drop_animation_update() is called from the main loop and draws a frame
+ * whenever the next 1/ANIMATION_FPS slot is due.
+ */
+
+#include <stdio.h>
+
+#include "lcd.h"
+#include "animation.h"
+#include "graphics.h"
+#include "game.h"
+#include "timing_utils.h"
+#include "trace_events.h"
+
+static struct {
+    int running;
+    int col;
+    int target_row;
+    int x;                  // centre of the column
+    int start_y;            // centre of the top cell
+    int target_y;           // centre of the landing cell
+    int y;                  // centre as drawn on screen
+    uint16_t colour;
+    uint32_t next_frame;    // index of the next frame slot
+    stopwatch_handle_t stopwatch;
+    animation_stats_t stats;
+} drop;
+
+static uint16_t line_buffer[2 * PIECE_RADIUS + 1];
+
+// ------------------- Helpers ---------------------
+
+// Colour of the board under the disc: empty hole or the blue board itself
+static uint16_t background_colour(int x, int y) {
+    int dx = x - drop.x;
+
+    for (int row = drop.target_row; row < ROWS; row++) {
+        int dy = y - piece_centre_y(row);
+        if (dx * dx + dy * dy < PIECE_RADIUS * PIECE_RADIUS) {
+            return game.empty_colour;
+        }
+    }
+    return game.board_colour;
+}
+
+static void draw_background(int x1, int x2, int y) {
+    int n = 0;
+    for (int x = x1; x <= x2; x++) {
+        line_buffer[n++] = background_colour(x, y);
+    }
+    ILI9341_SetDisplayWindow(x1, y, n, 1);
+    ILI9341_SendData((LCD_IO_Data_t*)line_buffer, n);
+}
+
+// Redraw only the scanline segments that differ between the two positions
+static void move_disc(int old_y, int new_y) {
+    for (int y = old_y - PIECE_RADIUS; y <= new_y + PIECE_RADIUS; y++) {
+        int old_half = circle_half_width(PIECE_RADIUS, y - old_y);
+        int new_half = circle_half_width(PIECE_RADIUS, y - new_y);
+
+        if (y < 0 || new_half == old_half) {
+            continue;
+        }
+        if (new_half > old_half) {
+            int width = new_half - old_half;
+            LCD_FillRect(drop.x - new_half, y, width, 1, drop.colour);
+            LCD_FillRect(drop.x + old_half + 1, y, width, 1, drop.colour);
+        } else {
+            draw_background(drop.x - old_half, drop.x - new_half - 1, y);
+            draw_background(drop.x + new_half + 1, drop.x + old_half, y);
+        }
+    }
+}
+
+// Position after t ms of free fall, clamped to the landing cell.
+// The product is 64-bit: in 32 bits it wraps after ~1.16 s (a stall, e.g. 'b').
+static int fall_position(uint32_t t) {
+    uint64_t distance = ((uint64_t)DROP_GRAVITY * t * t) / 2000000;
+    uint32_t max_distance = drop.target_y - drop.start_y;
+
+    if (distance > max_distance) {
+        distance = max_distance;
+    }
+    return drop.start_y + (int)distance;
+}
+
+// ------------------- Public ---------------------
+
+// Start dropping a disc into `row` of `col`. The cell must still look empty.
+void drop_animation_start(int col, int row, uint16_t colour) {
+    drop.col = col;
+    drop.target_row = row;
+    drop.x = piece_centre_x(col);
+    drop.start_y = piece_centre_y(ROWS - 1);
+    drop.target_y = piece_centre_y(row);
+    drop.y = drop.start_y;
+    drop.colour = colour;
+    drop.next_frame = 1;
+    drop.stats = (animation_stats_t){0};
+    drop.running = 1;
+
+    // The landing cell may still show the human's pre-move
+    draw_circle(drop.x, drop.target_y, PIECE_RADIUS, game.empty_colour);
+    draw_circle(drop.x, drop.y, PIECE_RADIUS, colour);
+    TIMUT_stopwatch_set_time_mark(&drop.stopwatch);
+}
+
+// Draw the next frame if it is due. Returns 1 while the disc is still falling.
+int drop_animation_update(void) {
+    if (!drop.running) {
+        return 0;
+    }
+
+    uint32_t now = TIMUT_stopwatch_update(&drop.stopwatch);
+    uint32_t due = (drop.next_frame * 1000) / ANIMATION_FPS;
+    if (now < due) {
+        return 1;
+    }
+
+    // Skip the slots we were too late for, motion follows the real time
+    uint32_t slot = (now * ANIMATION_FPS) / 1000;
+    if (slot > drop.next_frame) {
+        drop.stats.missed_frames += slot - drop.next_frame;
+        drop.next_frame = slot;
+    }
+    drop.next_frame++;
+
+    int new_y = fall_position(now);
+    if (new_y < drop.y) {
+        new_y = drop.y;    // the disc never moves up, move_disc() only draws downwards
+    }
+    ILI9341_StatsScopeBegin("drop_frame");
+    move_disc(drop.y, new_y);
+    ILI9341_StatsScopeEnd();
+    drop.y = new_y;
+
+    uint32_t frame_time = TIMUT_stopwatch_update(&drop.stopwatch) - now;
+    if (frame_time > drop.stats.worst_frame_ms) {
+        drop.stats.worst_frame_ms = frame_time;
+    }
+    drop.stats.frames++;
+
+    if (drop.y == drop.target_y) {
+        drop.stats.duration_ms = now;
+        drop.running = 0;
+    }
+    return drop.running;
+}
+
+int drop_animation_running(void) {
+    return drop.running;
+}
+
+// Time until the next frame is due, rounded up so a timer never fires early
+uint32_t drop_animation_ms_to_next_frame(void) {
+    uint32_t now = TIMUT_stopwatch_update(&drop.stopwatch);
+    uint32_t due = (drop.next_frame * 1000 + ANIMATION_FPS - 1) / ANIMATION_FPS;
+
+    return (due > now) ? due - now : 0;
+}
+
+const animation_stats_t* drop_animation_stats(void) {
+    return &drop.stats;
+}
+
+void drop_animation_print_stats(void) {
+#if TRACE_ENABLED
+    TRACE_EVENT4(TRACE_DROP_STATS, drop.stats.frames, drop.stats.duration_ms,
+                 drop.stats.missed_frames, drop.stats.worst_frame_ms);
+#else
+    printf("Drop: %lu frames in %lu ms, %lu missed, worst frame %lu ms\n",
+           (unsigned long)drop.stats.frames, (unsigned long)drop.stats.duration_ms,
+           (unsigned long)drop.stats.missed_frames, (unsigned long)drop.stats.worst_frame_ms);
+#endif
+}
@@ -0,0 +1,243 @@
+/*
+ * bench.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Micro-benchmarks of the engine hot paths, shared by the board (serial
+ * command 'b') and the host (tools/bench), so both report the same
+ * operations on the same positions:
+ *
+ *   make_subtract_move  make_move() + subtract_move() in every open column
+ *   check_win           check_win() for both players
+ *   get_state           the 147-feature network input
+ *   input_copy          the int8 -> float copy of get_action_values()
+ *   dense_fc1/fc2/out   each dense layer of python_model (ai_kernel.c)
+ *   best_move           the move choice of get_action() (choose_highest_node)
+ *
+ * The corpus is BENCH_CORPUS_SIZE positions from 0 to 36 plies, played out
+ * from a fixed seed without ending the game. For every position the inputs of
+ * the operation are prepared untimed, then BENCH_REPEAT operations are timed
+ * as one batch, so the clock overhead stays small next to the operation.
+ * game.board is saved and restored, so this can run in the middle of a game.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "game.h"
+#include "ai_kernel.h"
+#include "cycle_timer.h"
+
+#define BENCH_MAX_PLIES    36
+
+typedef uint32_t (*bench_op_t)(void);   // returns the number of operations done
+
+static struct {
+    int built;
+    uint8_t moves[BENCH_CORPUS_SIZE][BENCH_MAX_PLIES];
+    uint8_t plies[BENCH_CORPUS_SIZE];
+} corpus;
+
+// Inputs and outputs of the operations for the current position
+static struct {
+    ai_i8 state[AI_KERNEL_INPUTS];
+    float input[AI_KERNEL_INPUTS];
+    float hidden1[AI_KERNEL_HIDDEN];
+    float hidden2[AI_KERNEL_HIDDEN];
+    float values[AI_KERNEL_OUTPUTS];
+} ctx;
+
+// Results feed this, so the compiler cannot drop the work
+static volatile uint32_t sink;
+
+// ------------------- Corpus ---------------------
+
+static uint32_t xorshift32(uint32_t* s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+// The player who makes ply `ply` of a game of `plies`, so the AI is to move after it
+static int player_of_ply(int ply, int plies) {
+    return ((plies - ply) % 2) ? game.PLAYER_HUMAN : game.PLAYER_AI;
+}
+
+static void build_corpus(void) {
+    uint32_t seed = 0x2545F491;
+
+    for (int i = 0; i < BENCH_CORPUS_SIZE; i++) {
+        int target = i * BENCH_MAX_PLIES / (BENCH_CORPUS_SIZE - 1);
+        int ply = 0;
+
+        reset_board();
+        for (int tries = 0; ply < target && tries < 8 * BENCH_MAX_PLIES; tries++) {
+            int col = xorshift32(&seed) % COLS;
+            int player = player_of_ply(ply, target);
+
+            if (!check_if_valid(col)) {
+                continue;
+            }
+            make_move(col, player);
+            if (check_win(player)) {
+                subtract_move(col);
+                continue;
+            }
+            corpus.moves[i][ply++] = col;
+        }
+        corpus.plies[i] = ply;
+    }
+    corpus.built = 1;
+}
+
+static void load_position(int index) {
+    int plies = corpus.plies[index];
+
+    reset_board();
+    for (int ply = 0; ply < plies; ply++) {
+        make_move(corpus.moves[index][ply], player_of_ply(ply, plies));
+    }
+}
+
+// Position `index` on game.board and every intermediate result in ctx
+static void prepare(int index) {
+    load_position(index);
+    get_state(ctx.state);
+    ai_kernel_input_from_state(ctx.state, ctx.input);
+    ai_kernel_dense(ai_kernel_layer(0), ctx.input, ctx.hidden1);
+    ai_kernel_dense(ai_kernel_layer(1), ctx.hidden1, ctx.hidden2);
+    ai_kernel_dense(ai_kernel_layer(2), ctx.hidden2, ctx.values);
+}
+
+// ------------------- Operations ---------------------
+
+static uint32_t op_make_subtract_move(void) {
+    uint32_t ops = 0;
+
+    for (int col = 0; col < COLS; col++) {
+        if (check_if_valid(col)) {
+            make_move(col, game.PLAYER_AI);
+            subtract_move(col);
+            ops++;
+        }
+    }
+    return ops;
+}
+
+static uint32_t op_check_win(void) {
+    sink += check_win(game.PLAYER_AI) + check_win(game.PLAYER_HUMAN);
+    return 2;
+}
+
+static uint32_t op_get_state(void) {
+    get_state(ctx.state);
+    sink += ctx.state[AI_KERNEL_INPUTS - 1];
+    return 1;
+}
+
+static uint32_t op_input_copy(void) {
+    ai_kernel_input_from_state(ctx.state, ctx.input);
+    sink += (uint32_t)ctx.input[AI_KERNEL_INPUTS - 1];
+    return 1;
+}
+
+static uint32_t op_dense_fc1(void) {
+    ai_kernel_dense(ai_kernel_layer(0), ctx.input, ctx.hidden1);
+    sink += (uint32_t)ctx.hidden1[0];
+    return 1;
+}
+
+static uint32_t op_dense_fc2(void) {
+    ai_kernel_dense(ai_kernel_layer(1), ctx.hidden1, ctx.hidden2);
+    sink += (uint32_t)ctx.hidden2[0];
+    return 1;
+}
+
+static uint32_t op_dense_out(void) {
+    ai_kernel_dense(ai_kernel_layer(2), ctx.hidden2, ctx.values);
+    sink += (uint32_t)ctx.values[0];
+    return 1;
+}
+
+static uint32_t op_best_move(void) {
+    sink += ai_kernel_best_move(ctx.values);
+    return 1;
+}
+
+static const struct {
+    const char* name;
+    bench_op_t op;
+} benches[] = {
+    { "make_subtract_move", op_make_subtract_move },
+    { "check_win",          op_check_win },
+    { "get_state",          op_get_state },
+    { "input_copy",         op_input_copy },
+    { "dense_fc1",          op_dense_fc1 },
+    { "dense_fc2",          op_dense_fc2 },
+    { "dense_out",          op_dense_out },
+    { "best_move",          op_best_move },
+};
+
+// ------------------- Public ---------------------
+
+// Run every benchmark `passes` times over the corpus and hand each result to `report`
+int bench_run(uint32_t passes, bench_report_t report) {
+    int saved_board[ROWS][COLS];
+
+    memcpy(saved_board, game.board, sizeof(saved_board));
+    CYCLE_init();
+    if (!corpus.built) {
+        build_corpus();
+    }
+
+    for (unsigned b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+        bench_result_t r = { benches[b].name, 0, 0, UINT32_MAX, 0 };
+
+        for (uint32_t pass = 0; pass < passes; pass++) {
+            for (int i = 0; i < BENCH_CORPUS_SIZE; i++) {
+                uint32_t ops = 0, start, cycles;
+
+                prepare(i);
+                start = CYCLE_now();
+                for (int k = 0; k < BENCH_REPEAT; k++) {
+                    ops += benches[b].op();
+                }
+                cycles = CYCLE_now() - start;
+
+                // A full board has no open column: nothing was measured
+                if (ops == 0) {
+                    continue;
+                }
+                r.ops += ops;
+                r.cycles += cycles;
+                if (cycles < r.min_batch) {
+                    r.min_batch = cycles;
+                }
+                if (cycles > r.max_batch) {
+                    r.max_batch = cycles;
+                }
+            }
+        }
+        report(&r);
+    }
+
+    memcpy(game.board, saved_board, sizeof(saved_board));
+    return 0;
+}
+
+void bench_print_csv_header(void) {
+    printf("bench,name,ops,cycles_per_op,ns_per_op,min_batch_cycles,max_batch_cycles\n");
+}
+
+// Per-op figures with two decimals, in integers (no float printf on the board)
+void bench_print_csv(const bench_result_t* r) {
+    uint64_t cycles_x100 = r->ops ? r->cycles * 100 / r->ops : 0;
+    uint64_t ns_x100 = cycles_x100 * 1000000000ULL / CYCLE_hz();
+
+    printf("bench,%s,%lu,%lu.%02lu,%lu.%02lu,%lu,%lu\n", r->name, (unsigned long)r->ops,
+           (unsigned long)(cycles_x100 / 100), (unsigned long)(cycles_x100 % 100),
+           (unsigned long)(ns_x100 / 100), (unsigned long)(ns_x100 % 100),
+           (unsigned long)r->min_batch, (unsigned long)r->max_batch);
+}
@@ -0,0 +1,230 @@
+/*
+ * game_log.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Keeps the game records (game_record.h) of the last games in a ring of flash
+ * pages and sends them over the serial port in the trace stream.
+ *
+ * The ring is the GAMELOG region of the linker script, the last 4 pages of
+ * bank 2 (2 KB pages in the default dual-bank mode). Each page holds
+ * GAME_LOG_SLOTS_PER_PAGE records; the slot after the record with the highest
+ * sequence number is the next one written, and starting a page erases it, so
+ * the oldest page of games goes at once. A page erase stalls the CPU for
+ * ~20 ms and a record takes ~2 ms to program, which is why it is done once,
+ * at the end of the game, while the screen is still.
+ *
+ * Writing is off unless GAME_LOG_FLASH_WRITE is 1 (game_log.h). To check it on
+ * a board: play a few games, send 'g' and compare the trace with tools/replay;
+ * reset and send 'g' again (the records must survive); play past 36 games and
+ * check that `stored` stays at 27..36 and the oldest page goes as a whole.
+ *
+ * Every record is also sent as TRACE_GAME_RECORD when it is written; the 'g'
+ * serial command (console.c) sends the whole ring from the log task, as fast as the
+ * trace buffer has room for them. tools/replay reads either a trace capture
+ * or a dump of the region and replays the games through the engine.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "stm32g4xx_hal.h"
+#include "game_log.h"
+#include "trace_events.h"
+#include "cycle_timer.h"
+#include "console.h"
+
+#define GAME_LOG_PAGE_SIZE          FLASH_PAGE_SIZE
+#define GAME_LOG_SLOTS_PER_PAGE     (GAME_LOG_PAGE_SIZE / sizeof(game_record_t))
+
+extern uint8_t _game_log_start[];    // linker script
+extern uint8_t _game_log_end[];
+
+static struct {
+    int enabled;                   // the flash is in the layout the ring expects
+    uint32_t next_slot;
+    uint32_t next_sequence;
+    uint32_t dump_slot;            // next slot the 'g' command sends
+    uint32_t dump_left;
+    game_log_stats_t stats;
+} glog;
+
+// ------------------- Helpers ---------------------
+
+static uint32_t slot_address(uint32_t slot) {
+    return (uint32_t)_game_log_start + (slot / GAME_LOG_SLOTS_PER_PAGE) * GAME_LOG_PAGE_SIZE +
+           (slot % GAME_LOG_SLOTS_PER_PAGE) * sizeof(game_record_t);
+}
+
+static const game_record_t* slot_record(uint32_t slot) {
+    return (const game_record_t*)slot_address(slot);
+}
+
+static int is_blank(uint32_t address, uint32_t size) {
+    const uint32_t* p = (const uint32_t*)address;
+
+    for (uint32_t i = 0; i < size / 4; i++) {
+        if (p[i] != 0xFFFFFFFFu) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static HAL_StatusTypeDef erase_page(uint32_t address) {
+    uint32_t offset = address - FLASH_BASE;
+    uint32_t page_error;
+    FLASH_EraseInitTypeDef erase = {
+        .TypeErase = FLASH_TYPEERASE_PAGES,
+        .Banks = (offset < FLASH_BANK_SIZE) ? FLASH_BANK_1 : FLASH_BANK_2,
+        .Page = (offset % FLASH_BANK_SIZE) / GAME_LOG_PAGE_SIZE,
+        .NbPages = 1
+    };
+
+    return HAL_FLASHEx_Erase(&erase, &page_error);
+}
+
+static uint32_t page_first_slot(uint32_t slot) {
+    return slot - slot % GAME_LOG_SLOTS_PER_PAGE;
+}
+
+// The ring erases a page when it comes round to it. A slot used in the middle
+// of a page (a write cut short) costs the page as well.
+static int slot_needs_erase(uint32_t slot) {
+    uint32_t first = page_first_slot(slot);
+
+    return (slot == first) ? !is_blank(slot_address(first), GAME_LOG_PAGE_SIZE)
+                           : !is_blank(slot_address(slot), sizeof(game_record_t));
+}
+
+static uint32_t count_valid(uint32_t first, uint32_t count) {
+    uint32_t valid = 0;
+
+    for (uint32_t slot = first; slot < first + count; slot++) {
+        valid += game_record_is_valid(slot_record(slot));
+    }
+    return valid;
+}
+
+// Erase the slot's page if needed, then program the record
+static int write_slot(uint32_t slot, const game_record_t* rec, int erase) {
+    uint32_t address = slot_address(slot);
+    uint32_t page = slot_address(page_first_slot(slot));
+    HAL_StatusTypeDef status = HAL_OK;
+    uint32_t start;
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+
+    if (erase) {
+        start = CYCLE_now();
+        status = erase_page(page);
+        glog.stats.erase_us = CYCLE_to_us(CYCLE_now() - start);
+    }
+
+    start = CYCLE_now();
+    for (uint32_t i = 0; i < sizeof(*rec) && status == HAL_OK; i += 8) {
+        uint64_t word;
+        memcpy(&word, (const uint8_t*)rec + i, sizeof(word));
+        status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, address + i, word);
+    }
+    glog.stats.program_us = CYCLE_to_us(CYCLE_now() - start);
+
+    HAL_FLASH_Lock();
+    return (status == HAL_OK && memcmp(slot_record(slot), rec, sizeof(*rec)) == 0) ? 0 : -1;
+}
+
+// ------------------- Public ---------------------
+
+// Find where the ring continues. The pages only fit the ring in dual-bank mode.
+void game_log_init(void) {
+    uint32_t newest = 0;
+    int found = 0;
+
+    glog.enabled = READ_BIT(FLASH->OPTR, FLASH_OPTR_DBANK) != 0 &&
+                   ((uint32_t)_game_log_end - (uint32_t)_game_log_start) % GAME_LOG_PAGE_SIZE == 0;
+    glog.stats.slots = glog.enabled ?
+        ((uint32_t)_game_log_end - (uint32_t)_game_log_start) / GAME_LOG_PAGE_SIZE * GAME_LOG_SLOTS_PER_PAGE : 0;
+
+    glog.stats.stored = count_valid(0, glog.stats.slots);
+    for (uint32_t slot = 0; slot < glog.stats.slots; slot++) {
+        const game_record_t* rec = slot_record(slot);
+
+        if (!game_record_is_valid(rec)) {
+            continue;
+        }
+        if (!found || (int32_t)(rec->sequence - slot_record(newest)->sequence) > 0) {
+            newest = slot;
+            found = 1;
+        }
+    }
+    glog.next_slot = found ? (newest + 1) % glog.stats.slots : 0;
+    glog.next_sequence = found ? slot_record(newest)->sequence + 1 : 0;
+
+    CONSOLE_register('g', game_log_dump, "send the stored game records in the trace");
+}
+
+uint32_t game_log_next_sequence(void) {
+    return glog.next_sequence;
+}
+
+// Store a finished record and send it in the trace. Returns -1 if it was not stored.
+int game_log_append(const game_record_t* rec) {
+    uint32_t slot = glog.next_slot;
+    int erase;
+    uint32_t lost;
+
+    TRACE_record(TRACE_GAME_RECORD, rec, sizeof(*rec));
+    glog.next_sequence = rec->sequence + 1;
+    if (!GAME_LOG_FLASH_WRITE || !glog.enabled) {
+        return -1;
+    }
+
+    // An erase loses every record on the page, not just the one in this slot
+    erase = slot_needs_erase(slot);
+    lost = erase ? count_valid(page_first_slot(slot), GAME_LOG_SLOTS_PER_PAGE) : 0;
+
+    glog.next_slot = (slot + 1) % glog.stats.slots;
+    if (write_slot(slot, rec, erase) != 0) {
+        glog.stats.write_errors++;
+        glog.stats.stored = count_valid(0, glog.stats.slots);    // whatever the failure left
+        return -1;
+    }
+    glog.stats.stored += 1 - lost;
+    glog.stats.appended++;
+    return 0;
+}
+
+// Send every stored record, oldest first, from game_log_service()
+void game_log_dump(void) {
+    printf("game_log,write=%d,slots=%lu,stored=%lu,appended=%lu,errors=%lu,erase_us=%lu,program_us=%lu\n",
+           GAME_LOG_FLASH_WRITE, (unsigned long)glog.stats.slots, (unsigned long)glog.stats.stored,
+           (unsigned long)glog.stats.appended, (unsigned long)glog.stats.write_errors,
+           (unsigned long)glog.stats.erase_us, (unsigned long)glog.stats.program_us);
+#if TRACE_ENABLED
+    glog.dump_slot = glog.next_slot;
+    glog.dump_left = glog.stats.slots;
+#else
+    printf("game_log: the records are sent in the trace, which is disabled\n");
+#endif
+}
+
+// Called from the log task: sends the next record of a dump when the trace has room
+void game_log_service(void) {
+    while (glog.dump_left > 0) {
+        const game_record_t* rec = slot_record(glog.dump_slot);
+
+        if (game_record_is_valid(rec)) {
+            if (TRACE_free_size() < TRACE_HEADER_SIZE + sizeof(*rec)) {
+                return;
+            }
+            TRACE_record(TRACE_GAME_RECORD, rec, sizeof(*rec));
+        }
+        glog.dump_slot = (glog.dump_slot + 1) % glog.stats.slots;
+        glog.dump_left--;
+    }
+}
+
+const game_log_stats_t* game_log_stats(void) {
+    return &glog.stats;
+}
@@ -0,0 +1,82 @@
+/*
+ * game_record.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Builds and checks game_record_t (game_record.h). No hardware here: the
+ * file is also built on the host for tools/replay.
+ */
+
+#include <string.h>
+
+#include "game_record.h"
+
+void game_record_start(game_record_t* rec, uint32_t sequence, uint32_t start_ms, int ai_first) {
+    memset(rec, 0, sizeof(*rec));
+    rec->magic = GAME_RECORD_MAGIC;
+    rec->version = GAME_RECORD_VERSION;
+    rec->sequence = sequence;
+    rec->start_ms = start_ms;
+    rec->result = GAME_RECORD_UNFINISHED;
+    rec->ai_first = ai_first ? 1 : 0;
+}
+
+// Append a move that took `ms` to choose. Returns its ply, or -1 if the record is full.
+int game_record_add_move(game_record_t* rec, int col, uint32_t ms) {
+    int ply = rec->plies;
+    unsigned bit = 3u * ply;
+
+    if (ply >= GAME_RECORD_MAX_PLIES) {
+        return -1;
+    }
+    rec->moves[bit / 8] |= (uint8_t)((col & 7) << (bit % 8));
+    if (bit % 8 > 5) {
+        rec->moves[bit / 8 + 1] |= (uint8_t)((col & 7) >> (8 - bit % 8));
+    }
+    rec->ply_ms[ply] = (ms > UINT16_MAX) ? UINT16_MAX : ms;
+    if (game_record_ai_index(rec, ply) >= 0) {
+        rec->ai_moves++;
+    }
+    rec->plies++;
+    return ply;
+}
+
+// The search behind the AI move just added
+void game_record_set_search(game_record_t* rec, uint32_t steps, int used_prior) {
+    int ai = (rec->plies > 0) ? game_record_ai_index(rec, rec->plies - 1) : -1;
+
+    if (ai < 0) {
+        return;
+    }
+    rec->search_steps[ai] = steps;
+    if (used_prior) {
+        rec->prior_mask |= 1UL << ai;
+    } else {
+        rec->prior_mask &= ~(1UL << ai);
+    }
+}
+
+void game_record_finish(game_record_t* rec, game_record_result_t result) {
+    rec->result = result;
+    rec->crc = game_record_crc32(rec, offsetof(game_record_t, crc));
+}
+
+int game_record_is_valid(const game_record_t* rec) {
+    return rec->magic == GAME_RECORD_MAGIC && rec->version == GAME_RECORD_VERSION &&
+           rec->plies <= GAME_RECORD_MAX_PLIES && rec->result <= GAME_RECORD_UNFINISHED &&
+           rec->crc == game_record_crc32(rec, offsetof(game_record_t, crc));
+}
+
+// Bitwise CRC-32 (zlib polynomial): one record per game, no table needed
+uint32_t game_record_crc32(const void* data, size_t size) {
+    const uint8_t* p = data;
+    uint32_t crc = 0xFFFFFFFFu;
+
+    while (size--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
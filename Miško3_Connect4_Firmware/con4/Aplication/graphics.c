@@ -26,32 +26,45 @@ static void clear_screen(uint16_t colour) {
 static void render_text(int x, int y, const char* text, const UG_FONT* font, uint16_t colour) {
     UG_FontSelect(font);
     UG_SetForecolor(colour);
-    UG_PutString(x, y, text);
+    LCD_PutString(x, y, text);
 }
 
 // ------------------- Drawing ---------------------
 
 void draw_circle(int x0, int y0, int radius, uint16_t piece_colour) {
+    // One window per scanline instead of one per pixel
     for (int y = -radius; y <= radius; y++) {
-        for (int x = -radius; x <= radius; x++) {
-            if (x * x + y * y < radius * radius) {
-                ILI9341_SetDisplayWindow(x0 + x, y0 + y, 1, 1);
-                ILI9341_SendData(&piece_colour, 1);
-            }
+        int half = circle_half_width(radius, y);
+        if (half >= 0) {
+            LCD_FillRect(x0 - half, y0 + y, 2 * half + 1, 1, piece_colour);
         }
     }
 }
 
+int circle_half_width(int radius, int dy) {
+    // Largest x with x * x + dy * dy < radius * radius, -1 if the scanline misses
+    int half = -1;
+    while ((half + 1) * (half + 1) + dy * dy < radius * radius) {
+        half++;
+    }
+    return half;
+}
+
+int piece_centre_x(int col) {
+    return (col + 1) * PIECE_STEP + SHIFT_X;
+}
+
+int piece_centre_y(int row) {
+    return (ROWS - row) * PIECE_STEP + SHIFT_Y;
+}
+
 // ------------------- Rendering ---------------------
 
 void render_pieces(void) {
-    int step = (WALL_WITH + PIECE_RADIUS * 2);
+    ILI9341_StatsScopeBegin("render_pieces");
 
     for (int row = ROWS - 1; row >= 0; row--) {
         for (int col = 0; col < COLS; col++) {
-            int row_multi = ROWS - row;
-            int col_multi = col + 1;
-
             int piece = game.board[row][col];
             uint16_t colour;
 
@@ -71,47 +84,66 @@ void render_pieces(void) {
             }
 
             // Draw the circle at the right spot
-            draw_circle(col_multi * step + SHIFT_X,
-                        row_multi * step + SHIFT_Y,
+            draw_circle(piece_centre_x(col),
+                        piece_centre_y(row),
                         PIECE_RADIUS,
                         colour);
         }
     }
+
+    ILI9341_StatsScopeEnd();
 }
 
 
 void render_empty_board() {
+    ILI9341_StatsScopeBegin("render_empty_board");
+
     clear_screen(game.board_colour);
+
+    ILI9341_StatsScopeEnd();
 }
 
 void render_ai_won() {
+    ILI9341_StatsScopeBegin("render_ai_won");
+
     clear_screen(C_BLACK);
 
-    ILI9341_SetDisplayWindow(0, 240 - AI_WON_HEIGHT, AI_WON_WIDTH, AI_WON_HEIGHT);
-    ILI9341_SendData((LCD_IO_Data_t*)ai_won, AI_WON_WIDTH * AI_WON_HEIGHT);
+    draw_packed_image(&ai_won, 0, 240 - AI_WON_HEIGHT);
 
     render_text(25, 10, "Judgement day is\nupon you humans!", &FONT_16X26, C_WHITE);
+
+    ILI9341_StatsScopeEnd();
 }
 
 void render_human_won() {
+    ILI9341_StatsScopeBegin("render_human_won");
+
     clear_screen(C_BLACK);
 
-    ILI9341_SetDisplayWindow(0, 55, HUMAN_WON_WIDTH, HUMAN_WON_HEIGHT);
-    ILI9341_SendData((LCD_IO_Data_t*)human_won, HUMAN_WON_WIDTH * HUMAN_WON_HEIGHT);
+    draw_packed_image(&human_won, 0, 55);
 
     render_text(10, 0, "THAT FEELING, WHEN\n YOU BEAT THE AI:", &FONT_16X26, C_WHITE);
     render_text(60, 212, "AM I THE AI?", &FONT_16X26, C_WHITE);
+
+    ILI9341_StatsScopeEnd();
 }
 
 void render_draw() {
+    ILI9341_StatsScopeBegin("render_draw");
+
     clear_screen(C_BLACK);
 
-    ILI9341_SetDisplayWindow(0, 240 - DRAW_HEIGHT, DRAW_WIDTH, DRAW_HEIGHT);
-    ILI9341_SendData((LCD_IO_Data_t*)draw, DRAW_WIDTH * DRAW_HEIGHT);
+    draw_packed_image(&draw, 0, 240 - DRAW_HEIGHT);
 
     render_text(15, 0, "GOOD GAME, HUMAN", &FONT_16X26, C_WHITE);
+
+    ILI9341_StatsScopeEnd();
 }
 
 void render_press_any_button() {
+    ILI9341_StatsScopeBegin("render_press_any_button");
+
     render_text(40, 150, "PRESS ANY BUTTON TO CONTINUE", &FONT_8X12, C_WHITE);
+
+    ILI9341_StatsScopeEnd();
 }
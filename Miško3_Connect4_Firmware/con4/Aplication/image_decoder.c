@@ -0,0 +1,108 @@
+/*
+ * image_decoder.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Streaming decoder for the images packed by tools/img_pack. Lines are
+ * decoded into a small ping-pong buffer while the previous line is moved to
+ * the LCD by DMA, so a full screen image never has to exist in RAM.
+ */
+
+#include <string.h>
+
+#include "lcd.h"
+#include "image_decoder.h"
+
+#define TOKEN_RUN    0x80
+#define TOKEN_COPY   0xC0
+#define TOKEN_LENGTH 0x3F
+#define RUN_MIN      2
+
+static uint16_t line_buffers[2][IMAGE_MAX_WIDTH];
+
+void image_decoder_init(image_decoder_t* decoder, const packed_image_t* image) {
+    decoder->image = image;
+    decoder->next = image->data;
+    decoder->line = 0;
+}
+
+// Decode one line into `line`, `above` is the previously decoded line
+// (ignored for the first line). Returns 0 on success, 1 on corrupt data.
+int image_decode_line(image_decoder_t* decoder, const uint16_t* above, uint16_t* line) {
+    const packed_image_t* image = decoder->image;
+    const uint8_t* end = image->data + image->size;
+    const uint8_t* p = decoder->next;
+    int x = 0;
+
+    if (decoder->line >= image->height) {
+        return 1;
+    }
+
+    while (x < image->width) {
+        if (p >= end) {
+            return 1;
+        }
+        uint8_t token = *p++;
+        int count;
+
+        if (token < TOKEN_RUN) {
+            count = token + 1;
+            if (x + count > image->width || p + count > end) {
+                return 1;
+            }
+            for (int i = 0; i < count; i++) {
+                line[x++] = image->palette[*p++];
+            }
+        } else if (token < TOKEN_COPY) {
+            count = (token & TOKEN_LENGTH) + RUN_MIN;
+            if (x + count > image->width || p >= end) {
+                return 1;
+            }
+            uint16_t colour = image->palette[*p++];
+            for (int i = 0; i < count; i++) {
+                line[x++] = colour;
+            }
+        } else {
+            count = (token & TOKEN_LENGTH) + RUN_MIN;
+            if (x + count > image->width || decoder->line == 0) {
+                return 1;
+            }
+            memcpy(&line[x], &above[x], count * sizeof(uint16_t));
+            x += count;
+        }
+    }
+
+    decoder->next = p;
+    decoder->line++;
+    return 0;
+}
+
+// Decode and send the image line by line, DMA of line n overlaps decoding of line n + 1
+void draw_packed_image(const packed_image_t* image, int x, int y) {
+    image_decoder_t decoder;
+    int current = 0;
+
+    if (image->width > IMAGE_MAX_WIDTH) {
+        return;
+    }
+
+    image_decoder_init(&decoder, image);
+    ILI9341_WaitDMA();
+    if (image_decode_line(&decoder, NULL, line_buffers[current])) {
+        return;
+    }
+
+    ILI9341_SetDisplayWindow(x, y, image->width, image->height);
+    for (int row = 0; row < image->height; row++) {
+        ILI9341_WaitDMA();
+        ILI9341_SendDataDMA((LCD_IO_Data_t*)line_buffers[current], image->width);
+
+        if (row + 1 < image->height) {
+            if (image_decode_line(&decoder, line_buffers[current], line_buffers[current ^ 1])) {
+                break;
+            }
+            current ^= 1;
+        }
+    }
+    ILI9341_WaitDMA();
+}
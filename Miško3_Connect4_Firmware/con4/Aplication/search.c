@@ -0,0 +1,311 @@
+/*
+ * search.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Tactical search for the AI, run next to the network.
+ *
+ * Iterative deepening alpha-beta over three values: the side to move wins,
+ * loses, or nothing is forced within the depth. A proven win is played, proven
+ * losses are avoided, and the network picks among the rest, so the AI keeps
+ * its style but stops missing forced lines.
+ *
+ * The search is resumable: the recursion lives in an explicit stack of frames,
+ * so search_run() can return after any node and carry on from the same place
+ * on the next call. The ai task runs it in SEARCH_SLICE_US slices and the
+ * other tasks get the CPU in between.
+ */
+
+#include <string.h>
+
+#include "search.h"
+#include "cycle_timer.h"
+
+#define SEARCH_CHECK_NODES    32    // nodes between clock checks
+
+typedef struct {
+    bitboard_t pos;
+    int8_t alpha;
+    int8_t beta;
+    int8_t best;
+    uint8_t depth;                 // plies left below this node
+    uint8_t next;                  // index in move_order of the next child
+} search_frame_t;
+
+// Centre columns first: they take part in the most lines, so cutoffs come sooner
+static const uint8_t move_order[COLS] = { 3, 2, 4, 1, 5, 0, 6 };
+
+static ENGINE_THREAD_LOCAL struct {
+    int running;
+    int stop;
+    bitboard_t root;
+    search_frame_t stack[BB_CELLS];
+    int sp;                        // frames in use, 0 between root moves
+    uint8_t depth;                 // current iteration
+    uint8_t max_depth;             // last iteration, 0 = until resolved or out of time
+    uint32_t max_steps;            // search_step() calls, 0 = no limit
+    uint8_t root_index;            // next root move of this iteration
+    uint8_t root_col;              // root move being searched
+    uint8_t result[COLS];          // search_result_t
+    uint8_t result_depth[COLS];    // iteration that proved the result
+    uint32_t start_cycles;
+    uint32_t think_cycles;
+    search_stats_t stats;
+} s;
+
+// ------------------- Tree walk ---------------------
+
+static void search_root_move_done(int8_t value) {
+    if (value > 0) {
+        s.result[s.root_col] = SEARCH_WIN;
+    } else if (value < 0) {
+        s.result[s.root_col] = SEARCH_LOSS;
+    }
+    s.result_depth[s.root_col] = s.depth;
+}
+
+// A node is decided with `value` for its side to move: hand it to the parents
+static void search_return(int8_t value) {
+    while (s.sp > 0) {
+        search_frame_t* parent = &s.stack[s.sp - 1];
+
+        value = -value;
+        if (value > parent->best) {
+            parent->best = value;
+        }
+        if (parent->best > parent->alpha) {
+            parent->alpha = parent->best;
+        }
+        if (parent->alpha < parent->beta) {
+            return;
+        }
+        // Cutoff, the parent is decided as well
+        value = parent->best;
+        s.sp--;
+    }
+    search_root_move_done(-value);
+}
+
+// Open a node. Returns 1 with `value` set if it is decided without children.
+static int search_enter(const bitboard_t* pos, uint8_t depth, int8_t alpha, int8_t beta, int8_t* value) {
+    s.stats.nodes++;
+
+    for (int col = 0; col < COLS; col++) {
+        if (bb_can_play(pos, col) && bb_is_winning_move(pos, col)) {
+            *value = 1;
+            return 1;
+        }
+    }
+    // Without a win the last disc can only draw
+    if (depth == 0 || pos->moves >= BB_CELLS - 1) {
+        *value = 0;
+        return 1;
+    }
+
+    s.stack[s.sp++] = (search_frame_t){ *pos, alpha, beta, -1, depth, 0 };
+    return 0;
+}
+
+// Every root move is resolved, or only one is left that does not lose
+static int search_iteration_is_last(void) {
+    int open = 0;
+
+    if (s.depth >= BB_CELLS - s.root.moves || (s.max_depth && s.depth >= s.max_depth)) {
+        return 1;
+    }
+    for (int col = 0; col < COLS; col++) {
+        if (s.result[col] == SEARCH_WIN) {
+            return 1;
+        }
+        if (s.result[col] == SEARCH_UNKNOWN) {
+            open++;
+        }
+    }
+    return open <= 1;
+}
+
+static void search_next_root_move(void) {
+    while (s.root_index < COLS) {
+        int col = move_order[s.root_index++];
+        bitboard_t child = s.root;
+        int8_t value;
+
+        if (s.result[col] != SEARCH_UNKNOWN) {
+            continue;
+        }
+        s.root_col = col;
+        if (bb_is_winning_move(&s.root, col)) {
+            search_root_move_done(1);
+            return;
+        }
+        bb_play(&child, col);
+        if (search_enter(&child, s.depth - 1, -1, 1, &value)) {
+            search_return(value);
+        }
+        return;
+    }
+
+    s.stats.depth = s.depth;
+    if (search_iteration_is_last()) {
+        s.running = 0;
+    } else {
+        s.depth++;
+        s.root_index = 0;
+    }
+}
+
+// One unit of work: open the next child of the top frame, or close the frame
+static void search_step(void) {
+    search_frame_t* f;
+    int8_t value;
+
+    if (s.sp == 0) {
+        search_next_root_move();
+        return;
+    }
+
+    f = &s.stack[s.sp - 1];
+    while (f->next < COLS && !bb_can_play(&f->pos, move_order[f->next])) {
+        f->next++;
+    }
+    if (f->next == COLS) {
+        value = f->best;
+        s.sp--;
+        search_return(value);
+        return;
+    }
+
+    bitboard_t child = f->pos;
+    bb_play(&child, move_order[f->next++]);
+    if (search_enter(&child, f->depth - 1, -f->beta, -f->alpha, &value)) {
+        search_return(value);
+    }
+}
+
+// ------------------- Public ---------------------
+
+// Start thinking about `root` (AI to move). The search runs in search_run().
+// think_ms 0 means no time limit, for host tools that limit the depth instead.
+void search_start(const bitboard_t* root, uint32_t think_ms) {
+    memset(&s, 0, sizeof(s));
+    s.root = *root;
+    s.depth = 1;
+    s.running = 1;
+    s.start_cycles = CYCLE_now();
+    s.think_cycles = think_ms * (CYCLE_hz() / 1000);
+
+    for (int col = 0; col < COLS; col++) {
+        if (!bb_can_play(root, col)) {
+            s.result[col] = SEARCH_ILLEGAL;
+        }
+    }
+}
+
+// Stop after the iteration at `depth` plies, so the result does not depend on
+// the speed of the machine. Call after search_start().
+void search_set_max_depth(uint8_t depth) {
+    s.max_depth = depth;
+}
+
+// Stop after `steps` calls of search_step(), the count search_stats_t.steps
+// reported for a finished search. The tree walk does not depend on the clock,
+// so this ends in exactly the state that search did, however it was stopped
+// (tools/replay). Call after search_start().
+void search_set_max_steps(uint32_t steps) {
+    s.max_steps = steps;
+}
+
+// Search for about `slice_us`. Returns 1 when the search has finished, either
+// because the position is resolved, the think time is up or search_stop() was called.
+int search_run(uint32_t slice_us) {
+    uint32_t slice_cycles = slice_us * (CYCLE_hz() / 1000000);
+    uint32_t start = CYCLE_now();
+    uint32_t elapsed;
+
+    if (!s.running) {
+        return 1;
+    }
+
+    do {
+        for (int i = 0; i < SEARCH_CHECK_NODES && s.running; i++) {
+            search_step();
+            if (++s.stats.steps == s.max_steps) {
+                s.running = 0;
+            }
+        }
+        elapsed = CYCLE_now() - start;
+    } while (s.running && !s.stop && elapsed < slice_cycles);
+
+    if (s.stop || (s.think_cycles && start + elapsed - s.start_cycles >= s.think_cycles)) {
+        s.running = 0;
+    }
+
+    s.stats.slices++;
+    s.stats.busy_cycles += elapsed;
+    if (elapsed > s.stats.max_slice_cycles) {
+        s.stats.max_slice_cycles = elapsed;
+    }
+    if (!s.running) {
+        s.stats.wall_cycles = CYCLE_now() - s.start_cycles;
+    }
+    return !s.running;
+}
+
+// Finish at the end of the current slice and play the best move found so far
+void search_stop(void) {
+    s.stop = 1;
+}
+
+int search_running(void) {
+    return s.running;
+}
+
+search_result_t search_get_result(int col) {
+    return (search_result_t)s.result[col];
+}
+
+/*
+ * The quickest proven win; otherwise the move with the highest `prior`
+ * (network output, NULL for centre first) that is not a proven loss;
+ * if every move loses, the one that holds out longest.
+ */
+int search_best_move(const float* prior) {
+    int best = -1;
+    float best_prior = 0;
+
+    for (int i = 0; i < COLS; i++) {
+        int col = move_order[i];
+        if (s.result[col] == SEARCH_WIN &&
+            (best == -1 || s.result_depth[col] < s.result_depth[best])) {
+            best = col;
+        }
+    }
+    if (best != -1) {
+        return best;
+    }
+
+    for (int i = 0; i < COLS; i++) {
+        int col = move_order[i];
+        float p = prior ? prior[col] : (float)-i;
+        if (s.result[col] == SEARCH_UNKNOWN && (best == -1 || p > best_prior)) {
+            best = col;
+            best_prior = p;
+        }
+    }
+    if (best != -1) {
+        return best;
+    }
+
+    for (int i = 0; i < COLS; i++) {
+        int col = move_order[i];
+        if (s.result[col] == SEARCH_LOSS &&
+            (best == -1 || s.result_depth[col] > s.result_depth[best])) {
+            best = col;
+        }
+    }
+    return best;
+}
+
+const search_stats_t* search_get_stats(void) {
+    return &s.stats;
+}
@@ -15,6 +15,12 @@
 #include "ugui.h"
 #include "images.h"
 #include "timing_utils.h"
+#include "animation.h"
+#include "trace_events.h"
+#include "tasks.h"
+#include "idle.h"
+#include "game_record.h"
+#include "game_log.h"
 
 typedef enum GAME_states {
     GAME_INTRO_STATE,
@@ -25,7 +31,9 @@ typedef enum GAME_states {
 typedef enum GAMEPLAY_states {
     GAMEPLAY_INIT,
     GAMEPLAY_HUMAN_MOVE,
-    GAMEPLAY_AI_MOVE
+    GAMEPLAY_AI_MOVE,
+    GAMEPLAY_AI_THINKING,
+    GAMEPLAY_DROP_ANIMATION
 } GAMEPLAY_states_t;
 
 typedef enum GAMEOVER_states {
@@ -38,16 +46,51 @@ typedef enum GAMEOVER_states {
 } GAMEOVER_states_t;
 
 typedef enum GAME_RESULT {
-    HUMAN_WON,
-    AI_WON,
-    DRAW
+    HUMAN_WON = GAME_RECORD_HUMAN_WON,
+    AI_WON = GAME_RECORD_AI_WON,
+    DRAW = GAME_RECORD_DRAW
 } game_result_t;
 
+// How long Game() may sleep after the current step, see state_machine.h
+static int32_t game_wait;
+
+// The game so far, stored by game_log.c at the end (see game_record.h)
+static game_record_t record;
+static uint32_t turn_start_ms;     // HAL_GetTick() when the side to move got its turn
+
 // Prototypes
 static int Intro(void);
 static int GamePlay(game_result_t* game_result);
 static int GameOver(game_result_t* game_result);
 
+static void wait_for(int32_t wait) {
+    game_wait = wait;
+}
+
+// Sleep until a stopwatch started with TIMUT_stopwatch_set_time_mark() passes `delay` ms
+static void wait_for_stopwatch(stopwatch_handle_t* stopwatch, uint32_t delay) {
+    uint32_t elapsed = TIMUT_stopwatch_update(stopwatch);
+    wait_for(elapsed <= delay ? delay + 1 - elapsed : 0);
+}
+
+// Helper function: make the move and start the falling-disc animation
+static void drop_piece(int col, int player, uint16_t colour) {
+    int row = 0;
+    while (row < ROWS && game.board[row][col] != game.PLAYER_EMPTY) {
+        row++;
+    }
+    if (make_move(col, player)) {
+        TRACE_EVENT3(TRACE_MOVE, player, col, row);
+        drop_animation_start(col, row, colour);
+        tasks_start_drop_animation();
+    }
+}
+
+// Helper function: add the move to the game record with the time it took to choose
+static void record_move(int col) {
+    game_record_add_move(&record, col, HAL_GetTick() - turn_start_ms);
+}
+
 // Helper function: check game over conditions
 static int check_update_game_result(game_result_t* game_result) {
     if (check_win(game.PLAYER_HUMAN)) {
@@ -63,11 +106,13 @@ static int check_update_game_result(game_result_t* game_result) {
     return 0;
 }
 
-void Game(void) {
+int32_t Game(void) {
     static int state = GAME_INTRO_STATE;
     static game_result_t game_result = HUMAN_WON;
     static int exit_value = 0;
 
+    game_wait = 0;
+
     switch (state) {
         case GAME_INTRO_STATE:
             exit_value = Intro();
@@ -91,56 +136,124 @@ void Game(void) {
             exit_value = 0;
             break;
     }
+    return game_wait;
 }
 
 static int Intro(void) {
     printf("Hello. Let's play a game \n");
     reset_board();
     render_empty_board();
-    printf_render();
+    log_board();
     return 1;
 }
 
 static int GamePlay(game_result_t *game_result) {
     static GAMEPLAY_states_t state = GAMEPLAY_INIT;
+    static GAMEPLAY_states_t state_after_drop = GAMEPLAY_AI_MOVE;
     static int human_move = 0;
+    static int premove_confirmed = 0;    // OK pressed while the AI was thinking
     int ai_move = -1;
+    int confirmed;
     ai_i8 board_state[147]; // reduced from 1000
 
     int exit_value = 0;
 
     switch (state) {
         case GAMEPLAY_INIT:
+            TRACE_EVENT0(TRACE_GAME_START);
             KBD_flush();
             reset_board();
             render_empty_board();
+            turn_start_ms = HAL_GetTick();
+            game_record_start(&record, game_log_next_sequence(), turn_start_ms, 1);
+            premove_confirmed = 0;
             state = GAMEPLAY_AI_MOVE;
             break;
 
         case GAMEPLAY_HUMAN_MOVE:
-            if (got_human_move(&human_move)) {
-                make_move(human_move, game.PLAYER_HUMAN);
-                state = GAMEPLAY_AI_MOVE;
-
-                render_pieces();
-                printf_render();
-
-                exit_value = check_update_game_result(game_result);
+            // A pre-move confirmed during the think is played at once, unless the AI filled that column
+            confirmed = premove_confirmed && check_if_valid(human_move);
+            premove_confirmed = 0;
+            if (confirmed) {
+                delete_pre_move();
+            } else {
+                confirmed = got_human_move(&human_move);
+            }
+            if (confirmed) {
+                record_move(human_move);
+                drop_piece(human_move, game.PLAYER_HUMAN, game.human_colour);
+                state = GAMEPLAY_DROP_ANIMATION;
+                state_after_drop = GAMEPLAY_AI_MOVE;
+            } else {
+                wait_for(GAME_WAIT_KEY);
             }
             break;
 
         case GAMEPLAY_AI_MOVE:
             get_state(board_state);
-            ai_move = get_action(board_state);
-            make_move(ai_move, game.PLAYER_AI);
+            tasks_request_ai_move(board_state);
+            state = GAMEPLAY_AI_THINKING;
+            wait_for(GAME_WAIT_EVENT);
+            break;
 
-            render_pieces();
-            printf_render();
+        case GAMEPLAY_AI_THINKING:
+            if (tasks_ai_move_ready(&ai_move)) {
+                delete_pre_move();    // the AI disc must land on the real stack
+                record_move(ai_move);
+                game_record_set_search(&record, tasks_get_ai_decision()->search_steps,
+                                       tasks_get_ai_decision()->used_prior);
+                drop_piece(ai_move, game.PLAYER_AI, game.ai_colour);
+                state = GAMEPLAY_DROP_ANIMATION;
+                state_after_drop = GAMEPLAY_HUMAN_MOVE;
+                break;
+            }
+            // The search runs in slices, so the pre-move cursor stays live meanwhile
+            switch (KBD_get_pressed_button()) {
+                case BTN_LEFT:
+                    human_move--;
+                    update_pre_move(&human_move);
+                    premove_confirmed = 0;    // moving the cursor withdraws an earlier OK
+                    break;
+                case BTN_RIGHT:
+                    human_move++;
+                    update_pre_move(&human_move);
+                    premove_confirmed = 0;
+                    break;
+                case BTN_OK:
+                    premove_confirmed = 1;    // played in GAMEPLAY_HUMAN_MOVE
+                    break;
+                case BTN_ESC:
+                    tasks_stop_ai_move();    // play the best move found so far
+                    break;
+                default:
+                    break;
+            }
+            wait_for(GAME_WAIT_KEY);
+            break;
 
-            if (!check_update_game_result(game_result)) {
-                state = GAMEPLAY_HUMAN_MOVE;
+        case GAMEPLAY_DROP_ANIMATION:
+            // The render task draws the frames and wakes us up at the end
+            if (drop_animation_running()) {
+                wait_for(GAME_WAIT_EVENT);
             } else {
-                exit_value = 1;
+                log_board();
+                drop_animation_print_stats();
+
+                if (!check_update_game_result(game_result)) {
+                    turn_start_ms = HAL_GetTick();
+                    state = state_after_drop;
+                    if (state == GAMEPLAY_HUMAN_MOVE) {
+                        tasks_start_ponder(human_move);
+                    }
+                } else {
+                    tasks_stop_ponder();
+                    TRACE_EVENT1(TRACE_GAME_RESULT, *game_result);
+                    // Flash write (up to ~20 ms erase) while nothing moves on the screen
+                    game_record_finish(&record, (game_record_result_t)*game_result);
+                    game_log_append(&record);
+                    state = GAMEPLAY_AI_MOVE;
+                    exit_value = 1;
+                }
             }
             break;
     }
@@ -164,6 +277,8 @@ static int GameOver(game_result_t* game_result) {
         case GAMEOVER_WAIT_BEFORE_END_IMAGE_RENDER:
             if (TIMUT_stopwatch_has_X_ms_passed(&stopwatch, DELAY_BEFORE_PIC_RENDER)) {
                 state = GAMEOVER_SHOW_PIC;
+            } else {
+                wait_for_stopwatch(&stopwatch, DELAY_BEFORE_PIC_RENDER);
             }
             break;
 
@@ -180,6 +295,8 @@ static int GameOver(game_result_t* game_result) {
         case GAMEOVER_WAIT_BEFORE_BUTTON_PRESS:
             if (TIMUT_stopwatch_has_X_ms_passed(&stopwatch, DELAY_BEFORE_PRESS_ANY_BUTTON)) {
                 state = GAMEOVER_RENDER_PRESS_ANY_BUTTON;
+            } else {
+                wait_for_stopwatch(&stopwatch, DELAY_BEFORE_PRESS_ANY_BUTTON);
             }
             break;
 
@@ -191,8 +308,18 @@ static int GameOver(game_result_t* game_result) {
         case GAMEOVER_PRESS_BUTTON:
             if (KBD_any_button_been_pressed()) {
                 KBD_flush();
+                // After a long wait the screen is dark; the first key only lights it
+                if (IDLE_screen_wake()) {
+                    wait_for(GAME_WAIT_KEY);
+                    break;
+                }
+                IDLE_allow_stop(0);
                 state = GAMEOVER_SET_TIMER;
                 exit_value = 1;
+            } else {
+                // Nothing to do until a key is pressed: the CPU may go to Stop
+                IDLE_allow_stop(1);
+                wait_for(GAME_WAIT_KEY);
             }
             break;
 
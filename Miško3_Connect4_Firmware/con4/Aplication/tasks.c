@@ -0,0 +1,392 @@
+/*
+ * tasks.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * The game as scheduler tasks, highest priority first:
+ *   render - draws drop animation frames, woken by a one-shot timer per frame
+ *   game   - steps the state machine in state_machine.c
+ *   log    - serial commands and the trace stream, every SERVICE_PERIOD_MS
+ *   ai     - runs the network and the search (search.c) for the AI move
+ * Every task runs one event to completion; with no events pending the CPU sleeps
+ * (idle.c picks Sleep or Stop). The service timer is deferrable, so the log task
+ * does not wake the CPU from Stop.
+ * The search runs in SEARCH_SLICE_US slices: after each one the ai task posts
+ * itself the next slice, so any event for the other tasks is handled first.
+ *
+ * While the human chooses a move the ai task ponders: it searches the answer to
+ * each human reply in turn, the column under the cursor first. If the human
+ * plays a pondered reply the answer is ready at once (ponder hit); if the reply
+ * is the one being searched, that search simply carries on as the real think.
+ */
+
+#include <string.h>
+
+#include "tasks.h"
+#include "state_machine.h"
+#include "animation.h"
+#include "kbd.h"
+#include "joystick.h"
+#include "console.h"
+#include "trace_events.h"
+#include "search.h"
+#include "game.h"
+#include "cycle_timer.h"
+#include "game_log.h"
+#include "bench.h"
+#include "main.h"
+
+static SCHED_task_t render_task;
+static SCHED_task_t game_task;
+static SCHED_task_t log_task;
+static SCHED_task_t ai_task;
+
+static SCHED_timer_t frame_timer;
+static SCHED_timer_t game_timer;
+static SCHED_timer_t service_timer;
+
+typedef enum {
+    AI_IDLE,
+    AI_THINKING,
+    AI_PONDERING
+} ai_mode_t;
+
+static struct {
+    ai_mode_t mode;
+    int slice_pending;         // a SIG_AI_SLICE is in the queue
+    ai_i8 state[147];
+    bitboard_t root;
+    float values[COLS];
+    int have_values;
+    uint32_t slice_end;        // CYCLE_now() when the previous slice returned
+    uint32_t min_slice_gap;    // shortest time between two slices
+    int move;
+    int ready;
+    ai_decision_t decision;    // how the last move was chosen, for the game record
+} ai;
+
+static struct {
+    bitboard_t root;           // human to move
+    uint8_t order[COLS];       // human replies, most likely first
+    int count;
+    int index;                 // order[index] is being searched
+    bitboard_t pos[COLS];      // after each reply, AI to move
+    int8_t move[COLS];         // pondered answer, -1 while unknown
+    uint32_t busy_cycles[COLS];
+    ai_decision_t decision[COLS];
+    ponder_stats_t stats;
+} ponder;
+
+// ------------------- Helpers ---------------------
+
+// Think efficiency: busy is the time spent searching, the rest of the wall time
+// went to the other tasks and to switching slices. The shortest gap between two
+// slices is the cost of one switch (leave the handler, re-post, dispatch again).
+static void trace_search_stats(void) {
+    const search_stats_t* st = search_get_stats();
+    uint32_t cycles_per_us = CYCLE_hz() / 1000000;
+
+    TRACE_EVENT4(TRACE_SEARCH, ai.move, st->depth, st->nodes, st->slices);
+    TRACE_EVENT4(TRACE_SEARCH_TIME, st->wall_cycles / cycles_per_us, st->busy_cycles / cycles_per_us,
+                 st->max_slice_cycles / cycles_per_us, st->slices > 1 ? ai.min_slice_gap : 0);
+}
+
+// Network output for the position after the human plays `reply`, AI to move.
+// game.board is borrowed for get_state(); no other task runs in between.
+static void ponder_network_values(int reply) {
+    int board[ROWS][COLS];
+    ai_i8 state[147];
+
+    memcpy(board, game.board, sizeof(board));
+    delete_pre_move();
+    make_move(reply, game.PLAYER_HUMAN);
+    get_state(state);
+    memcpy(game.board, board, sizeof(board));
+
+    ai.have_values = (get_action_values(state, ai.values) == 0);
+}
+
+static void ai_post_slice(void) {
+    if (!ai.slice_pending) {
+        ai.slice_pending = 1;
+        SCHED_post(ai_task, SIG_AI_SLICE, 0);
+    }
+}
+
+static void ai_start_search(const bitboard_t* root) {
+    search_start(root, SEARCH_THINK_MS);
+    ai.min_slice_gap = UINT32_MAX;
+    ai.slice_end = 0;
+    ai_post_slice();
+}
+
+// Start on the next reply to ponder; back to idle when all are done
+static void ponder_next(void) {
+    while (ponder.index < ponder.count) {
+        int reply = ponder.order[ponder.index];
+        if (ponder.move[reply] == -1) {
+            ponder_network_values(reply);
+            ai_start_search(&ponder.pos[reply]);
+            return;
+        }
+        ponder.index++;
+    }
+    ai.mode = AI_IDLE;
+}
+
+// Index of the pondered position equal to `pos`, or -1
+static int ponder_find(const bitboard_t* pos) {
+    for (int i = 0; i < ponder.count; i++) {
+        int reply = ponder.order[i];
+        if (ponder.pos[reply].mask == pos->mask && ponder.pos[reply].current == pos->current) {
+            return reply;
+        }
+    }
+    return -1;
+}
+
+static void ponder_trace(uint32_t result, uint32_t saved_cycles) {
+    ponder.stats.saved_cycles += saved_cycles;
+    TRACE_EVENT4(TRACE_PONDER, result, CYCLE_to_us(saved_cycles),
+                 ponder.stats.hits + ponder.stats.partial_hits, ponder.stats.requests);
+}
+
+static void ai_move_done(int move, const ai_decision_t* decision) {
+    ai.move = move;
+    ai.decision = *decision;
+    ai.mode = AI_IDLE;
+    ai.ready = 1;
+    SCHED_post(game_task, SIG_STEP, 0);
+}
+
+static void ai_request(void) {
+    int pondered = (ponder.count > 0);
+    int reply = ponder_find(&ai.root);
+
+    // The pondered positions are used up by this request
+    ponder.count = 0;
+    if (pondered) {
+        ponder.stats.requests++;
+    }
+
+    if (reply != -1 && ponder.move[reply] != -1) {
+        ponder.stats.hits++;
+        ponder_trace(1, ponder.busy_cycles[reply]);
+        if (ai.mode == AI_PONDERING) {
+            search_stop();
+        }
+        ai_move_done(ponder.move[reply], &ponder.decision[reply]);
+        return;
+    }
+
+    if (reply != -1 && ai.mode == AI_PONDERING && ponder.order[ponder.index] == reply) {
+        // The search for this reply is under way and keeps its deadline
+        ponder.stats.partial_hits++;
+        ponder_trace(2, search_get_stats()->busy_cycles);
+        ai.mode = AI_THINKING;
+        return;
+    }
+
+    if (pondered) {
+        ponder.stats.misses++;
+        ponder_trace(0, 0);
+    }
+    ai.have_values = (get_action_values(ai.state, ai.values) == 0);
+    ai.mode = AI_THINKING;
+    ai_start_search(&ai.root);
+}
+
+// ------------------- Tasks ---------------------
+
+static void render_task_handler(SCHED_event_t event) {
+    (void)event;
+
+    if (drop_animation_update()) {
+        SCHED_timer_start(frame_timer, drop_animation_ms_to_next_frame(), 0);
+    } else {
+        SCHED_post(game_task, SIG_STEP, 0);
+    }
+}
+
+static void game_task_handler(SCHED_event_t event) {
+    (void)event;
+    int32_t wait = Game();
+
+    // Keys pressed while the game was busy are still in the keyboard buffer
+    if (wait == 0 || (wait == GAME_WAIT_KEY && KBD_any_button_been_pressed())) {
+        SCHED_post(game_task, SIG_STEP, 0);
+    } else if (wait > 0) {
+        SCHED_timer_start(game_timer, wait, 0);
+    }
+}
+
+static void ai_task_handler(SCHED_event_t event) {
+    uint32_t gap;
+    int move;
+    ai_decision_t decision;
+
+    switch (event.signal) {
+        case SIG_AI_REQUEST:
+            ai_request();
+            break;
+
+        case SIG_PONDER_START:
+            ai.mode = AI_PONDERING;
+            ponder_next();
+            break;
+
+        case SIG_AI_SLICE:
+            ai.slice_pending = 0;
+            if (ai.mode == AI_IDLE) {
+                break;
+            }
+            gap = CYCLE_now() - ai.slice_end;
+            if (ai.slice_end != 0 && gap < ai.min_slice_gap) {
+                ai.min_slice_gap = gap;
+            }
+            if (!search_run(SEARCH_SLICE_US)) {
+                ai_post_slice();
+                ai.slice_end = CYCLE_now();
+                break;
+            }
+
+            move = search_best_move(ai.have_values ? ai.values : NULL);
+            decision.search_steps = search_get_stats()->steps;
+            decision.used_prior = ai.have_values;
+            if (ai.mode == AI_THINKING) {
+                ai_move_done(move, &decision);
+                trace_search_stats();
+            } else {
+                int reply = ponder.order[ponder.index];
+                ponder.move[reply] = move;
+                ponder.busy_cycles[reply] = search_get_stats()->busy_cycles;
+                ponder.decision[reply] = decision;
+                ponder_next();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Serial command 'b': the game stands still while the benchmarks run
+static void bench_command(void) {
+    bench_print_csv_header();
+    bench_run(1, bench_print_csv);
+}
+
+static void log_task_handler(SCHED_event_t event) {
+    (void)event;
+
+    CONSOLE_service();
+    JOY_record_service();
+    game_log_service();
+    TRACE_service();
+}
+
+// ------------------- Public ---------------------
+
+void tasks_init(void) {
+    game_log_init();
+
+    // cycle_timer.c and bench.c are also built for the host, so their commands are registered here
+    CONSOLE_register('c', CYCLE_print_all, "cycle timers");
+    CONSOLE_register('b', bench_command, "engine micro-benchmarks CSV");
+
+    render_task = SCHED_add_task("render", render_task_handler);
+    game_task = SCHED_add_task("game", game_task_handler);
+    log_task = SCHED_add_task("log", log_task_handler);
+    ai_task = SCHED_add_task("ai", ai_task_handler);
+    // SCHED_MAX_TASKS too small: the game cannot run without all four
+    if (render_task == SCHED_NO_TASK || game_task == SCHED_NO_TASK ||
+        log_task == SCHED_NO_TASK || ai_task == SCHED_NO_TASK) {
+        Error_Handler();
+    }
+
+    frame_timer = SCHED_timer_create(render_task, SIG_FRAME);
+    game_timer = SCHED_timer_create(game_task, SIG_STEP);
+    service_timer = SCHED_timer_create(log_task, SIG_SERVICE);
+
+    SCHED_subscribe(game_task, SCHED_SIG_KEY);
+    SCHED_timer_set_deferrable(service_timer, 1);
+    SCHED_timer_start(service_timer, SERVICE_PERIOD_MS, SERVICE_PERIOD_MS);
+    SCHED_post(game_task, SIG_STEP, 0);
+}
+
+// Hand the position to the ai task; the game is woken when the move is ready
+void tasks_request_ai_move(const ai_i8* state) {
+    memcpy(ai.state, state, sizeof(ai.state));
+    bb_from_board(&ai.root, (const int (*)[COLS])game.board, game.PLAYER_AI, game.PLAYER_HUMAN);
+    ai.ready = 0;
+    SCHED_post(ai_task, SIG_AI_REQUEST, 0);
+}
+
+// Cut the think short; the move found so far is played at the end of the current slice
+void tasks_stop_ai_move(void) {
+    if (ai.mode == AI_THINKING) {
+        search_stop();
+    }
+}
+
+// Ponder the answers to every human reply from the current position, human to
+// move, starting with `likely_col`. Any previous pondering is dropped.
+void tasks_start_ponder(int likely_col) {
+    bitboard_t root;
+    static const uint8_t centre_first[COLS] = { 3, 2, 4, 1, 5, 0, 6 };
+
+    bb_from_board(&root, (const int (*)[COLS])game.board, game.PLAYER_HUMAN, game.PLAYER_AI);
+    ponder.root = root;
+    ponder.count = 0;
+    ponder.index = 0;
+
+    for (int i = -1; i < COLS; i++) {
+        int col = (i == -1) ? likely_col : centre_first[i];
+        if (col < 0 || col >= COLS || (i != -1 && col == likely_col)) {
+            continue;
+        }
+        // Replies that end the game need no answer
+        if (!bb_can_play(&root, col) || bb_is_winning_move(&root, col) || root.moves + 1 >= BB_CELLS) {
+            continue;
+        }
+        ponder.pos[col] = root;
+        bb_play(&ponder.pos[col], col);
+        ponder.move[col] = -1;
+        ponder.order[ponder.count++] = col;
+    }
+
+    if (ai.mode == AI_PONDERING) {
+        search_stop();
+    }
+    SCHED_post(ai_task, SIG_PONDER_START, 0);
+}
+
+// The game is over: stop pondering and forget the pondered positions
+void tasks_stop_ponder(void) {
+    if (ai.mode == AI_PONDERING) {
+        search_stop();
+        ai.mode = AI_IDLE;
+    }
+    ponder.count = 0;
+}
+
+const ponder_stats_t* tasks_get_ponder_stats(void) {
+    return &ponder.stats;
+}
+
+int tasks_ai_move_ready(int* move) {
+    if (!ai.ready) {
+        return 0;
+    }
+    *move = ai.move;
+    return 1;
+}
+
+// How the move from tasks_ai_move_ready() was chosen
+const ai_decision_t* tasks_get_ai_decision(void) {
+    return &ai.decision;
+}
+
+void tasks_start_drop_animation(void) {
+    SCHED_post(render_task, SIG_ANIMATION_START, 0);
+}
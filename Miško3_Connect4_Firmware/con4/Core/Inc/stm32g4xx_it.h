@@ -55,10 +55,18 @@ void SVC_Handler(void);
 void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
+void EXTI0_IRQHandler(void);
+void EXTI1_IRQHandler(void);
 void DMA1_Channel1_IRQHandler(void);
+void DMA1_Channel2_IRQHandler(void);
+void DMA1_Channel3_IRQHandler(void);
+void EXTI9_5_IRQHandler(void);
 void USART3_IRQHandler(void);
+void EXTI15_10_IRQHandler(void);
 void TIM6_DAC_IRQHandler(void);
+void TIM7_DAC_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void LPTIM1_IRQHandler(void);
 
 /* USER CODE END EFP */
 
@@ -14,7 +14,7 @@
 
 // Vključimo nizko-nivojsko LL knjižnjico, da dobimo podporo za delo z USART vmesnikom.
 #include "stm32g4xx_ll_usart.h"
-#include "buf.h"
+#include "ring.h"
 
 // Pri implementaciji sistemskih funkcij serijskega vmesnika SCI bomo potrebovali sledeče nizko-nivojske funkcije
 // za upravljanje USART periferne enote:
@@ -48,9 +48,28 @@
 // Uporabimo naštevni tip.
 typedef enum { SCI_ERROR = -1, SCI_NO_ERROR = 0} SCI_rtrn_codes_t;
 
+// Statistika pošiljanja z DMA.
+typedef struct
+{
+	uint32_t bytes_sent;		// bajti, ki jih je DMA že poslal
+	uint32_t bytes_dropped;		// bajti, zavrženi zaradi polnega medpomnilnika
+	uint32_t peak_occupancy;	// največje število čakajočih bajtov (v prenosu in v medpomnilniku)
+	uint32_t transfers;			// število DMA prenosov
+
+} SCI_TX_stats_t;
+
 void SCI_send_string_IT(char *str);
 void SCI_send_bytes_IT(uint8_t *data, uint32_t size);
 
+uint32_t SCI_send_bytes_DMA(uint8_t *data, uint32_t size);
+uint32_t SCI_DMA_get_free_size(void);
+void SCI_DMA_flush(void);
+uint8_t SCI_DMA_is_idle(void);
+void SCI_DMA_transmit_complete_Callback(void);
+void SCI_TX_stats_get(SCI_TX_stats_t *stats);
+void SCI_TX_stats_reset(void);
+void SCI_TX_stats_print(void);
+
 
 
 
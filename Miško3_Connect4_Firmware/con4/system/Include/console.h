@@ -0,0 +1,44 @@
+/*
+ * console.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INCLUDE_CONSOLE_H_
+#define INCLUDE_CONSOLE_H_
+
+
+// ----------- Include other modules (for public) -------------
+
+#include "stdint.h"
+
+
+
+
+// -------------- User-defined parameters START ----------------
+
+#define CONSOLE_MAX_COMMANDS	16		// največje število registriranih ukazov
+
+// -------------- User-defined parameters END ----------------
+
+
+
+
+// -------------------- Public definitions --------------------
+
+// Ukaz se izvede v opravilu "log" (tasks.c), ne v prekinitvi.
+typedef void (*CONSOLE_handler_t)(void);
+
+
+
+
+// ---------------- Public function prototypes ----------------
+
+uint8_t CONSOLE_register(char key, CONSOLE_handler_t handler, const char *help);
+void CONSOLE_service(void);
+void CONSOLE_help_print(void);
+
+
+
+
+#endif /* INCLUDE_CONSOLE_H_ */
@@ -0,0 +1,90 @@
+/*
+ * cycle_timer.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INCLUDE_CYCLE_TIMER_H_
+#define INCLUDE_CYCLE_TIMER_H_
+
+
+// ----------- Include other modules (for public) -------------
+
+#include "stdint.h"
+
+
+
+
+// -------------------- Public definitions --------------------
+
+// Merilnik ("štoparica" s ciklično ločljivostjo) s sprotno statistiko.
+// En merilnik meri eno vrsto dogodka (npr. eno inferenco mreže).
+typedef struct cycle_timer_s
+{
+	const char *name;
+	uint32_t start;					// števec ciklov ob CYCLE_timer_start()
+	uint32_t running;				// 1 med start in stop
+
+	uint32_t count;					// število meritev
+	uint32_t last;					// zadnja meritev v ciklih
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+
+	struct cycle_timer_s *next;		// seznam vseh merilnikov za CYCLE_print_all()
+
+} cycle_timer_t;
+
+
+// Pomožna struktura za CYCLE_SCOPE().
+typedef struct
+{
+	cycle_timer_t *timer;
+
+} cycle_scope_t;
+
+
+// Izmeri čas do konca trenutnega bloka { } (tudi ob return ali break), npr.:
+//
+//	{
+//		CYCLE_SCOPE(inference_timer);
+//		ai_run();
+//	}
+//
+#define CYCLE_SCOPE(timer) \
+	cycle_scope_t CYCLE_CONCAT(cycle_scope_, __LINE__) \
+	__attribute__((cleanup(CYCLE_scope_end))) = CYCLE_scope_begin(&(timer))
+
+#define CYCLE_CONCAT_(a, b)		a##b
+#define CYCLE_CONCAT(a, b)		CYCLE_CONCAT_(a, b)
+
+
+
+
+// ---------------- Public function prototypes ----------------
+
+void CYCLE_init(void);
+
+uint32_t CYCLE_now(void);
+uint64_t CYCLE_now64(void);
+uint32_t CYCLE_hz(void);
+uint32_t CYCLE_to_us(uint32_t cycles);
+uint32_t CYCLE_to_ns(uint32_t cycles);
+
+void CYCLE_timer_init(cycle_timer_t *timer, const char *name);
+void CYCLE_timer_reset(cycle_timer_t *timer);
+void CYCLE_timer_start(cycle_timer_t *timer);
+uint32_t CYCLE_timer_stop(cycle_timer_t *timer);
+void CYCLE_timer_add(cycle_timer_t *timer, uint32_t cycles);
+uint32_t CYCLE_timer_mean(const cycle_timer_t *timer);
+
+cycle_scope_t CYCLE_scope_begin(cycle_timer_t *timer);
+void CYCLE_scope_end(cycle_scope_t *scope);
+
+void CYCLE_print_all(void);
+void CYCLE_reset_all(void);
+
+
+
+
+#endif /* INCLUDE_CYCLE_TIMER_H_ */
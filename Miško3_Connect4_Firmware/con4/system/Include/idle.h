@@ -0,0 +1,86 @@
+/*
+ * idle.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INCLUDE_IDLE_H_
+#define INCLUDE_IDLE_H_
+
+
+// ----------- Include other modules (for public) -------------
+
+#include "stdint.h"
+
+
+
+
+// -------------- User-defined parameters START ----------------
+
+#define IDLE_USE_STOP			1		// 0 = vedno le Sleep (WFI), 1 = dovoli tudi Stop 1
+
+#define IDLE_STOP_DELAY_MS		30000	// Stop šele toliko ms po IDLE_allow_stop(1); zaslon se takrat ugasne
+#define IDLE_STOP_MIN_MS		20		// Stop le, če je do naslednjega časovnika vsaj toliko ms
+
+#define IDLE_IRQ_PRIORITY		13		// prioriteta LPTIM1 prekinitve (kot tipkovnica)
+
+// -------------- User-defined parameters END ----------------
+
+
+
+
+// -------------------- Public definitions --------------------
+
+// Načini, v katerih procesor preživlja čas.
+typedef enum
+{
+	IDLE_MODE_RUN,			// izvajanje opravil in prekinitev
+	IDLE_MODE_SLEEP,		// WFI, ure perifernih enot tečejo
+	IDLE_MODE_STOP,			// Stop 1: ure stojijo, zbudi ga EXTI (tipka) ali LPTIM1
+	IDLE_NUM_OF_MODES
+
+} idle_mode_t;
+
+// Vzrok bujenja iz Stop načina.
+typedef enum
+{
+	IDLE_WAKE_INPUT,		// tipka (EXTI) ali druga prekinitev
+	IDLE_WAKE_TIMER			// LPTIM1: potekel je programski časovnik razvrščevalnika
+
+} idle_wake_t;
+
+// Statistika enega načina.
+typedef struct
+{
+	uint32_t entries;			// število vstopov
+	uint64_t dwell_us;			// skupni čas v načinu
+	uint32_t max_dwell_us;		// najdaljše posamezno bivanje
+
+	uint32_t wake_us_min;		// čas od bujenja do ponovno nastavljene ure (le Stop)
+	uint32_t wake_us_max;
+	uint64_t wake_us_total;
+	uint32_t timer_wakes;		// bujenja zaradi LPTIM1 (ostala so zaradi tipk)
+
+} IDLE_stats_t;
+
+
+
+
+// ---------------- Public function prototypes ----------------
+
+void IDLE_init(void);
+void IDLE_enter(uint32_t next_timer_ms);
+
+void IDLE_allow_stop(uint8_t allow);
+uint8_t IDLE_screen_wake(void);
+
+void IDLE_wakeup_timer_Callback(void);
+
+const IDLE_stats_t* IDLE_get_stats(idle_mode_t mode);
+void IDLE_stats_reset(void);
+void IDLE_stats_print(void);
+
+
+
+
+#endif /* INCLUDE_IDLE_H_ */
@@ -0,0 +1,73 @@
+/*
+ * joy_filter.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INCLUDE_JOY_FILTER_H_
+#define INCLUDE_JOY_FILTER_H_
+
+
+// ----------- Include other modules (for public) -------------
+
+#include "stdint.h"
+
+
+
+
+// -------------- User-defined parameters START ----------------
+
+#define JOY_FILTER_FRAC_BITS		4		// decimalni biti stanja IIR filtra (Q4)
+#define JOY_FILTER_IIR_SHIFT		3		// y += (x - y) / 2^SHIFT, časovna konstanta ~8 vzorcev
+
+#define JOY_DEAD_ZONE_PCT			15		// odklon do 15 % okoli sredine šteje kot 0
+
+#define JOY_STEP_RATE_MIN			2		// stolpcev na sekundo tik za mrtvim območjem
+#define JOY_STEP_RATE_MAX			10		// stolpcev na sekundo pri polnem odklonu
+#define JOY_STEP_RELEASE_MS			40		// smer se sprosti po toliko ms v mrtvem območju
+
+// -------------- User-defined parameters END ----------------
+
+
+
+
+// -------------------- Public definitions --------------------
+
+// Filter ene osi: mediana zadnjih treh vzorcev odstrani posamezne konice,
+// IIR filter prvega reda v fiksni vejici pa zgladi šum.
+typedef struct
+{
+	uint16_t	history[2];		// zadnja dva "surova" vzorca za mediano
+	int32_t		y;				// stanje IIR filtra v Q(JOY_FILTER_FRAC_BITS)
+
+} joy_filter_t;
+
+
+// Pretvornik odklona v korake (stolpce): prvi korak takoj ob izhodu iz
+// mrtvega območja, nato s hitrostjo, sorazmerno z odklonom. Smer se
+// sprosti šele po JOY_STEP_RELEASE_MS v mrtvem območju (histereza).
+typedef struct
+{
+	int8_t		direction;		// -1, 0, +1
+	int32_t		accumulator;
+	uint32_t	release_ms;		// čas v mrtvem območju pri še nesproščeni smeri
+
+} joy_stepper_t;
+
+
+
+
+// ---------------- Public function prototypes ----------------
+
+void JOY_FILTER_init(joy_filter_t *filter, uint16_t initial);
+uint16_t JOY_FILTER_update(joy_filter_t *filter, uint16_t sample);
+
+int8_t JOY_FILTER_deflection(uint16_t value, uint16_t center, uint16_t half_range);
+
+void JOY_STEP_init(joy_stepper_t *stepper);
+int8_t JOY_STEP_update(joy_stepper_t *stepper, int8_t deflection, uint32_t dt_ms);
+
+
+
+
+#endif /* INCLUDE_JOY_FILTER_H_ */
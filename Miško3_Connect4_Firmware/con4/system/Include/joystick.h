@@ -21,6 +21,20 @@
 
 
 
+// -------------- User-defined parameters START ----------------
+
+#define JOY_SAMPLE_RATE_HZ		1000	// frekvenca proženja AD pretvorb (TIM1, MX_TIM1_Init())
+#define JOY_DMA_BLOCK			16		// vzorcev na os v polovici DMA medpomnilnika (16 ms)
+#define JOY_DEFAULT_HALF_RANGE	2048	// polovica razpona osi, dokler "joystick" ni kalibriran
+
+#define JOY_COLUMN_SELECT		1		// 1: odklon X osi premika izbrani stolpec (tipki LEFT/RIGHT)
+#define JOY_X_INVERT			0		// 1: večja meritev X osi pomeni odklon v levo
+
+// -------------- User-defined parameters END ----------------
+
+
+
+
 
 
 
@@ -100,6 +114,12 @@ void JOY_flush(void);
 
 void JOY_calibrate(void);
 uint8_t JOY_get_axis_position(joystick_axes_enum_t axis);
+int8_t JOY_get_deflection(joystick_axes_enum_t axis);
+
+void JOY_record_enable(uint8_t enable);
+void JOY_record_toggle(void);
+uint8_t JOY_is_recording(void);
+void JOY_record_service(void);
 
 
 void JOY_button_demo(void);
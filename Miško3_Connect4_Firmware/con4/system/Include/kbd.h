@@ -14,6 +14,24 @@
 
 // Vključimo nizko-nivojsko LL knjižnjico, da dobimo podporo za delo s tipkami na strojnem nivoju preko GPIO-jev.
 #include"stm32g4xx_ll_gpio.h"		// support for GPIOs
+#include"stm32g4xx_ll_exti.h"		// prekinitve ob spremembi stanja tipk
+#include"stm32g4xx_ll_tim.h"		// časovnik za odpravljanje odskakovanja
+
+
+
+
+// -------------- User-defined parameters START ----------------
+
+// 1: tipke sprožijo EXTI prekinitev, odskakovanje odpravlja časovnik TIM7.
+// 0: tipke se periodično berejo s KBD_scan() iz periodic_services.c.
+#define KBD_USE_EXTI				1
+
+#define KBD_DEBOUNCE_MS				10		// po spremembi stanja tipke toliko časa ignoriramo odskoke
+#define KBD_REPEAT_DELAY_MS			400		// držana tipka LEFT/RIGHT se začne ponavljati po tem času
+#define KBD_REPEAT_PERIOD_MS		120		// in se nato ponavlja s to periodo
+
+// -------------- User-defined parameters END ----------------
+
 
 
 // Pri implementaciji sistemskih funkcij za delo s tipkovnico bomo potrebovali sledeče nizko-nivojske funkcije:
@@ -63,6 +81,27 @@ typedef enum {BTN_PRESSED_SIGNAL_STATE = 0, BTN_RELEASED_SIGNAL_STATE = 1} butto
 
 
 
+// Dogodek tipkovnice. V medpomnilnik tipkovnice se shranjujejo pritiski in ponovitve
+// (sprostitve le osvežijo čase v "handle" strukturi tipke).
+typedef enum {KBD_EVENT_PRESS, KBD_EVENT_RELEASE, KBD_EVENT_REPEAT} kbd_event_type_t;
+
+typedef struct
+{
+	uint32_t timestamp;			// števec ciklov (cycle_timer.c) ob spremembi stanja tipke
+	uint8_t button;				// buttons_enum_t
+	uint8_t type;				// kbd_event_type_t
+	uint16_t reserved;
+
+} kbd_event_t;
+
+// Dogodek, zapakiran v 16-bitni parameter signala SCHED_SIG_KEY.
+#define KBD_EVENT_PARAM(type, button)		( ((type) << 8) | (button) )
+#define KBD_EVENT_PARAM_BUTTON(param)		( (param) & 0xFF )
+#define KBD_EVENT_PARAM_TYPE(param)			( (param) >> 8 )
+
+
+
+
 // ---------------- Public function prototypes ----------------
 
 
@@ -75,8 +114,15 @@ buttons_enum_t KBD_get_pressed_button(void);
 uint8_t KBD_is_button_state_pressed(buttons_enum_t button);
 
 uint8_t KBD_any_button_been_pressed(void);
+uint8_t KBD_get_event(kbd_event_t *event);
+uint32_t KBD_get_hold_time_ms(buttons_enum_t button);
+void KBD_inject_press(buttons_enum_t button);
 
 void KBD_flush(void);
+uint8_t KBD_is_idle(void);
+
+void KBD_EXTI_Callback(uint32_t exti_line);
+void KBD_debounce_timer_Callback(void);
 
 
 
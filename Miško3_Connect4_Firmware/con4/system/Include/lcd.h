@@ -39,6 +39,12 @@
 #define LCD_RESET_GPIO_PIN   LL_GPIO_PIN_3		// DOPOLNI: zamenjaj "x" z ustrezno vrednostjo.
 
 
+// Predpomnilnik izrisanih znakov za LCD_PutString(). Velikost 0 ga izklopi.
+// En vnos zasede 2*LCD_GLYPH_MAX_PIXELS bajtov RAM; 16x26 = 416 točk.
+#define LCD_GLYPH_CACHE_SIZE   8
+#define LCD_GLYPH_MAX_PIXELS   (16*26)
+
+
 
 // -------------- User-defined parameters END ----------------
 
@@ -59,6 +65,7 @@ void LCD_demo_simple();
 
 
 void LCD_uGUI_init(void);
+void LCD_PutString(int16_t x, int16_t y, const char *str);
 void LCD_uGUI_demo_Misko3(void);
 
 void LCD_TCH_demo(void);
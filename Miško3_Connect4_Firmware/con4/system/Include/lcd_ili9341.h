@@ -33,6 +33,14 @@
 #define ILI9341_WIDTH  		240		// širina zaslona v številu pikslov
 #define ILI9341_HEIGHT 		320		// višina zaslona v številu pikslov
 
+// Merjenje stroškov izrisa: števci oken, poslanih pikslov (PIO in DMA) in DWT ciklov
+// po poimenovanih področjih (angl. scope). Vrednost 0 meritve izklopi.
+#ifndef ILI9341_RENDER_STATS
+#define ILI9341_RENDER_STATS		1
+#endif
+#define ILI9341_STATS_MAX_SCOPES	12		// največje število različnih področij
+#define ILI9341_STATS_MAX_DEPTH		4		// največja globina gnezdenja področij
+
 
 // -------------- User-defined parameters END ----------------
 
@@ -115,15 +123,48 @@ typedef enum LCD_Param
 /**
  * @brief LCD DMA Configuration
  */
-extern  DMA_HandleTypeDef hdma_memtomem_dma1_channel1;
-#define hLCDDMA           hdma_memtomem_dma1_channel1
+extern  DMA_HandleTypeDef hdma_memtomem_dma1_channel2;
+#define hLCDDMA           hdma_memtomem_dma1_channel2
+
+
 
+/**
+ * @brief Števci stroškov izrisa za eno poimenovano področje
+ */
+typedef struct
+{
+	const char *name;
+	uint32_t calls;			// število izvedb področja
+	uint32_t windows;		// klici ILI9341_SetDisplayWindow()
+	uint32_t pio_pixels;	// piksli, ki jih je poslal procesor
+	uint32_t dma_pixels;	// piksli, poslani prek DMA
+	uint64_t cycles;		// skupno število DWT ciklov
+	uint32_t max_cycles;	// najdaljša posamezna izvedba
+} ILI9341_Scope_t;
+
+#if ILI9341_RENDER_STATS
+void ILI9341_StatsReset(void);
+void ILI9341_StatsScopeBegin(const char *name);
+void ILI9341_StatsScopeEnd(void);
+uint32_t ILI9341_StatsGetScopeCount(void);
+const ILI9341_Scope_t* ILI9341_StatsGetScope(uint32_t index);
+void ILI9341_StatsPrintCSV(void);
+#else
+#define ILI9341_StatsReset()
+#define ILI9341_StatsScopeBegin(name)
+#define ILI9341_StatsScopeEnd()
+#define ILI9341_StatsGetScopeCount()	0
+#define ILI9341_StatsGetScope(index)	((const ILI9341_Scope_t*)0)
+#define ILI9341_StatsPrintCSV()
+#endif
 
 
 void    ILI9341_SetAddress (LCD_IO_Data_t *address);
 void    ILI9341_SendData(LCD_IO_Data_t *data, uint32_t length);
 void    ILI9341_SendRepeatedData(LCD_IO_Data_t data, uint32_t num_copies);
 int32_t ILI9341_SendDataDMA(LCD_IO_Data_t *data, uint32_t length);
+uint8_t ILI9341_IsDMABusy();
+void    ILI9341_WaitDMA();
 void    ILI9341_RecvData(LCD_IO_Data_t *address, uint32_t length);
 
 void ILI9341_SetOrientation(uint32_t Orientation);
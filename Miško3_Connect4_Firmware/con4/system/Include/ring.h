@@ -0,0 +1,60 @@
+/*
+ * ring.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INCLUDE_RING_H_
+#define INCLUDE_RING_H_
+
+
+// ----------- Include other modules (for public) -------------
+
+#include "stdint.h"
+#include "buf.h"		// the ring buffer reports the same return codes as buf.c
+
+
+
+
+// -------------------- Public definitions --------------------
+
+
+// Single-producer single-consumer ring buffer handle. The buffer length is a power of two,
+// so the head and tail indices run freely and are only masked when the array is accessed.
+// "head" is written by the producer only, "tail" by the consumer only.
+typedef struct
+{
+	uint8_t *buffer;			// A pointer to the beginning of the buffer array.
+	uint32_t mask;				// Buffer length - 1, the length being a power of two.
+	volatile uint32_t head;		// Total number of bytes ever written (producer index).
+	volatile uint32_t tail;		// Total number of bytes ever read (consumer index).
+
+} ring_handle_t;
+
+
+
+
+// ---------------- Public function prototypes ----------------
+
+void RING_init(ring_handle_t *ring, uint8_t *buffer_ptr, uint32_t buf_length);
+buf_rtrn_codes_t RING_flush(ring_handle_t *ring);
+
+// Producer side
+buf_rtrn_codes_t RING_put(ring_handle_t *ring, uint8_t data);
+buf_rtrn_codes_t RING_write(ring_handle_t *ring, const uint8_t *data, uint32_t size);
+uint32_t RING_peek_write(ring_handle_t *ring, uint8_t **data);
+void RING_commit_write(ring_handle_t *ring, uint32_t size);
+
+// Consumer side
+buf_rtrn_codes_t RING_get(ring_handle_t *ring, uint8_t *data);
+buf_rtrn_codes_t RING_read(ring_handle_t *ring, uint8_t *data, uint32_t size);
+uint32_t RING_peek_read(ring_handle_t *ring, const uint8_t **data);
+void RING_commit_read(ring_handle_t *ring, uint32_t size);
+
+uint32_t RING_get_data_size(ring_handle_t *ring);
+uint32_t RING_get_free_size(ring_handle_t *ring);
+
+
+
+
+#endif /* INCLUDE_RING_H_ */
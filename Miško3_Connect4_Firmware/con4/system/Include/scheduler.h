@@ -0,0 +1,96 @@
+/*
+ * scheduler.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INCLUDE_SCHEDULER_H_
+#define INCLUDE_SCHEDULER_H_
+
+
+// ----------- Include other modules (for public) -------------
+
+#include "stdint.h"
+
+
+
+
+// -------------- User-defined parameters START ----------------
+
+#define SCHED_MAX_TASKS			6		// največje število opravil
+#define SCHED_QUEUE_LEN			8		// dolžina vrste dogodkov posameznega opravila, potenca števila 2
+#define SCHED_MAX_TIMERS		6		// največje število programskih časovnikov
+#define SCHED_MAX_SUBSCRIBERS	4		// največje število naročnikov na objavljene signale
+
+// -------------- User-defined parameters END ----------------
+
+
+
+
+// -------------------- Public definitions --------------------
+
+// Dogodek: signal (kaj se je zgodilo) in poljuben parameter.
+typedef struct
+{
+	uint16_t signal;
+	uint16_t param;
+
+} SCHED_event_t;
+
+// Rezervirani signali. Signali aplikacije se začnejo pri SCHED_SIG_USER.
+typedef enum
+{
+	SCHED_SIG_KEY = 0,			// pritisnjena tipka (objavi jo kbd.c, param = KBD_EVENT_PARAM())
+	SCHED_SIG_USER = 16
+
+} SCHED_reserved_signals_t;
+
+// Opravilo obdela en dogodek in se vrne (angl. run-to-completion).
+typedef void (*SCHED_handler_t)(SCHED_event_t event);
+
+typedef uint8_t SCHED_task_t;
+typedef int8_t SCHED_timer_t;
+
+#define SCHED_NO_TASK		((SCHED_task_t) 0xFF)		// SCHED_add_task(): ni prostora
+#define SCHED_NO_TIMER		((SCHED_timer_t) -1)
+
+// Statistika opravila.
+typedef struct
+{
+	const char *name;
+	uint32_t runs;				// število obdelanih dogodkov
+	uint64_t cycles;			// skupni čas izvajanja v ciklih
+	uint32_t max_cycles;		// najdaljše posamezno izvajanje
+	uint32_t max_queue;			// največja zasedenost vrste dogodkov
+	uint32_t events_lost;		// dogodki, zavrženi zaradi polne vrste
+
+} SCHED_task_stats_t;
+
+
+
+
+// ---------------- Public function prototypes ----------------
+
+void SCHED_init(void);
+SCHED_task_t SCHED_add_task(const char *name, SCHED_handler_t handler);
+void SCHED_run(void);
+
+uint8_t SCHED_post(SCHED_task_t task, uint16_t signal, uint16_t param);
+void SCHED_subscribe(SCHED_task_t task, uint16_t signal);
+void SCHED_publish(uint16_t signal, uint16_t param);
+
+SCHED_timer_t SCHED_timer_create(SCHED_task_t task, uint16_t signal);
+void SCHED_timer_start(SCHED_timer_t timer, uint32_t delay_ms, uint32_t period_ms);
+void SCHED_timer_stop(SCHED_timer_t timer);
+void SCHED_timer_set_deferrable(SCHED_timer_t timer, uint8_t deferrable);
+
+void SCHED_tick_Callback(void);
+
+const SCHED_task_stats_t* SCHED_get_task_stats(SCHED_task_t task);
+void SCHED_stats_reset(void);
+void SCHED_stats_print(void);
+
+
+
+
+#endif /* INCLUDE_SCHEDULER_H_ */
@@ -0,0 +1,117 @@
+/*
+ * trace.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef INCLUDE_TRACE_H_
+#define INCLUDE_TRACE_H_
+
+
+// ----------- Include other modules (for public) -------------
+
+#include "stdint.h"
+
+
+
+
+// -------------- User-defined parameters START ----------------
+
+// Binarno beleženje dogodkov. Ko je izklopljeno (0), se vsi TRACE_ klici prevedejo
+// v prazne makroje, printf() pa pošilja navadno besedilo.
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED		1
+#endif
+
+#define TRACE_BUF_LEN		2048	// dolžina RAM medpomnilnika zapisov, potenca števila 2
+
+// -------------- User-defined parameters END ----------------
+
+
+
+
+// -------------------- Public definitions --------------------
+
+// Oblika zapisa (vsa večbajtna polja so little-endian):
+//
+//	bajt 0		TRACE_SYNC
+//	bajt 1		ID dogodka
+//	bajt 2		dolžina podatkov N (0 - 255)
+//	bajti 3-6	časovni žig: DWT števec ciklov (170 MHz)
+//	bajti 7-	N bajtov podatkov
+//
+// ASCII besedilo ne vsebuje bajta TRACE_SYNC, zato dekodirnik na gostitelju
+// (tools/trace_decode) sproti izpiše tudi besedilo, ki je bilo poslano mimo
+// zapisov (npr. s SCI_send_string()).
+#define TRACE_SYNC			0xA5
+#define TRACE_HEADER_SIZE	7
+#define TRACE_MAX_PAYLOAD	255
+
+// Rezervirani ID-ji dogodkov. ID-ji aplikacije se začnejo pri TRACE_ID_USER.
+typedef enum
+{
+	TRACE_ID_TEXT = 0,			// besedilo printf() sporočila
+	TRACE_ID_OVERFLOW = 1,		// uint32_t: število zapisov, izgubljenih zaradi polnega medpomnilnika
+	TRACE_ID_USER = 16
+
+} TRACE_reserved_ids_t;
+
+// Statistika beleženja.
+typedef struct
+{
+	uint32_t records;			// zapisani zapisi
+	uint32_t bytes;				// zapisani bajti (z glavami)
+	uint32_t dropped;			// izgubljeni zapisi
+	uint32_t peak_occupancy;	// največja zasedenost medpomnilnika v bajtih
+
+} TRACE_stats_t;
+
+
+
+
+// ---------------- Public function prototypes ----------------
+
+#if TRACE_ENABLED
+
+void TRACE_init(void);
+void TRACE_record(uint8_t id, const void *payload, uint32_t size);
+void TRACE_text(const char *text, uint32_t length);
+void TRACE_service(void);
+uint32_t TRACE_free_size(void);
+void TRACE_stats_get(TRACE_stats_t *stats);
+void TRACE_stats_print(void);
+
+// Dogodki z 0 - 4 celoštevilskimi argumenti (vsak zasede 4 bajte).
+#define TRACE_EVENT0(id)				TRACE_record((id), 0, 0)
+#define TRACE_EVENT1(id, a)				do { uint32_t _trace_args[] = { (uint32_t)(a) }; \
+											TRACE_record((id), _trace_args, sizeof(_trace_args)); } while (0)
+#define TRACE_EVENT2(id, a, b)			do { uint32_t _trace_args[] = { (uint32_t)(a), (uint32_t)(b) }; \
+											TRACE_record((id), _trace_args, sizeof(_trace_args)); } while (0)
+#define TRACE_EVENT3(id, a, b, c)		do { uint32_t _trace_args[] = { (uint32_t)(a), (uint32_t)(b), (uint32_t)(c) }; \
+											TRACE_record((id), _trace_args, sizeof(_trace_args)); } while (0)
+#define TRACE_EVENT4(id, a, b, c, d)	do { uint32_t _trace_args[] = { (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d) }; \
+											TRACE_record((id), _trace_args, sizeof(_trace_args)); } while (0)
+
+#else
+
+#define TRACE_init()
+#define TRACE_record(id, payload, size)
+#define TRACE_text(text, length)
+#define TRACE_service()
+#define TRACE_free_size()				0
+#define TRACE_stats_get(stats)
+#define TRACE_stats_print()
+
+// Argumenti se ne izračunajo, prevajalnik pa jih vseeno šteje za uporabljene.
+#define TRACE_EVENT0(id)
+#define TRACE_EVENT1(id, a)				((void) sizeof(a))
+#define TRACE_EVENT2(id, a, b)			((void) sizeof(a), (void) sizeof(b))
+#define TRACE_EVENT3(id, a, b, c)		((void) sizeof(a), (void) sizeof(b), (void) sizeof(c))
+#define TRACE_EVENT4(id, a, b, c, d)	((void) sizeof(a), (void) sizeof(b), (void) sizeof(c), (void) sizeof(d))
+
+#endif
+
+
+
+
+#endif /* INCLUDE_TRACE_H_ */
@@ -41,13 +41,18 @@ za ustrezno nizko-nivojsko inicializacijo USART vmesnika.
 
 #include "SCI.h"
 
-#include "SCI.h"
+#include "stm32g4xx_ll_dma.h"
+#include "trace.h"
+#include "console.h"
+
+#include <string.h>
+
 #define SCI_RX_BUF_LEN	512
 
 // In definirajmo še dve podatkovni strukturi, ki sta potrebni za implementacijo
 // medpomnilnika.
 uint8_t SCI_RX_buffer[SCI_RX_BUF_LEN];			// tabela beatify, ki bo hranila podatke
-buf_handle_t SCI_RX_buf_handle;					// "handle" struktura za RX medpomnilnik
+ring_handle_t SCI_RX_buf_handle;					// "handle" struktura za RX medpomnilnik
 
 
 
@@ -63,7 +68,32 @@ buf_handle_t SCI_RX_buf_handle;					// "handle" struktura za RX medpomnilnik
 // In definirajmo še dve podatkovni strukturi, ki sta potrebni za implementacijo
 // medpomnilnika.
 uint8_t SCI_TX_buffer[SCI_TX_BUF_LEN];			// tabela bajtov, ki bo hranila podatke
-buf_handle_t SCI_TX_buf_handle;					// "handle" struktura za TX medpomnilnik
+ring_handle_t SCI_TX_buf_handle;					// "handle" struktura za TX medpomnilnik
+
+
+
+
+// --- SCI DMA transmit (TX) definitions ---
+
+// Pošiljanje printf() sporočil z DMA. Uporabimo dva vmesna medpomnilnika (angl. double buffering):
+// medtem ko DMA pošilja vsebino enega, _write() dodaja nove podatke v drugega. Ko se prenos zaključi,
+// se medpomnilnika zamenjata. Tako printf() ne čaka na USART: če v medpomnilniku ni dovolj
+// prostora, se sporočilo zavrže in prešteje. Le sporočilo, daljše od medpomnilnika, _write()
+// pošlje po kosih in na prostor za vsak kos počaka, saj ga sicer ne bi mogli poslati nikoli.
+#define SCI_DMA_TX_BUF_LEN		256					// dolžina posameznega vmesnega medpomnilnika
+#define SCI_DMA_TX_CHANNEL		LL_DMA_CHANNEL_3	// DMA1 kanal z zahtevo USART3_TX
+
+typedef struct
+{
+	uint8_t buffer[2][SCI_DMA_TX_BUF_LEN];	// vmesna medpomnilnika
+	volatile uint32_t fill_length;			// število bajtov v medpomnilniku, ki se polni
+	volatile uint8_t fill;					// indeks medpomnilnika, ki se polni
+	volatile uint32_t dma_length;			// število bajtov trenutnega DMA prenosa (0 = DMA miruje)
+	SCI_TX_stats_t stats;					// statistika pošiljanja
+
+} SCI_DMA_TX_handle_t;
+
+SCI_DMA_TX_handle_t SCI_DMA_TX;
 
 
 
@@ -180,8 +210,8 @@ void SCI_init(void)
 		// ****** Dodati je potrebno še dva koraka v inizializaciji:
 
 				// 3. Inicializacija SCI medpomnilnikov  (RX and TX)
-					BUF_init( &SCI_RX_buf_handle, SCI_RX_buffer, SCI_RX_BUF_LEN);	// RX SCI medpomnilnik
-					BUF_init( &SCI_TX_buf_handle,SCI_TX_buffer,SCI_TX_BUF_LEN );	// TX SCI medpomnilnik
+					RING_init( &SCI_RX_buf_handle, SCI_RX_buffer, SCI_RX_BUF_LEN);	// RX SCI medpomnilnik
+					RING_init( &SCI_TX_buf_handle,SCI_TX_buffer,SCI_TX_BUF_LEN );	// TX SCI medpomnilnik
 
 
 
@@ -194,12 +224,24 @@ void SCI_init(void)
 
 					LL_USART_EnableIT_RXNE_RXFNE (SCI.enota);
 
+					// DMA kanal za pošiljanje: naslov periferije je vedno TDR register USART-a,
+					// naslov in dolžino podatkov pa nastavimo ob vsakem prenosu.
+					LL_DMA_SetPeriphAddress(DMA1, SCI_DMA_TX_CHANNEL,
+							LL_USART_DMA_GetRegAddr(SCI.enota, LL_USART_DMA_REG_DATA_TRANSMIT));
+					LL_DMA_EnableIT_TC(DMA1, SCI_DMA_TX_CHANNEL);
+					LL_USART_EnableDMAReq_TX(SCI.enota);
+
 
 					// V vednost: prekinitve ob sprejemu novega podatka lahko vklopimo šele,
 					// ko že imamo pripravljen sprejemni RX medpomnilnik, kamor se bodo ob
 					// prekinitvah shranjevali novoprejeti podatki.
 
 
+				// 5. Statistiko pošiljanja izpišemo na zahtevo (console.c)
+
+					CONSOLE_register('u', SCI_TX_stats_print, "serial TX stats");
+
+
 
 
 
@@ -310,21 +352,13 @@ void SCI_send_string(char *str)
 void SCI_send_string_IT(char *str)
 {
 	// pomožna spremenljivka
-	uint32_t i = 0;		// indeks
+	uint32_t i = strlen(str);		// dolžina niza
 
 
 	// Najprej je potrebno celoten znakovni niz "*str" shraniti v oddajni medpomnilnik.
-	// Ker ni znana dolžina znakovnega niza, se z "while" zanko sprehodimo preko vseh znakov niza
-	// do t.i. "null character-ja"
-	while( str[i] != 0)
-	{
-		// in jih enega po enega shranjujemo v oddajni mepodmnilnik.
-		BUF_store_byte( &SCI_TX_buf_handle, (uint8_t) str[i] );
-
-		// Indeks se premakne na naslednji znak v nizu.
-
-		i++;
-	}
+	// Dolžino niza do t.i. "null character-ja" poznamo, zato ga shranimo
+	// naenkrat, z enim ali dvema kopiranjema (memcpy) znotraj RING_write().
+	RING_write( &SCI_TX_buf_handle, (uint8_t *) str, i );
 
 
 	// Če je potrebno poslati vsaj en znak,
@@ -351,8 +385,8 @@ void SCI_send_bytes_IT(uint8_t *data, uint32_t size)
 {
 
 	// Najprej je potrebno celotno zaporedje bajtov z naslova "data" shraniti v oddajni medpomnilnik.
-	// Ker je poznana dolžina "data" podatkov, lahko uporabimo BUF_store_bytes().
-	BUF_store_bytes( &SCI_TX_buf_handle, data, size );
+	// Ker je poznana dolžina "data" podatkov, lahko uporabimo RING_write().
+	RING_write( &SCI_TX_buf_handle, data, size );
 
 
 	// Če je potrebno poslati vsaj en bajt,
@@ -390,7 +424,7 @@ void SCI_send_bytes_IT(uint8_t *data, uint32_t size)
 // ki jih trenutno hrani sprejemni RX SCI medpomnilnilk.
 uint32_t SCI_RX_buffer_get_data_size(void)
 {
-	return BUF_get_data_size( &SCI_RX_buf_handle );
+	return RING_get_data_size( &SCI_RX_buf_handle );
 }
 
 
@@ -406,7 +440,7 @@ uint32_t SCI_is_RX_buffer_not_empty(void)
 // in jih vpiše na naslov, ki ga specificira kazalec "data".
 buf_rtrn_codes_t SCI_RX_buffer_get_byte(uint8_t *data)
 {
-	return BUF_get_byte( &SCI_RX_buf_handle, data );
+	return RING_get( &SCI_RX_buf_handle, data );
 }
 
 
@@ -416,14 +450,14 @@ buf_rtrn_codes_t SCI_RX_buffer_get_byte(uint8_t *data)
 // specificira parameter "size".
 buf_rtrn_codes_t SCI_RX_buffer_get_bytes(uint8_t *data,  uint32_t size)
 {
-	return BUF_get_bytes( &SCI_RX_buf_handle, data, size );
+	return RING_read( &SCI_RX_buf_handle, data, size );
 }
 
 // Funkcija SCI_RX_buffer_flush() zbriše obstoječe podatke, ki se nahajajo
 // v sprejemnem RX SCI medpomnilniku.
 buf_rtrn_codes_t SCI_RX_buffer_flush(void)
 {
-	return BUF_flush( &SCI_RX_buf_handle );
+	return RING_flush( &SCI_RX_buf_handle );
 }
 
 
@@ -435,7 +469,7 @@ buf_rtrn_codes_t SCI_RX_buffer_flush(void)
 // v oddajnem TX SCI medpomnilniku.
 buf_rtrn_codes_t SCI_TX_buffer_flush(void)
 {
-	return BUF_flush( &SCI_TX_buf_handle );
+	return RING_flush( &SCI_TX_buf_handle );
 }
 
 
@@ -462,7 +496,7 @@ void SCI_receive_byte_Callback(void)
 	received_data = LL_USART_ReceiveData8 (SCI.enota);
 
 	// Nato pa ta podatek shranimo v sprejemni RX medpomnilnik SCI vmesnika za nadaljno obdelavo kasneje.
-	BUF_store_byte( &SCI_RX_buf_handle, received_data );
+	RING_put( &SCI_RX_buf_handle, received_data );
 }
 
 
@@ -480,8 +514,8 @@ void SCI_transmit_byte_Callback(void)
 
 
 	// Najprej poskusimo prebrati naslednji podatek, ki ga želimo poslati.
-	// Zapomnimo si "vrnjeno kodo" (angl. return code), ki jo vrne BUF_ funkcija.
-	return_code = BUF_get_byte( &SCI_TX_buf_handle, &data_to_transmit );
+	// Zapomnimo si "vrnjeno kodo" (angl. return code), ki jo vrne RING_ funkcija.
+	return_code = RING_get( &SCI_TX_buf_handle, &data_to_transmit );
 
 	// S pomočjo "vrnjene kode" ugotovimo, če sedaj imamo na voljo naslednji podatek za pošiljanje.
 	if ( return_code == BUFFER_OK )
@@ -496,7 +530,7 @@ void SCI_transmit_byte_Callback(void)
 	// Po vsakem podatku, ki ga pošljemo, je potrebno preveriti, če smo morda
 	// poslali zadnji podatek. To je pomembno, saj moramo v tem primeru ustaviti
 	// "avtomatsko" pošiljanje podatkov s pomočjo prekinitev.
-	if ( BUF_get_data_size( &SCI_TX_buf_handle ) == 0)
+	if ( RING_get_data_size( &SCI_TX_buf_handle ) == 0)
 	{
 		// In če smo res poslali zadnji podatek, potem moramo onemogočiti nadaljne
 		// prekinitve ob sprostitvi oddajnega podatkovnega registra (TXE),
@@ -673,6 +707,165 @@ void SCI_send_bytes(uint8_t *data, uint32_t size)
 
 
 
+// ------ Pošiljanje z DMA (printf) -------
+
+
+// Privatna funkcija SCI_DMA_start() zamenja vmesna medpomnilnika in sproži DMA prenos
+// medpomnilnika, ki se je do sedaj polnil. Kliče se le, ko DMA miruje, in to bodisi
+// z onemogočenimi prekinitvami bodisi iz DMA prekinitvene rutine.
+static void SCI_DMA_start(void)
+{
+	uint8_t *data = SCI_DMA_TX.buffer[SCI_DMA_TX.fill];
+
+	if ( SCI_DMA_TX.fill_length == 0 )
+		return;
+
+	SCI_DMA_TX.dma_length = SCI_DMA_TX.fill_length;
+	SCI_DMA_TX.fill ^= 1;
+	SCI_DMA_TX.fill_length = 0;
+	SCI_DMA_TX.stats.transfers++;
+
+	LL_DMA_DisableChannel(DMA1, SCI_DMA_TX_CHANNEL);
+	LL_DMA_SetMemoryAddress(DMA1, SCI_DMA_TX_CHANNEL, (uint32_t) data);
+	LL_DMA_SetDataLength(DMA1, SCI_DMA_TX_CHANNEL, SCI_DMA_TX.dma_length);
+	LL_DMA_EnableChannel(DMA1, SCI_DMA_TX_CHANNEL);
+}
+
+
+// Funkcija SCI_send_bytes_DMA() shrani podatke v vmesni medpomnilnik in sproži DMA prenos,
+// če DMA ravno miruje. Funkcija nikoli ne čaka: če v medpomnilniku ni prostora za vse
+// podatke, se zavržejo vsi (sporočila tako ne pridejo na terminal le delno), kar se
+// zabeleži v statistiki. Vrne število sprejetih bajtov (0 ali "size").
+uint32_t SCI_send_bytes_DMA(uint8_t *data, uint32_t size)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t occupancy;
+
+	// Kratek kritični odsek: DMA prekinitev lahko vmes zamenja medpomnilnika.
+	__disable_irq();
+
+	if ( size > SCI_DMA_TX_BUF_LEN - SCI_DMA_TX.fill_length )
+	{
+		SCI_DMA_TX.stats.bytes_dropped += size;
+		__set_PRIMASK(primask);
+		return 0;
+	}
+
+	memcpy( &SCI_DMA_TX.buffer[SCI_DMA_TX.fill][SCI_DMA_TX.fill_length], data, size );
+	SCI_DMA_TX.fill_length += size;
+
+	occupancy = SCI_DMA_TX.dma_length + SCI_DMA_TX.fill_length;
+	if ( occupancy > SCI_DMA_TX.stats.peak_occupancy )
+		SCI_DMA_TX.stats.peak_occupancy = occupancy;
+
+	if ( SCI_DMA_TX.dma_length == 0 )
+		SCI_DMA_start();
+
+	__set_PRIMASK(primask);
+
+	return size;
+}
+
+
+// Funkcija SCI_DMA_get_free_size() vrne, koliko bajtov trenutno sprejme SCI_send_bytes_DMA().
+uint32_t SCI_DMA_get_free_size(void)
+{
+	return SCI_DMA_TX_BUF_LEN - SCI_DMA_TX.fill_length;
+}
+
+
+// Privatna funkcija SCI_DMA_wait_free() počaka, da vmesni medpomnilnik sprejme "size" bajtov
+// (največ SCI_DMA_TX_BUF_LEN). Konec DMA prenosa preverja tudi sama, z onemogočenimi
+// prekinitvami, da je ne prehiti DMA prekinitvena rutina; tako čakanje deluje tudi,
+// ko so prekinitve onemogočene.
+static void SCI_DMA_wait_free(uint32_t size)
+{
+	uint32_t primask;
+
+	while ( SCI_DMA_get_free_size() < size )
+	{
+		primask = __get_PRIMASK();
+		__disable_irq();
+
+		if ( LL_DMA_IsActiveFlag_TC3(DMA1) )
+		{
+			LL_DMA_ClearFlag_TC3(DMA1);
+			SCI_DMA_transmit_complete_Callback();
+		}
+
+		__set_PRIMASK(primask);
+	}
+}
+
+
+// Funkcija SCI_DMA_flush() počaka, da se pošljejo vsi podatki iz vmesnih medpomnilnikov
+// (npr. pred ponovnim zagonom sistema).
+void SCI_DMA_flush(void)
+{
+	while ( !SCI_DMA_is_idle() );
+}
+
+
+// Funkcija SCI_DMA_is_idle() vrne 1, ko so vsi podatki poslani in DMA miruje.
+// DMA prenos se konča, ko je zadnji bajt vpisan v TDR register, ne ko je poslan;
+// zato počakamo še na zastavico TC (oddajni pomikalni register je prazen).
+// Brez tega bi Stop način (idle.c) ustavil uro sredi zadnjih bajtov.
+uint8_t SCI_DMA_is_idle(void)
+{
+	return ( SCI_DMA_TX.dma_length == 0 ) && ( SCI_DMA_TX.fill_length == 0 )
+			&& LL_USART_IsActiveFlag_TC(SCI.enota);
+}
+
+
+// Prekinitvena rutina ob koncu DMA prenosa: zabeleži poslane bajte in takoj
+// začne pošiljati medpomnilnik, ki se je medtem napolnil.
+void SCI_DMA_transmit_complete_Callback(void)
+{
+	SCI_DMA_TX.stats.bytes_sent += SCI_DMA_TX.dma_length;
+	SCI_DMA_TX.dma_length = 0;
+
+	SCI_DMA_start();
+}
+
+
+// Statistika pošiljanja z DMA.
+void SCI_TX_stats_get(SCI_TX_stats_t *stats)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	*stats = SCI_DMA_TX.stats;
+	__set_PRIMASK(primask);
+}
+
+
+void SCI_TX_stats_reset(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	SCI_DMA_TX.stats.bytes_sent = 0;
+	SCI_DMA_TX.stats.bytes_dropped = 0;
+	SCI_DMA_TX.stats.peak_occupancy = SCI_DMA_TX.dma_length + SCI_DMA_TX.fill_length;
+	SCI_DMA_TX.stats.transfers = 0;
+	__set_PRIMASK(primask);
+}
+
+
+void SCI_TX_stats_print(void)
+{
+	SCI_TX_stats_t stats;
+
+	SCI_TX_stats_get(&stats);
+
+	printf("uart_tx,sent=%lu,dropped=%lu,peak=%lu/%u,transfers=%lu\n",
+			(unsigned long) stats.bytes_sent, (unsigned long) stats.bytes_dropped,
+			(unsigned long) stats.peak_occupancy, 2 * SCI_DMA_TX_BUF_LEN,
+			(unsigned long) stats.transfers);
+}
+
+
+
 
 
 
@@ -798,18 +991,40 @@ int _write(int file, char *ptr, int len)
 	// kje se nahajajo podatki, ki jih printf() funkcija želi poslati,
 	// ter kako dolgi so ti podatki (v smislu števila bajtov).
 
-	// Sedaj pa uporabimo našo SCI sistemsko funkcijo SCI_send_bytes()
-	// da z njo pošljemo te podatke, na katere kaže "ptr".
-	// Ker naša funkcija SCI_send_bytes() uporablja drugačen tip
+#if TRACE_ENABLED
+	// Pri binarnem beleženju gre besedilo v isti tok kot ostali zapisi,
+	// na povezavo pa ga pošlje TRACE_service().
+	TRACE_text( ptr, (uint32_t) len );
+#else
+	// Podatke predamo DMA pošiljanju, ki ne čaka na USART. Polling funkcija
+	// SCI_send_bytes() je igro ustavila za ves čas pošiljanja sporočila.
+	// Ker naša funkcija SCI_send_bytes_DMA() uporablja drugačen tip
 	// vhodnih argumentov, je potrebno poskrbeti za eksplicitno
 	// pretvorbo med tipi podatkov (angl. type-casting).
-	SCI_send_bytes( (uint8_t*) ptr, (uint32_t) len );
+	if ( (uint32_t) len <= SCI_DMA_TX_BUF_LEN )
+		SCI_send_bytes_DMA( (uint8_t*) ptr, (uint32_t) len );
+	else
+	{
+		// Daljšega sporočila SCI_send_bytes_DMA() ne sprejme nikoli, zato ga
+		// pošljemo po kosih velikosti medpomnilnika in na prostor zanje počakamo.
+		for ( uint32_t sent = 0; sent < (uint32_t) len; sent += SCI_DMA_TX_BUF_LEN )
+		{
+			uint32_t chunk = (uint32_t) len - sent;
+
+			if ( chunk > SCI_DMA_TX_BUF_LEN )
+				chunk = SCI_DMA_TX_BUF_LEN;
+
+			SCI_DMA_wait_free(chunk);
+			SCI_send_bytes_DMA( (uint8_t*) &ptr[sent], chunk );
+		}
+	}
+#endif
 
 
 
 	// Funkcija _write() mora vrniti število uspešno poslanih
-	// znakov. Tu poenostavimo in privzamemo, da je bilo uspešno
-	// poslanih vseh "len" znakov.
+	// znakov. Zavrženi znaki se štejejo v statistiki SCI_TX_stats_get(),
+	// printf() pa naj jih ne poskuša pošiljati ponovno.
 	return len;
 }
 
@@ -0,0 +1,122 @@
+/*
+ * console.c
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+
+/* **************** MODULE DESCRIPTION *************************
+
+Ta modul sprejema enoznakovne ukaze prek SCI vmesnika in jih razpošlje
+modulom, ki so jih registrirali.
+
+Modul ob inicializaciji s CONSOLE_register() poveže znak s funkcijo brez
+argumentov in s kratkim opisom, npr. idle.c znak 'w' z IDLE_stats_print().
+CONSOLE_service() kliče opravilo "log" (tasks.c): prebere vse prejete
+znake in za vsakega pokliče registrirano funkcijo. Neznani znaki se
+zavržejo, znak '?' izpiše seznam vseh ukazov.
+
+Trenutni ukazi (registrirajo jih moduli sami):
+	's', 'r'	lcd.c			števci področij izrisa
+	'u'			SCI.c			statistika pošiljanja printf() sporočil z DMA
+	't'			trace.c			statistika binarnega beleženja
+	'p'			scheduler.c		statistika opravil razvrščevalnika
+	'j'			joystick.c		snemanje vzorcev "joysticka"
+	'w'			idle.c			čas v načinih Run/Sleep/Stop
+	'g'			game_log.c		zapisi shranjenih iger
+	'c', 'b'	tasks.c			merilniki časa in mikro meritve (modula
+								cycle_timer.c in bench.c se prevajata
+								tudi za PC, zato ju registrira aplikacija)
+
+************************************************************* */
+
+
+
+
+// ----------- Include other modules (for private) -------------
+
+#include <stdio.h>
+
+#include "console.h"
+#include "SCI.h"
+
+
+// ---------------------- Private definitions ------------------
+
+typedef struct
+{
+	char key;
+	CONSOLE_handler_t handler;
+	const char *help;
+
+} CONSOLE_command_t;
+
+static CONSOLE_command_t commands[CONSOLE_MAX_COMMANDS];
+static uint32_t command_count;
+
+
+
+
+// -------------- Private function implementations -------------
+
+
+static const CONSOLE_command_t* CONSOLE_find(char key)
+{
+	for ( uint32_t i = 0; i < command_count; i++ )
+	{
+		if ( commands[i].key == key )
+			return &commands[i];
+	}
+	return NULL;
+}
+
+
+
+
+// -------------- Public function implementations --------------
+
+
+// Poveži znak "key" s funkcijo "handler". Vrne 0, če je znak že zaseden
+// ali je tabela polna.
+uint8_t CONSOLE_register(char key, CONSOLE_handler_t handler, const char *help)
+{
+	if ( key == '?' || command_count >= CONSOLE_MAX_COMMANDS || CONSOLE_find(key) != NULL )
+		return 0;
+
+	commands[command_count].key = key;
+	commands[command_count].handler = handler;
+	commands[command_count].help = help;
+	command_count++;
+
+	return 1;
+}
+
+
+// Obdelaj vse prejete znake. Funkcijo kličemo periodično (opravilo "log" v tasks.c).
+void CONSOLE_service(void)
+{
+	uint8_t key;
+	const CONSOLE_command_t *command;
+
+	while (SCI_RX_buffer_get_byte(&key) == BUFFER_OK)
+	{
+		if ( key == '?' )
+		{
+			CONSOLE_help_print();
+			continue;
+		}
+
+		command = CONSOLE_find((char) key);
+		if ( command != NULL )
+			command->handler();
+	}
+}
+
+
+// Izpiši registrirane ukaze, en ukaz na vrstico.
+void CONSOLE_help_print(void)
+{
+	for ( uint32_t i = 0; i < command_count; i++ )
+		printf("console,%c,%s\n", commands[i].key, commands[i].help);
+}
+
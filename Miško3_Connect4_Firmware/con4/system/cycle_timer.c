@@ -0,0 +1,236 @@
+/*
+ * cycle_timer.c
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+
+/* **************** MODULE DESCRIPTION *************************
+
+Ta modul dopolnjuje timing_utils.c: namesto milisekundnega SysTick števca
+uporablja DWT števec ciklov jedra Cortex-M4 (CYCCNT), ki teče s frekvenco
+jedra (170 MHz, torej ~6 ns ločljivosti). Tako lahko merimo tudi dogodke,
+krajše od milisekunde, npr. eno inferenco mreže ali izris enega žetona.
+
+32-bitni števec se pri 170 MHz preliva vsakih ~25 s. Razlika dveh vrednosti
+(CYCLE_timer_start/stop) je zaradi nepredznačene aritmetike pravilna tudi
+čez preliv, če je meritev krajša od ~25 s. Za daljše intervale je na voljo
+64-bitni čas CYCLE_now64(), ki ga je treba klicati vsaj enkrat na ~25 s
+(to naredi SCHED_tick_Callback()).
+
+Merilniki (cycle_timer_t) hranijo število meritev ter najkrajšo, najdaljšo
+in povprečno meritev. Vsi merilniki, inicializirani s CYCLE_timer_init(),
+so povezani v seznam, ki ga CYCLE_print_all() izpiše v CSV obliki, tako da
+vsi podsistemi poročajo primerljive številke.
+
+Pri prevajanju za osebni računalnik (tools/CMakeLists.txt) je definiran
+makro CYCLE_HOST_CLOCK: funkcije za dostop do števca (CYCLE_init() do
+CYCLE_to_ns()) takrat nadomesti tools/host/cycle_clock_host.c, merilniki
+pa ostanejo enaki.
+
+************************************************************* */
+
+
+
+
+// ----------- Include other modules (for private) -------------
+
+#include <stdio.h>
+
+#include "cycle_timer.h"
+#ifndef CYCLE_HOST_CLOCK
+#include "stm32g4xx.h"
+#endif
+
+
+// ---------------------- Private definitions ------------------
+
+static cycle_timer_t *timer_list;
+
+// Merilniki števec berejo neposredno, brez klica funkcije.
+#ifndef CYCLE_HOST_CLOCK
+#define CYCLE_COUNTER()		(DWT->CYCCNT)
+#else
+#define CYCLE_COUNTER()		CYCLE_now()
+#endif
+
+#ifndef CYCLE_HOST_CLOCK
+static uint32_t now64_high;			// zgornja polovica 64-bitnega časa
+static uint32_t now64_last;			// zadnja prebrana vrednost števca
+#endif
+
+
+
+
+// -------------- Public function implementations --------------
+
+
+#ifndef CYCLE_HOST_CLOCK
+
+// Omogoči DWT števec ciklov. Funkcijo lahko kliče vsak modul, ki števec potrebuje.
+void CYCLE_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+
+uint32_t CYCLE_now(void)
+{
+	return DWT->CYCCNT;
+}
+
+
+// 64-bitni čas v ciklih. Klic je dovoljen tudi iz prekinitev.
+uint64_t CYCLE_now64(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t now;
+	uint64_t result;
+
+	__disable_irq();
+
+	now = DWT->CYCCNT;
+	if ( now < now64_last )
+		now64_high++;
+	now64_last = now;
+	result = ((uint64_t) now64_high << 32) | now;
+
+	__set_PRIMASK(primask);
+	return result;
+}
+
+
+uint32_t CYCLE_hz(void)
+{
+	return SystemCoreClock;
+}
+
+
+uint32_t CYCLE_to_us(uint32_t cycles)
+{
+	return cycles / (SystemCoreClock / 1000000);
+}
+
+
+uint32_t CYCLE_to_ns(uint32_t cycles)
+{
+	return (uint32_t) ((uint64_t) cycles * 1000000000 / SystemCoreClock);
+}
+
+#endif /* CYCLE_HOST_CLOCK */
+
+
+
+
+// ------ Merilniki -------
+
+
+// Pripravi merilnik in ga doda v seznam za CYCLE_print_all().
+void CYCLE_timer_init(cycle_timer_t *timer, const char *name)
+{
+	cycle_timer_t *t;
+
+	timer->name = name;
+	CYCLE_timer_reset(timer);
+
+	for ( t = timer_list; t != NULL; t = t->next )
+	{
+		if ( t == timer )
+			return;
+	}
+	timer->next = timer_list;
+	timer_list = timer;
+}
+
+
+void CYCLE_timer_reset(cycle_timer_t *timer)
+{
+	timer->running = 0;
+	timer->count = 0;
+	timer->last = 0;
+	timer->min = UINT32_MAX;
+	timer->max = 0;
+	timer->total = 0;
+}
+
+
+void CYCLE_timer_start(cycle_timer_t *timer)
+{
+	timer->running = 1;
+	timer->start = CYCLE_COUNTER();
+}
+
+
+// Zaključi meritev, jo prišteje statistiki in vrne njeno trajanje v ciklih.
+uint32_t CYCLE_timer_stop(cycle_timer_t *timer)
+{
+	uint32_t cycles = CYCLE_COUNTER() - timer->start;
+
+	if ( !timer->running )
+		return 0;
+	timer->running = 0;
+
+	CYCLE_timer_add(timer, cycles);
+	return cycles;
+}
+
+
+// Prišteje meritev, izmerjeno drugje (npr. razliko dveh CYCLE_now()).
+void CYCLE_timer_add(cycle_timer_t *timer, uint32_t cycles)
+{
+	timer->count++;
+	timer->last = cycles;
+	timer->total += cycles;
+	if ( cycles < timer->min )
+		timer->min = cycles;
+	if ( cycles > timer->max )
+		timer->max = cycles;
+}
+
+
+uint32_t CYCLE_timer_mean(const cycle_timer_t *timer)
+{
+	return timer->count ? (uint32_t) (timer->total / timer->count) : 0;
+}
+
+
+cycle_scope_t CYCLE_scope_begin(cycle_timer_t *timer)
+{
+	CYCLE_timer_start(timer);
+	return (cycle_scope_t){ timer };
+}
+
+
+void CYCLE_scope_end(cycle_scope_t *scope)
+{
+	CYCLE_timer_stop(scope->timer);
+}
+
+
+
+
+// ------ Izpis -------
+
+
+// Izpiše vse merilnike v CSV obliki: ime, število meritev ter najkrajša,
+// povprečna in najdaljša meritev v ciklih in povprečje v ns.
+void CYCLE_print_all(void)
+{
+	printf("cycles,name,count,min,mean,max,mean_ns\n");
+	for ( cycle_timer_t *t = timer_list; t != NULL; t = t->next )
+	{
+		uint32_t mean = CYCLE_timer_mean(t);
+
+		printf("cycles,%s,%lu,%lu,%lu,%lu,%lu\n", t->name, (unsigned long) t->count,
+				(unsigned long) (t->count ? t->min : 0), (unsigned long) mean,
+				(unsigned long) t->max, (unsigned long) CYCLE_to_ns(mean));
+	}
+}
+
+
+void CYCLE_reset_all(void)
+{
+	for ( cycle_timer_t *t = timer_list; t != NULL; t = t->next )
+		CYCLE_timer_reset(t);
+}
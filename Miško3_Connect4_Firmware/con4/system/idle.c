@@ -0,0 +1,360 @@
+/*
+ * idle.c
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+
+/* **************** MODULE DESCRIPTION *************************
+
+Ta modul odloča, kako procesor čaka, ko razvrščevalnik (scheduler.c)
+nima dela. Razvrščevalnik pokliče IDLE_enter() z onemogočenimi
+prekinitvami in s časom do naslednjega programskega časovnika.
+
+Na voljo sta dva načina:
+
+	- Sleep (WFI): ure perifernih enot tečejo, procesor zbudi katerakoli
+	  prekinitev, najpozneje TIM6 vsako milisekundo. Bujenje je takojšnje.
+
+	- Stop 1: ure stojijo, tok je za nekaj velikostnih razredov manjši.
+	  Procesor zbudi pritisk tipke (EXTI) ali LPTIM1, nastavljen na
+	  naslednji časovnik. Ob bujenju teče na HSI16, zato je treba ponovno
+	  nastaviti PLL (SystemClock_Config()), kar traja nekaj deset us.
+	  HAL_GetTick() med Stop načinom stoji, zato mu prespani čas prištejemo.
+
+Stop je dovoljen le, ko ga aplikacija izrecno dovoli (IDLE_allow_stop(),
+npr. na zaslonu "PRESS ANY BUTTON") in je od tega minilo vsaj
+IDLE_STOP_DELAY_MS. Ob prvem vstopu v Stop se ugasne osvetlitev zaslona,
+prvi pritisk tipke pa jo spet prižge (IDLE_screen_wake()). Poleg tega
+morajo mirovati tipkovnica (odskakovanje na TIM7) in pošiljanje prek
+SCI (DMA), do naslednjega časovnika pa mora biti vsaj IDLE_STOP_MIN_MS.
+
+IDLE_STOP_DELAY_MS je torej glavni parameter kompromisa med porabo in
+odzivnostjo: krajši zamik pomeni več časa v Stop načinu in hkrati več
+bujenj, ki trajajo dlje (in ugasnjen zaslon).
+
+Za vsak način se beležijo število vstopov in čas bivanja, za Stop pa še
+čas bujenja (od izhoda iz WFI do ponovno nastavljene ure). Statistiko
+izpiše IDLE_stats_print() (ukaz 'w', console.c), vsako
+bujenje iz Stop načina pa se zapiše tudi v binarni zapis (TRACE_IDLE_STOP).
+
+Za LPTIM1 CubeMX projekt nima gonilnika, zato enoto nastavimo
+neposredno z registri. Šteje takt LSI (32 kHz), deljen z 32, torej
+milisekunde.
+
+POZOR: USART3 v Stop načinu ne sprejema, zato se ukazi prek SCI
+upoštevajo šele, ko je zaslon spet prižgan.
+
+************************************************************* */
+
+
+
+
+// ----------- Include other modules (for private) -------------
+
+#include <stdio.h>
+
+#include "idle.h"
+#include "kbd.h"			// Stop le, ko tipkovnica miruje
+#include "SCI.h"			// ... in ko so vsa sporočila poslana
+#include "lcd_backlight.h"	// osvetlitev zaslona med Stop načinom ugasnemo
+#include "cycle_timer.h"
+#include "trace.h"
+#include "trace_events.h"
+#include "console.h"
+
+#include "stm32g4xx_hal.h"
+#include "stm32g4xx_ll_pwr.h"
+#include "stm32g4xx_ll_cortex.h"
+#include "stm32g4xx_ll_bus.h"
+#include "stm32g4xx_ll_exti.h"
+
+
+// ---------------------- Private definitions ------------------
+
+#define IDLE_LPTIM_MAX_MS		0xFFFF			// 16-bitni števec LPTIM1
+#define IDLE_WAKE_CLOCK_HZ		HSI_VALUE		// ura takoj po izhodu iz Stop načina
+#define IDLE_LPTIM_EXTI_LINE	LL_EXTI_LINE_29	// LPTIM1 prekinitev prek EXTI zbudi Stop
+
+typedef struct
+{
+	uint8_t stop_allowed;
+	uint32_t allowed_since_ms;		// HAL_GetTick() ob IDLE_allow_stop(1)
+
+	uint8_t screen_off;
+	uint8_t saved_brightness;
+
+	uint32_t stats_start_ms;
+	IDLE_stats_t stats[IDLE_NUM_OF_MODES];
+
+} idle_handle_t;
+
+static idle_handle_t idle;
+
+static const char *idle_mode_names[IDLE_NUM_OF_MODES] = { "run", "sleep", "stop" };
+
+// HAL števec milisekund (stm32g4xx_hal.c); po Stop načinu mu prištejemo prespani čas.
+extern __IO uint32_t uwTick;
+
+// main.c: po Stop načinu je treba ponovno vklopiti PLL.
+void SystemClock_Config(void);
+
+
+
+
+// -------------- Private function implementations -------------
+
+
+static void IDLE_stats_add(idle_mode_t mode, uint32_t dwell_us)
+{
+	IDLE_stats_t *s = &idle.stats[mode];
+
+	s->entries++;
+	s->dwell_us += dwell_us;
+	if ( dwell_us > s->max_dwell_us )
+		s->max_dwell_us = dwell_us;
+}
+
+
+static uint8_t IDLE_stop_possible(uint32_t next_timer_ms)
+{
+	return IDLE_USE_STOP
+			&& idle.stop_allowed
+			&& ( HAL_GetTick() - idle.allowed_since_ms >= IDLE_STOP_DELAY_MS )
+			&& ( next_timer_ms >= IDLE_STOP_MIN_MS )
+			&& KBD_is_idle()
+			&& SCI_DMA_is_idle();
+}
+
+
+// Zažene LPTIM1 v enkratnem načinu, da čez "ms" milisekund zbudi procesor.
+static void IDLE_lptim_start(uint32_t ms)
+{
+	LPTIM1->ICR = LPTIM_ICR_ARRMCF | LPTIM_ICR_ARROKCF;
+	LPTIM1->CR = LPTIM_CR_ENABLE;
+	LPTIM1->ARR = ms;
+	while ( !(LPTIM1->ISR & LPTIM_ISR_ARROK) );
+
+	LPTIM1->CR = LPTIM_CR_ENABLE | LPTIM_CR_SNGSTRT;
+}
+
+
+// Ustavi LPTIM1 in vrne, koliko milisekund je štel. Števec teče asinhrono,
+// zato ga beremo, dokler dve zaporedni branji nista enaki.
+static uint32_t IDLE_lptim_stop(idle_wake_t *reason)
+{
+	uint32_t a, b;
+
+	if ( LPTIM1->ISR & LPTIM_ISR_ARRM )
+	{
+		*reason = IDLE_WAKE_TIMER;
+		a = LPTIM1->ARR;
+	}
+	else
+	{
+		*reason = IDLE_WAKE_INPUT;
+		do
+		{
+			a = LPTIM1->CNT;
+			b = LPTIM1->CNT;
+		} while ( a != b );
+	}
+
+	LPTIM1->CR = 0;
+	LPTIM1->ICR = LPTIM_ICR_ARRMCF;
+	LL_EXTI_ClearFlag_0_31(IDLE_LPTIM_EXTI_LINE);
+	NVIC_ClearPendingIRQ(LPTIM1_IRQn);
+
+	return a;
+}
+
+
+static void IDLE_sleep(void)
+{
+	uint32_t start = CYCLE_now();
+
+	__WFI();
+
+	IDLE_stats_add(IDLE_MODE_SLEEP, CYCLE_to_us(CYCLE_now() - start));
+}
+
+
+static void IDLE_stop(uint32_t next_timer_ms)
+{
+	uint32_t ms = ( next_timer_ms > IDLE_LPTIM_MAX_MS ) ? IDLE_LPTIM_MAX_MS : next_timer_ms;
+	uint32_t wake_start, wake_us, slept_ms;
+	idle_wake_t reason;
+	IDLE_stats_t *s = &idle.stats[IDLE_MODE_STOP];
+
+	if ( !idle.screen_off )
+	{
+		idle.saved_brightness = LCD_BKLT_get_brightness();
+		LCD_BKLT_off();
+		idle.screen_off = 1;
+	}
+
+	IDLE_lptim_start(ms);
+	HAL_SuspendTick();
+
+	LL_PWR_SetPowerMode(LL_PWR_MODE_STOP1);
+	LL_LPM_EnableDeepSleep();
+	__WFI();
+
+	// Prekinitve so še onemogočene, zato tu merimo le vklop PLL. Do prve
+	// nastavitve ure teče DWT s HSI16, kar da zgornjo mejo časa v us.
+	// Strojnega bujenja (regulator, zagon HSI16) DWT ne vidi.
+	wake_start = CYCLE_now();
+	LL_LPM_EnableSleep();
+	SystemClock_Config();
+	wake_us = (CYCLE_now() - wake_start) / (IDLE_WAKE_CLOCK_HZ / 1000000);
+
+	slept_ms = IDLE_lptim_stop(&reason);
+	uwTick += slept_ms;
+	HAL_ResumeTick();
+
+	IDLE_stats_add(IDLE_MODE_STOP, slept_ms * 1000);
+	if ( s->entries == 1 || wake_us < s->wake_us_min )
+		s->wake_us_min = wake_us;
+	if ( wake_us > s->wake_us_max )
+		s->wake_us_max = wake_us;
+	s->wake_us_total += wake_us;
+	if ( reason == IDLE_WAKE_TIMER )
+		s->timer_wakes++;
+
+	TRACE_EVENT3(TRACE_IDLE_STOP, slept_ms, wake_us, reason);
+}
+
+
+
+
+// -------------- Public function implementations --------------
+
+
+// Vklopi LSI in nastavi LPTIM1, ki zbudi procesor iz Stop načina.
+void IDLE_init(void)
+{
+	CYCLE_init();
+
+	SET_BIT(RCC->CSR, RCC_CSR_LSION);
+	while ( !READ_BIT(RCC->CSR, RCC_CSR_LSIRDY) );
+
+	MODIFY_REG(RCC->CCIPR, RCC_CCIPR_LPTIM1SEL, RCC_CCIPR_LPTIM1SEL_0);		// LSI
+	LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_LPTIM1);
+
+	// CFGR in IER smemo pisati le pri izklopljeni enoti.
+	LPTIM1->CR = 0;
+	LPTIM1->CFGR = LPTIM_CFGR_PRESC_2 | LPTIM_CFGR_PRESC_0;		// 32 kHz / 32 = 1 kHz
+	LPTIM1->IER = LPTIM_IER_ARRMIE;
+
+	LL_EXTI_EnableIT_0_31(IDLE_LPTIM_EXTI_LINE);
+
+	NVIC_SetPriority(LPTIM1_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), IDLE_IRQ_PRIORITY, 0));
+	NVIC_EnableIRQ(LPTIM1_IRQn);
+
+	IDLE_stats_reset();
+
+	CONSOLE_register('w', IDLE_stats_print, "run/sleep/stop time and wake-up stats");
+}
+
+
+// Funkcijo kliče razvrščevalnik z onemogočenimi prekinitvami, ko nobeno opravilo
+// nima dela. "next_timer_ms" je čas do naslednjega časovnika (UINT32_MAX, če ga ni).
+// Funkcija se vrne po prvi prekinitvi, ki pa se izvede šele po vrnitvi.
+void IDLE_enter(uint32_t next_timer_ms)
+{
+	if ( IDLE_stop_possible(next_timer_ms) )
+		IDLE_stop(next_timer_ms);
+	else
+		IDLE_sleep();
+}
+
+
+// Aplikacija z IDLE_allow_stop(1) sporoči, da čaka le na pritisk tipke in
+// sme po IDLE_STOP_DELAY_MS v Stop način. IDLE_allow_stop(0) to prekliče in
+// prižge zaslon. Ponovni klic z isto vrednostjo ne spremeni ničesar.
+void IDLE_allow_stop(uint8_t allow)
+{
+	if ( allow && !idle.stop_allowed )
+	{
+		idle.stop_allowed = 1;
+		idle.allowed_since_ms = HAL_GetTick();
+	}
+	else if ( !allow )
+	{
+		IDLE_screen_wake();
+		idle.stop_allowed = 0;
+	}
+}
+
+
+// Če je bil zaslon zaradi Stop načina ugasnjen, ga prižge, ponovno začne šteti
+// IDLE_STOP_DELAY_MS in vrne 1. Tako prvi pritisk tipke le prižge zaslon.
+uint8_t IDLE_screen_wake(void)
+{
+	if ( !idle.screen_off )
+		return 0;
+
+	LCD_BKLT_set_brightness(idle.saved_brightness);
+	idle.screen_off = 0;
+	idle.allowed_since_ms = HAL_GetTick();
+	return 1;
+}
+
+
+// Prekinitev LPTIM1 (stm32g4xx_it.c). Zastavico običajno pobriše že
+// IDLE_lptim_stop(), preden se prekinitev sploh izvede.
+void IDLE_wakeup_timer_Callback(void)
+{
+	LPTIM1->ICR = LPTIM_ICR_ARRMCF;
+	LL_EXTI_ClearFlag_0_31(IDLE_LPTIM_EXTI_LINE);
+}
+
+
+
+
+// ------ Statistika -------
+
+
+const IDLE_stats_t* IDLE_get_stats(idle_mode_t mode)
+{
+	return &idle.stats[mode];
+}
+
+
+void IDLE_stats_reset(void)
+{
+	for ( uint32_t i = 0; i < IDLE_NUM_OF_MODES; i++ )
+		idle.stats[i] = (IDLE_stats_t){ 0 };
+
+	idle.stats_start_ms = HAL_GetTick();
+}
+
+
+// Izpiše statistiko v CSV obliki: način, število vstopov, skupni čas v ms,
+// delež časa v promilih, najdaljše bivanje v us, čas bujenja (min, povprečje,
+// max v us) in število bujenj zaradi časovnika. Vrstica "run" je preostanek
+// časa, ko procesor ni spal.
+void IDLE_stats_print(void)
+{
+	uint64_t window_us = (uint64_t)(HAL_GetTick() - idle.stats_start_ms) * 1000;
+	uint64_t idle_us = idle.stats[IDLE_MODE_SLEEP].dwell_us + idle.stats[IDLE_MODE_STOP].dwell_us;
+
+	if ( window_us == 0 )
+		window_us = 1;
+
+	idle.stats[IDLE_MODE_RUN].dwell_us = ( idle_us < window_us ) ? window_us - idle_us : 0;
+
+	printf("idle,mode,entries,time_ms,share_permille,max_dwell_us,wake_us_min,wake_us_avg,wake_us_max,timer_wakes\n");
+	for ( uint32_t i = 0; i < IDLE_NUM_OF_MODES; i++ )
+	{
+		const IDLE_stats_t *s = &idle.stats[i];
+		uint32_t wake_avg = s->entries ? (uint32_t)(s->wake_us_total / s->entries) : 0;
+
+		printf("idle,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", idle_mode_names[i],
+				(unsigned long) s->entries, (unsigned long) (s->dwell_us / 1000),
+				(unsigned long) (s->dwell_us * 1000 / window_us),
+				(unsigned long) s->max_dwell_us, (unsigned long) s->wake_us_min,
+				(unsigned long) wake_avg, (unsigned long) s->wake_us_max,
+				(unsigned long) s->timer_wakes);
+	}
+}
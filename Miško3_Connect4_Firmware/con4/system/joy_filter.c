@@ -0,0 +1,156 @@
+/*
+ * joy_filter.c
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+
+/* **************** MODULE DESCRIPTION *************************
+
+Ta modul vsebuje obdelavo meritev "joysticka", ki ne potrebuje strojne
+opreme: filtriranje vzorcev, preslikavo v odklon z mrtvim območjem
+(angl. dead zone) in pretvorbo odklona v korake za izbiro stolpca.
+
+Modul ne uporablja HAL knjižnice, zato ga lahko prevedemo tudi na
+osebnem računalniku (tools/joy_replay), kjer ga preizkusimo na
+posnetih vzorcih in z enotskim testom (joy_filter_test.c).
+
+Vse računanje je celoštevilsko (fiksna vejica), saj se izvaja v
+prekinitvah DMA enote.
+
+************************************************************* */
+
+
+
+
+// ----------- Include other modules (for private) -------------
+
+#include "joy_filter.h"
+
+
+// ---------------------- Private definitions ------------------
+
+// Korak je narejen, ko akumulator doseže 100 % * 1000 ms.
+#define JOY_STEP_THRESHOLD		(100 * 1000)
+
+
+
+
+// -------------- Public function implementations --------------
+
+
+void JOY_FILTER_init(joy_filter_t *filter, uint16_t initial)
+{
+	filter->history[0] = initial;
+	filter->history[1] = initial;
+	filter->y = (int32_t) initial << JOY_FILTER_FRAC_BITS;
+}
+
+
+// Filtrira en vzorec in vrne filtrirano vrednost v enakem merilu kot vzorec.
+uint16_t JOY_FILTER_update(joy_filter_t *filter, uint16_t sample)
+{
+	uint16_t a = filter->history[0];
+	uint16_t b = filter->history[1];
+	uint16_t median;
+
+	filter->history[0] = b;
+	filter->history[1] = sample;
+
+	// mediana treh vzorcev
+	if ( a > b )
+	{
+		uint16_t t = a;
+		a = b;
+		b = t;
+	}
+	if ( sample <= a )
+		median = a;
+	else if ( sample >= b )
+		median = b;
+	else
+		median = sample;
+
+	// IIR filter prvega reda: y += (x - y) / 2^SHIFT
+	filter->y += (((int32_t) median << JOY_FILTER_FRAC_BITS) - filter->y) >> JOY_FILTER_IIR_SHIFT;
+
+	return (uint16_t) ((filter->y + (1 << (JOY_FILTER_FRAC_BITS - 1))) >> JOY_FILTER_FRAC_BITS);
+}
+
+
+// Preslika filtrirano vrednost v odklon od sredine v procentih [-100..100].
+// Odklon znotraj mrtvega območja je 0, preostanek pa se raztegne na cel interval.
+int8_t JOY_FILTER_deflection(uint16_t value, uint16_t center, uint16_t half_range)
+{
+	int32_t deflection;
+	int32_t magnitude;
+
+	if ( half_range == 0 )
+		return 0;
+
+	deflection = ((int32_t) value - center) * 100 / half_range;
+	magnitude = deflection < 0 ? -deflection : deflection;
+
+	if ( magnitude <= JOY_DEAD_ZONE_PCT )
+		return 0;
+	if ( magnitude > 100 )
+		magnitude = 100;
+
+	magnitude = (magnitude - JOY_DEAD_ZONE_PCT) * 100 / (100 - JOY_DEAD_ZONE_PCT);
+
+	return deflection < 0 ? -magnitude : magnitude;
+}
+
+
+
+
+void JOY_STEP_init(joy_stepper_t *stepper)
+{
+	stepper->direction = 0;
+	stepper->accumulator = 0;
+	stepper->release_ms = 0;
+}
+
+
+// Upošteva odklon "deflection", ki je trajal "dt_ms" milisekund.
+// Vrne -1 ali +1, ko je treba izbiro premakniti za en stolpec, sicer 0.
+int8_t JOY_STEP_update(joy_stepper_t *stepper, int8_t deflection, uint32_t dt_ms)
+{
+	int8_t direction = ( deflection > 0 ) - ( deflection < 0 );
+	int32_t magnitude = deflection < 0 ? -deflection : deflection;
+
+	// Histereza: smer sprostimo šele, ko je odklon JOY_STEP_RELEASE_MS v mrtvem
+	// območju. Sicer bi šum na robu mrtvega območja prožil vedno nove takojšnje korake.
+	if ( direction == 0 )
+	{
+		if ( stepper->direction != 0 )
+		{
+			stepper->release_ms += dt_ms;
+			if ( stepper->release_ms >= JOY_STEP_RELEASE_MS )
+			{
+				stepper->direction = 0;
+				stepper->accumulator = 0;
+			}
+		}
+		return 0;
+	}
+	stepper->release_ms = 0;
+
+	// Ob izhodu iz mrtvega območja (ali ob menjavi smeri) takoj naredimo en korak.
+	if ( direction != stepper->direction )
+	{
+		stepper->direction = direction;
+		stepper->accumulator = 0;
+		return direction;
+	}
+
+	// Hitrost koraka v stotinkah stolpca na sekundo, linearno med MIN in MAX.
+	stepper->accumulator += (JOY_STEP_RATE_MIN * 100 + magnitude * (JOY_STEP_RATE_MAX - JOY_STEP_RATE_MIN)) * (int32_t) dt_ms;
+
+	if ( stepper->accumulator >= JOY_STEP_THRESHOLD )
+	{
+		stepper->accumulator -= JOY_STEP_THRESHOLD;
+		return direction;
+	}
+	return 0;
+}
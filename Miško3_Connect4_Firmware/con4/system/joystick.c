@@ -28,6 +28,20 @@ Modul omogoča:
 	- demonstracijo delovanja "joysticka" (s pomočjo SCI in LED
 		modulov)
 
+	- izbiro stolpca z odklonom X osi (JOY_COLUMN_SELECT),
+
+	- snemanje "surovih" vzorcev v binarni zapis (trace.c) za
+	  preizkus filtra na osebnem računalniku (tools/joy_replay).
+
+
+Časovnik TIM1 proži pretvorbe obeh osi s frekvenco JOY_SAMPLE_RATE_HZ,
+DMA enota pa jih v krožnem načinu (angl. circular mode) prenaša v
+medpomnilnik z dvema polovicama. Ko je ena polovica polna, jo obdelamo v
+prekinitvi DMA enote (HAL_ADC_ConvHalfCpltCallback() oziroma
+HAL_ADC_ConvCpltCallback()), medtem ko DMA polni drugo polovico.
+Vsak vzorec gre skozi filter iz joy_filter.c (mediana + IIR), tako da
+procesor "joysticka" nikoli ne sprašuje (angl. polling).
+
 
 
 POZOR: za uspešno uporabo modula je potrebno predhodno poskrbeti
@@ -51,6 +65,13 @@ AD pretvornika v navezi z DMA enoto.
 #include "LED.h"
 #include "SCI.h"
 
+#include "joy_filter.h"		// filtriranje vzorcev in mrtvo območje
+#include "kbd.h"			// odklon "joysticka" se pretvori v pritiske tipk LEFT/RIGHT
+#include "cycle_timer.h"	// trajanje obdelave bloka vzorcev
+#include "trace.h"			// snemanje vzorcev
+#include "trace_events.h"
+#include "console.h"		// ukaz 'j' za snemanje
+
 
 
 
@@ -90,6 +111,17 @@ typedef struct
 	uint16_t 	position_raw_min[NUM_OF_AXES];			// informacija o največjem odklonu osi "joysticka"
 	uint16_t 	position_raw_range[NUM_OF_AXES];		// informacija o razponu odklona osi "joysticka" (angl. axis range)
 
+	// Filtriranje in preslikava meritev (joy_filter.c).
+	// VEDITE: "position_raw" sedaj hrani filtrirano meritev.
+	joy_filter_t	filter[NUM_OF_AXES];
+	uint16_t		center[NUM_OF_AXES];			// lega osi v mirovanju (prvi blok vzorcev)
+	uint8_t			centered;
+	int8_t			deflection[NUM_OF_AXES];		// odklon od sredine [-100..100], 0 v mrtvem območju
+	joy_stepper_t	stepper;						// odklon X osi -> premik izbranega stolpca
+
+	uint8_t			recording;						// 1: "surovi" vzorci se snemajo
+	uint32_t		recording_dropped;				// zavrženi bloki, ker medpomnilnik ni bil sproti izpraznjen
+
 
 	// Za merjenje lege osi "joysticka" je potrebno upravljati še z časovnikom, ki
 	// periodično proži meritve lege, in DMA enoto, ki skrbi za avtomatsko shranjevanje
@@ -134,11 +166,11 @@ joystick_handle_t joystick;
 
 
 // Najprej je potrebno vključiti knjižnico za delo s cikličnim medpomnilnikom.
-#include "buf.h"
+#include "ring.h"
 
 // Definirajmo dolžino cikličnega medpomnilnika za tipke "joysticka". Definirajmo
 // jo kot makro parameter.
-#define JOY_BTN_BUF_LEN 	20
+#define JOY_BTN_BUF_LEN 	32
 
 
 // In sedaj še definirajmo podatkovne strukture, s katerimi bomo implementirali
@@ -146,7 +178,35 @@ joystick_handle_t joystick;
 // o pritisnjenih tipkah "joysticka". In potrebujemo "handle" strukturo za upravljanje
 // cikličnega medpomnilnika.
 uint8_t 		joy_btn_buffer[JOY_BTN_BUF_LEN];	// the buffer data array
-buf_handle_t 	joy_btn_buf_handle;					// the buffer handle structure
+ring_handle_t 	joy_btn_buf_handle;					// the buffer handle structure
+
+
+
+
+// -------- DMA medpomnilnik in snemanje ----------
+
+// Vzorci osi so v medpomnilniku prepleteni (X, Y, X, Y, ...), saj AD pretvornik
+// ob vsakem proženju pretvori obe osi. Medpomnilnik ima dve polovici po JOY_DMA_BLOCK vzorcev na os.
+#define JOY_BLOCK_VALUES	(JOY_DMA_BLOCK * NUM_OF_AXES)
+
+uint16_t		joy_dma_buffer[2 * JOY_BLOCK_VALUES];
+
+// Posneti bloki vzorcev čakajo v medpomnilniku, dokler jih JOY_record_service()
+// ne zapiše v binarni zapis (TRACE_record() ne smemo klicati iz prekinitev).
+#define JOY_REC_BUF_LEN		1024		// 16 blokov = 256 ms
+
+uint8_t			joy_rec_buffer[JOY_REC_BUF_LEN];
+ring_handle_t	joy_rec_buf_handle;
+
+cycle_timer_t	joy_block_timer;		// trajanje obdelave enega bloka vzorcev
+
+
+
+
+// ------------- Private function prototypes ------------
+
+static void JOY_process_block(const uint16_t *samples);
+static uint16_t JOY_half_range(joystick_axes_enum_t axis);
 
 
 
@@ -229,9 +289,19 @@ void JOY_init(ADC_HandleTypeDef *ADC_handle, TIM_HandleTypeDef *timer_handle)
 
 	// 3. Inicializiramo medpomnilnik za tipke "joysticka"
 
-		// Uporabimo funkcijo BUF_init(), ki določi, katera tabela se bo uporabljala kot
+		// Uporabimo funkcijo RING_init(), ki določi, katera tabela se bo uporabljala kot
 		// ciklični medpomnilnik ter kako dolg bo ta medpomnilnik.
-		BUF_init( &joy_btn_buf_handle, joy_btn_buffer, JOY_BTN_BUF_LEN);
+		RING_init( &joy_btn_buf_handle, joy_btn_buffer, JOY_BTN_BUF_LEN);
+
+		// In medpomnilnik za snemanje vzorcev.
+		RING_init( &joy_rec_buf_handle, joy_rec_buffer, JOY_REC_BUF_LEN);
+
+		// Sredino osi določi prvi blok vzorcev (privzamemo, da "joystick" ob zagonu miruje).
+		joystick.centered = 0;
+		JOY_STEP_init(&joystick.stepper);
+
+		CYCLE_init();
+		CYCLE_timer_init(&joy_block_timer, "joy_block");
 
 
 
@@ -253,10 +323,9 @@ void JOY_init(ADC_HandleTypeDef *ADC_handle, TIM_HandleTypeDef *timer_handle)
 		// s katerim AD pretvornikom bo delala, na katero mesto v pomnilniku
 		// naj shranjuje rezultate AD pretvorbe ter koliko teh rezultatov bo morala prenesti
 		// ob vsaki končani AD pretvorbi.
-		// Namig: meritve AD pretvornika želimo shraniti v ustrezno tabelo znotraj
-		// "joystick" handle strukture. Število rezultatev AD pretvorbe pa je 
-		// enako dolžini te tabele.
-		HAL_ADC_Start_DMA(ADC_handle, (uint32_t *) joystick.position_raw, NUM_OF_AXES);
+		// Meritve shranjujemo v krožni DMA medpomnilnik z dvema polovicama. Ob napolnitvi
+		// vsake polovice DMA enota sproži prekinitev, v kateri blok vzorcev obdelamo.
+		HAL_ADC_Start_DMA(ADC_handle, (uint32_t *) joy_dma_buffer, 2 * JOY_BLOCK_VALUES);
 
 
 		// Na koncu pa še zaženemo časovnik, ki bo prožil AD pretvorbe.
@@ -264,11 +333,15 @@ void JOY_init(ADC_HandleTypeDef *ADC_handle, TIM_HandleTypeDef *timer_handle)
 		HAL_TIM_Base_Start( timer_handle );
 
 
-	// 5. Počakamo na prvo meritev pozicije "joysticka"
+	// 5. Na prvo meritev ni treba čakati
+
+		// Prvi blok vzorcev je na voljo po JOY_DMA_BLOCK milisekundah; do takrat
+		// je odklon osi 0 in tudi izbira stolpca miruje.
 
-		// Časovnik proži AD pretvorbe vsakih 10 milisekund.
-		// Torej je smiselno počakati milisekundo dlje.
-		HAL_Delay(1);
+
+	// 6. Snemanje vzorcev vklapljamo prek SCI vmesnika
+
+		CONSOLE_register('j', JOY_record_toggle, "start/stop joystick sample recording");
 
 }
 
@@ -314,8 +387,8 @@ void JOY_scan_button(void)
 
 		// In če zaznamo pritisk tipke, shranimo to informacijo v medpomnilnik "joystick" tipkovnice.
 		// Ker ima "joystick" le eno samo tipko, shranimo vedno isto informacijo: JOY_BTN_FIRE.
-		// Uporabimo funkcijo BUF_store_byte().
-		BUF_store_byte( &joy_btn_buf_handle, JOY_BTN_FIRE);
+		// Uporabimo funkcijo RING_put().
+		RING_put( &joy_btn_buf_handle, JOY_BTN_FIRE);
 
 	}
 
@@ -338,7 +411,7 @@ joystick_buttons_enum_t JOY_get_pressed_button(void)
 
 	// Sedaj poskusimo prebrati nov element iz medpomnilnika in ga shraniti v spremenljivko "pressed_button"
 	// Hkrati si v spremenljivko "return_code" zabeležimo vrnjeno kodo "buffer" funkcije.
-	return_code = BUF_get_byte(&joy_btn_buf_handle, &pressed_button);
+	return_code = RING_get(&joy_btn_buf_handle, &pressed_button);
 
 
 	// Če je bilo branje elementa iz medpomnilnika v spremenljivko "pressed_button"
@@ -385,7 +458,7 @@ uint8_t JOY_is_button_state_pressed(void)
 // vso informacijo o morebitnih pritisnjenih tipkah, ki jih še nismo obdelali.
 void JOY_flush(void)
 {
-	BUF_flush(&joy_btn_buf_handle);
+	RING_flush(&joy_btn_buf_handle);
 }
 
 
@@ -558,6 +631,74 @@ uint8_t JOY_get_axis_position(joystick_axes_enum_t axis)
 
 
 
+// Funkcija JOY_get_deflection() vrne odklon osi od sredine v procentih [-100..100].
+// Znotraj mrtvega območja (JOY_DEAD_ZONE_PCT) je odklon 0.
+int8_t JOY_get_deflection(joystick_axes_enum_t axis)
+{
+	return joystick.deflection[axis];
+}
+
+
+
+
+// ------- DMA prekinitve ----------
+
+
+// HAL pokliče ti dve funkciji iz prekinitve DMA enote, ko je polna prva
+// oziroma druga polovica DMA medpomnilnika.
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+	if ( hadc == joystick.ADC )
+		JOY_process_block(&joy_dma_buffer[0]);
+}
+
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+	if ( hadc == joystick.ADC )
+		JOY_process_block(&joy_dma_buffer[JOY_BLOCK_VALUES]);
+}
+
+
+
+
+// ------- Snemanje vzorcev ----------
+
+
+// Vklopi ali izklopi snemanje "surovih" vzorcev.
+// Posnetek dekodira tools/trace_decode, preizkus filtra pa tools/joy_replay.
+void JOY_record_enable(uint8_t enable)
+{
+	joystick.recording = enable;
+}
+
+
+// Ukaz 'j' (console.c): preklopi snemanje.
+void JOY_record_toggle(void)
+{
+	JOY_record_enable(!joystick.recording);
+}
+
+
+uint8_t JOY_is_recording(void)
+{
+	return joystick.recording;
+}
+
+
+// Posnete bloke zapiše v binarni zapis. Kličemo jo iz glavne zanke (opravilo "log").
+void JOY_record_service(void)
+{
+	uint16_t block[JOY_BLOCK_VALUES];
+
+	while ( RING_read(&joy_rec_buf_handle, (uint8_t *) block, sizeof(block)) == BUFFER_OK )
+		TRACE_record(TRACE_JOY_SAMPLES, block, sizeof(block));
+}
+
+
+
+
+
 // ----------------------- Test functions -------------------------------
 
 
@@ -679,3 +820,76 @@ printf("%d\n", led_num);
 }
 
 
+
+
+
+
+// -------------- Private function implementations -------------
+
+
+// Obdela blok JOY_DMA_BLOCK vzorcev obeh osi: filtrira vzorce, izračuna odklon osi
+// in ga pretvori v premike izbranega stolpca.
+static void JOY_process_block(const uint16_t *samples)
+{
+	CYCLE_SCOPE(joy_block_timer);
+	int8_t step;
+
+	if ( !joystick.centered )
+	{
+		for (int axis = 0; axis < NUM_OF_AXES; axis++)
+			JOY_FILTER_init(&joystick.filter[axis], samples[axis]);
+	}
+
+	for (int axis = 0; axis < NUM_OF_AXES; axis++)
+	{
+		uint16_t value = 0;
+
+		for (int i = 0; i < JOY_DMA_BLOCK; i++)
+			value = JOY_FILTER_update(&joystick.filter[axis], samples[i * NUM_OF_AXES + axis]);
+
+		joystick.position_raw[axis] = value;
+
+		if ( !joystick.centered )
+			joystick.center[axis] = value;
+
+		joystick.deflection[axis] = JOY_FILTER_deflection(value, joystick.center[axis], JOY_half_range(axis));
+	}
+	joystick.centered = 1;
+
+
+	if ( joystick.recording )
+	{
+		if ( RING_write(&joy_rec_buf_handle, (const uint8_t *) samples, JOY_BLOCK_VALUES * sizeof(uint16_t)) != BUFFER_OK )
+			joystick.recording_dropped++;
+	}
+
+
+#if JOY_COLUMN_SELECT
+
+	// Odklon X osi premika izbrani stolpec tako kot tipki LEFT in RIGHT.
+	// DMA prekinitev ima enako prioriteto kot prekinitve tipkovnice (EXTI, TIM7);
+	// pri KBD_USE_EXTI = 0 pa pritisk v medpomnilnik shrani KBD_scan() (kbd.c).
+	// Tako se zapisi v medpomnilnik tipkovnice nikoli ne prepletejo.
+	step = JOY_STEP_update(&joystick.stepper,
+			JOY_X_INVERT ? -joystick.deflection[X] : joystick.deflection[X],
+			JOY_DMA_BLOCK * 1000 / JOY_SAMPLE_RATE_HZ);
+
+	if ( step > 0 )
+		KBD_inject_press(BTN_RIGHT);
+	else if ( step < 0 )
+		KBD_inject_press(BTN_LEFT);
+
+#else
+	(void) step;
+#endif
+}
+
+
+// Polovica razpona osi za izračun odklona: iz kalibracije, če je bila izvedena.
+static uint16_t JOY_half_range(joystick_axes_enum_t axis)
+{
+	if ( joystick.position_raw_range[axis] != 0 )
+		return joystick.position_raw_range[axis] / 2;
+	else
+		return JOY_DEFAULT_HALF_RANGE;
+}
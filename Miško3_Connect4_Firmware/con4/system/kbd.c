@@ -15,6 +15,24 @@ v sistemu razpoložljive. Modul implementira branje tipkovnice
 ("skeniranje"), detekcijo pritiska tipk in shranjevanje informacije
 o pritisnjenih tipkah v medpomnilnik (angl. buffer).
 
+Stanje tipk se lahko bere na dva načina (KBD_USE_EXTI v kbd.h):
+
+	- s prekinitvami (privzeto): vsaka sprememba signala tipke sproži EXTI
+	  prekinitev, ki novo stanje takoj upošteva ("leading-edge debounce"),
+	  nato pa za KBD_DEBOUNCE_MS onemogoči prekinitev te tipke, da odskoki
+	  kontaktov ne povzročijo dodatnih pritiskov. Okno odskakovanja odšteva
+	  časovnik TIM7 z milisekundno periodo, ki skrbi tudi za samodejno
+	  ponavljanje držanih tipk LEFT in RIGHT. TIM7 teče le, dokler je kakšna
+	  tipka v oknu odskakovanja ali se ponavlja; ko se tipk nihče ne dotika,
+	  tipkovnica ne porabi nič procesorskega časa.
+
+	- s periodičnim branjem: KBD_scan() kliče periodic_services.c.
+
+Vsak pritisk (in ponovitev) se shrani v medpomnilnik kot dogodek kbd_event_t
+s časovnim žigom v ciklih ter objavi razvrščevalniku kot signal SCHED_SIG_KEY.
+Ob branju dogodka se zabeleži zakasnitev od spremembe signala tipke do
+obdelave pritiska (merilnik "kbd_latency", izpis z ukazom 'c').
+
 POZOR: za uspešno uporabo modula je potrebno predhodno poskrbeti
 za ustrezno nizko-nivojsko inicializacijo digitalnih GPIO vhodov.
 
@@ -28,6 +46,8 @@ za ustrezno nizko-nivojsko inicializacijo digitalnih GPIO vhodov.
 
 
 #include "LED.h"		// vključimo LED modul za potrebe "keyboard demo" funkcije
+#include "scheduler.h"	// pritiske tipk objavimo razvrščevalniku
+#include "cycle_timer.h"	// časovni žigi dogodkov in merjenje zakasnitve
 
 
 
@@ -64,6 +84,14 @@ typedef struct
 		// Namig: za hranjenje informacije o "stanju tipke" uporabimo naštevni tip "button_sig_state_t" .
 		// Hranimo pravzaprav STANJE SIGNALA tipke!
 
+	uint32_t		exti_line;		// EXTI linija tipke (LL_EXTI_LINE_n)
+	uint8_t			repeat;			// 1: držana tipka se samodejno ponavlja
+	uint8_t			debounce_ms;	// preostanek okna odskakovanja, 0 = signal je stabilen
+	uint16_t		repeat_ms;		// čas do naslednje ponovitve držane tipke
+
+	uint32_t		pressed_ms;		// HAL_GetTick() ob zadnjem pritisku
+	uint32_t		released_ms;	// HAL_GetTick() ob zadnji sprostitvi
+
 } button_handle_t;
 
 
@@ -79,6 +107,14 @@ typedef struct
 
 	button_handle_t 	buttons[NUM_OF_BTNS];
 
+	TIM_TypeDef *		debounce_timer;		// milisekundni časovnik za odskakovanje in ponavljanje
+
+#if !KBD_USE_EXTI
+	// Pritiski iz KBD_inject_press(), ki jih v medpomnilnik shrani KBD_scan().
+	// Števca tečeta prosto: prvega piše le KBD_inject_press(), drugega le KBD_scan().
+	volatile uint32_t	injected[NUM_OF_BTNS];
+	uint32_t			injected_stored[NUM_OF_BTNS];
+#endif
 
 } keyboard_handle_t;
 
@@ -117,11 +153,12 @@ keyboard_handle_t		keyboard;		// spremenljivka "handle" strukture za tipkovnico
 
 
 // Najprej je potrebno vključiti knjižnico za delo s cikličnim medpomnilnikom.
-#include "buf.h"
+#include "ring.h"
 
 // Definirajmo dolžino cikličnega medpomnilnika za tipkovnico. Definirajmo
-// jo kot makro parameter.
-#define KBD_BUF_LEN 	32
+// jo kot makro parameter. V medpomnilnik shranjujemo cele dogodke kbd_event_t,
+// zato mora biti dolžina večkratnik velikosti dogodka (128 B = 16 dogodkov).
+#define KBD_BUF_LEN 	128
 
 
 // In sedaj še definirajmo podatkovne strukture, s katerimi bomo implementirali
@@ -129,7 +166,7 @@ keyboard_handle_t		keyboard;		// spremenljivka "handle" strukture za tipkovnico
 // o pritisnjenih tipkah. In potrebujemo "handle" strukturo za upravljanje
 // cikličnega medpomnilnika.
 uint8_t 		kbd_buffer[KBD_BUF_LEN];	// the buffer data array
-buf_handle_t 	kbd_buf_handle;				// the buffer handle structure
+ring_handle_t 	kbd_buf_handle;				// the buffer handle structure
 
 
 // To je vse v smislu podatkovnih struktur, ki so potrebne za implementacijo
@@ -137,6 +174,18 @@ buf_handle_t 	kbd_buf_handle;				// the buffer handle structure
 // s pomočjo funkcij za delo z medpomnilnikom, ki pa se nahajajo v buf.c modulu.
 
 
+// Zakasnitev od spremembe signala tipke do obdelave pritiska.
+cycle_timer_t	kbd_latency_timer;
+
+
+
+
+// ------------- Private function prototypes ------------
+
+static void KBD_set_state(buttons_enum_t button, button_sig_state_t state, uint32_t timestamp);
+static void KBD_put_event(buttons_enum_t button, kbd_event_type_t type, uint32_t timestamp);
+
+
 
 
 
@@ -190,6 +239,21 @@ void KBD_init(void)
 		keyboard.buttons[BTN_DOWN].port = GPIOG;
 
 
+		// EXTI linije imajo enako številko kot pin tipke (nastavljeno v MX_GPIO_Init()).
+		keyboard.buttons[BTN_OK].exti_line = LL_EXTI_LINE_15;
+		keyboard.buttons[BTN_ESC].exti_line = LL_EXTI_LINE_14;
+		keyboard.buttons[BTN_RIGHT].exti_line = LL_EXTI_LINE_8;
+		keyboard.buttons[BTN_LEFT].exti_line = LL_EXTI_LINE_6;
+		keyboard.buttons[BTN_UP].exti_line = LL_EXTI_LINE_0;
+		keyboard.buttons[BTN_DOWN].exti_line = LL_EXTI_LINE_1;
+
+		// Z držanjem tipk LEFT in RIGHT se premikamo čez več stolpcev.
+		keyboard.buttons[BTN_RIGHT].repeat = 1;
+		keyboard.buttons[BTN_LEFT].repeat = 1;
+
+		keyboard.debounce_timer = TIM7;
+
+
 
 
 
@@ -206,15 +270,42 @@ void KBD_init(void)
 			// naštevnim tipom button_sig_value_t.
 
 			keyboard.buttons[i].state = BTN_RELEASED_SIGNAL_STATE;
+			keyboard.buttons[i].debounce_ms = 0;
 		}
 
 
 
 	// 3. Inicializiramo še medpomnilnik tipkovnice.
 
-		// Uporabimo funkcijo BUF_init(), ki določi, katera tabela se bo uporabljala kot
+		// Uporabimo funkcijo RING_init(), ki določi, katera tabela se bo uporabljala kot
 		// ciklični medpomnilnik ter kako dolg bo ta medpomnilnik.
-		BUF_init( &kbd_buf_handle, kbd_buffer, KBD_BUF_LEN);
+		RING_init( &kbd_buf_handle, kbd_buffer, KBD_BUF_LEN);
+
+		CYCLE_init();
+		CYCLE_timer_init(&kbd_latency_timer, "kbd_latency");
+
+
+
+	// 4. Omogočimo prekinitve tipk.
+
+#if KBD_USE_EXTI
+
+		// Časovnik TIM7 je nastavljen na periodo 1 ms (MX_TIM7_Init()), zažene pa se šele ob
+		// prvi spremembi stanja tipke.
+		LL_TIM_EnableIT_UPDATE(keyboard.debounce_timer);
+
+		for(int i=0; i < NUM_OF_BTNS; i++)
+		{
+			LL_EXTI_ClearFlag_0_31(keyboard.buttons[i].exti_line);
+			LL_EXTI_EnableIT_0_31(keyboard.buttons[i].exti_line);
+		}
+
+#else
+
+		for(int i=0; i < NUM_OF_BTNS; i++)
+			LL_EXTI_DisableIT_0_31(keyboard.buttons[i].exti_line);
+
+#endif
 
 }
 
@@ -234,9 +325,8 @@ void KBD_scan(void)
 	// shrani to informacijo v medpomnilnik tipkovnice, da se bo
 	// kasneje lahko sistem odzval na pritisk te tipke.
 
-	// Pripravimo si pomožno spremenljivko, ki bo začasno hranila vrednost prejšnjega,
-	// torej starega stanja tipke.
-	button_sig_state_t state_old;
+	// Pripravimo si pomožno spremenljivko, ki bo hranila novo prebrano stanje tipke.
+	button_sig_state_t state_new;
 
 
 	// Sprehodimo se preko vseh "handle" struktur za delo s posameznimi tipkami.
@@ -244,35 +334,52 @@ void KBD_scan(void)
 	{
 		// Znotraj zanke delamo trenutno z i-to tipko. Spremenljivka "i" je pomožni števec zanke.
 
-		// Trenutno, novo stanje tipke postane sedaj staro stanje tipke in si ga tako shranimo v
-		// pomožno spremenljivko.
-		state_old = keyboard.buttons[i].state;
+		// Novo, trenutno stanje tipke se prebere iz ustreznega digitalnega GPIO vhoda s pomočjo LL funkcije.
+		state_new = LL_GPIO_IsInputPinSet(keyboard.buttons[i].port, keyboard.buttons[i].pin);
 
-		// In novo, trenutno stanje tipke se prebere iz ustreznega digitalnega GPIO vhoda s pomočjo LL funkcije.
-		keyboard.buttons[i].state = LL_GPIO_IsInputPinSet(keyboard.buttons[i].port, keyboard.buttons[i].pin);
 
+		// Če se je stanje spremenilo, ga KBD_set_state() shrani in ob pritisku
+		// shrani dogodek v medpomnilnik tipkovnice.
+		if ( state_new != keyboard.buttons[i].state )
+		{
+			KBD_set_state(i, state_new, CYCLE_now());
+		}
 
+	}
 
+#if !KBD_USE_EXTI
+	// Shranimo še pritiske iz KBD_inject_press(); tako medpomnilnik tipkovnice
+	// tudi v tem načinu piše le ena prekinitev.
+	for(int i=0; i < NUM_OF_BTNS; i++)
+	{
+		while ( keyboard.injected_stored[i] != keyboard.injected[i] )
+		{
+			KBD_put_event(i, KBD_EVENT_PRESS, CYCLE_now());
+			keyboard.injected_stored[i]++;
+		}
+	}
+#endif
 
+}
 
-		// Sedaj pa je potrebno preveriti, ali se je za i-to tipko ZGODIL PRITISK. Pri tem si pomagajte s
-		// starim in trenutnim stanjem tipke. Pomaga vam lahko tudi pomožni naštevni tip button_sig_value_t.
-		if ( ( state_old == BTN_PRESSED_SIGNAL_STATE ) && ( state_old != keyboard.buttons[i].state ) )
-		{
 
-			// In če zaznamo pritisk i-te tipke, shranimo to informacijo v medpomnilnik tipkovnice.
-			// Shranimo seveda kar vrednost elementa naštevnega tipa, ki pripada obravnavani i-ti tipki.
-			// In to je seveda kar vrednost števca "i". Uporabimo funkcijo BUF_store_byte().
-			BUF_store_byte( &kbd_buf_handle, i);
 
-		}
 
-	}
 
-}
 
 
+// Funkcija KBD_get_event() iz medpomnilnika tipkovnice prebere naslednji
+// dogodek (pritisk ali ponovitev tipke). Vrne 1, če je bil dogodek prebran,
+// in 0, če je medpomnilnik prazen. Ob branju zabeleži zakasnitev dogodka.
+//
+uint8_t KBD_get_event(kbd_event_t *event)
+{
+	if ( RING_read(&kbd_buf_handle, (uint8_t *) event, sizeof(kbd_event_t)) != BUFFER_OK )
+		return 0;
 
+	CYCLE_timer_add(&kbd_latency_timer, CYCLE_now() - event->timestamp);
+	return 1;
+}
 
 
 
@@ -291,54 +398,18 @@ buttons_enum_t KBD_get_pressed_button(void)
 	// Vidite, da vračamo vrednosti iz seznama naštevnega tipa "buttons_enum_t".
 
 
+	// Medpomnilnik hrani cele dogodke (kbd_event_t), zato naslednji dogodek
+	// preberemo s funkcijo KBD_get_event(), ki vrne 1, če je bilo branje uspešno.
+	// V nasprotnem primeru sklepamo, da je medpomnilnik prazen.
+	kbd_event_t event;
 
-	// Sedaj pa moramo iz medpomnilnika tipkovnice prebrati naslednji element,
-	// tj. informacijo o naslednji pritisnjeni tipki, ki je še nismo obdelali.
-	//
-	// To storimo z uporabo "buffer" funkcije
-	//
-	//		BUF_get_byte(buf_handle_t *buf_handle, uint8_t *data)
-	//
-	// Funkciji je potrebno posredovati naslov "handle" strukture za medpomnilnik
-	// (v našem primeru je to "&kbd_buf_handle") ter naslov spremenljivke,
-	// kamor naj se shrani vrednost prebranega elementa iz medpomnilnika (v našem primeru
-	// je to naslov pomožne spremenljivke "&pressed_button").
-	//
-	// Če funkcija BUF_get_byte() uspešno prebere element in medpomnilnika,
-	// bo vrnila vrednost BUFFER_OK.
-	// V nasprotnem primeru sklepamo, da je bilo branje elementa iz
-	// medpomnilnika neuspešno, ker je medpomnilnik prazen.
-
-	// Da bo postopek morda lažje razumljiv, si pripravimo še pomožno spremenljivko,
-	// kamor bomo shranili vrnjeno vrednost funkcije BUF_get_byte().
-	buf_rtrn_codes_t	return_code;
-
-
-
-	// Torej, poskusimo prebrati nov element iz medpomnilnika in ga shraniti v
-	// spremenljivko "pressed_button". Rezultat operacije shranimo v spremenljikvo "return_code".
-	return_code = BUF_get_byte(&kbd_buf_handle, &pressed_button);
-
-
-	// Če je bilo branje elementa iz medpomnilnika v spremenljivko "pressed_button"
-	// uspešno (rezultat operacije je BUFFER_OK),
-	if ( return_code == BUFFER_OK )
-	{
-		// potem je vrednost, ki jo mora funkcija KBD_get_pressed_button() vrniti,
-		// kar enaka vrednosti pomožne spremenljivke "pressed_button".
-
-		return pressed_button;
-	}
+	if ( KBD_get_event(&event) )
+		pressed_button = event.button;
 	else
-	{
+		pressed_button = BTN_NONE;
 
-		// Če pa je bilo branje elementa iz medpomnilnika v spremenljivko "pressed_button"
-		// neuspešno (tj. ni bil vrnjen BUFFER_OK), potem pa sklepamo, da je medpomnilnik
-		// prazen in da pravzaprav ni bila pritisnjena nobena nova tipka.
-		// Funkcija KBD_get_pressed_button() mora vrniti kodo "BTN_NONE".
 
-		return BTN_NONE;
-	}
+	return pressed_button;
 
 }
 
@@ -383,7 +454,7 @@ uint8_t KBD_is_button_state_pressed(buttons_enum_t button)
 // vso informacijo o morebitnih pritisnjenih tipkah, ki jih še nismo obdelali.
 void KBD_flush(void)
 {
-	BUF_flush(&kbd_buf_handle);
+	RING_flush(&kbd_buf_handle);
 }
 
 
@@ -392,7 +463,155 @@ void KBD_flush(void)
 // da preveri velikost podatkov, ki jih hrani medpomnilnik tipkovnice.
 uint8_t KBD_any_button_been_pressed(void)
 {
-	return ( BUF_get_data_size( &kbd_buf_handle ) );
+	return ( RING_get_data_size( &kbd_buf_handle ) / sizeof(kbd_event_t) );
+}
+
+
+
+
+// Funkcija KBD_is_idle() vrne 1, ko tipkovnica ne čaka na konec odskakovanja
+// ali ponavljanja (TIM7 miruje). Takrat lahko pritisk zazna le še EXTI prekinitev,
+// zato sme idle.c procesor postaviti v Stop način.
+uint8_t KBD_is_idle(void)
+{
+#if KBD_USE_EXTI
+	return !LL_TIM_IsEnabledCounter(keyboard.debounce_timer);
+#else
+	return 0;
+#endif
+}
+
+
+
+
+// Funkcija KBD_get_hold_time_ms() vrne, koliko milisekund je tipka že stisnjena,
+// oziroma koliko časa je bila stisnjena ob zadnjem pritisku, če je že sproščena.
+uint32_t KBD_get_hold_time_ms(buttons_enum_t button)
+{
+	button_handle_t *b = &keyboard.buttons[button];
+
+	if ( b->state == BTN_PRESSED_SIGNAL_STATE )
+		return HAL_GetTick() - b->pressed_ms;
+	else
+		return b->released_ms - b->pressed_ms;
+}
+
+
+
+
+// Funkcija KBD_inject_press() doda pritisk tipke, ki ga ni sprožila tipka sama
+// (npr. odklon "joysticka" kot LEFT/RIGHT). Kliče jo lahko ena sama prekinitev.
+// Medpomnilnik tipkovnice mora ostati z enim samim "producerjem":
+//	- pri KBD_USE_EXTI = 1 ga pišejo prekinitve s prioriteto 13 (EXTI, TIM7),
+//	  zato ga sme pisati tudi klicatelj s to prioriteto;
+//	- pri KBD_USE_EXTI = 0 ga piše KBD_scan() iz TIM6 (prioriteta 14), ki bi ga
+//	  klicatelj lahko prekinil sredi zapisa, zato pritisk le preštejemo, shrani
+//	  pa ga šele naslednji KBD_scan().
+void KBD_inject_press(buttons_enum_t button)
+{
+#if KBD_USE_EXTI
+	KBD_put_event(button, KBD_EVENT_PRESS, CYCLE_now());
+#else
+	keyboard.injected[button]++;
+#endif
+}
+
+
+
+
+// ------- Prekinitve -------
+
+
+// Funkcijo KBD_EXTI_Callback() kličejo EXTI prekinitvene rutine v stm32g4xx_it.c,
+// ko se spremeni signal tipke na liniji "exti_line".
+//
+// Prvo spremembo signala takoj upoštevamo, nato pa linijo za KBD_DEBOUNCE_MS
+// onemogočimo, da odskoki kontaktov ne sprožajo novih prekinitev. Po izteku okna
+// KBD_debounce_timer_Callback() signal ponovno prebere.
+void KBD_EXTI_Callback(uint32_t exti_line)
+{
+	uint32_t timestamp = CYCLE_now();
+
+	for(int i=0; i < NUM_OF_BTNS; i++)
+	{
+		button_handle_t *b = &keyboard.buttons[i];
+
+		if ( b->exti_line != exti_line )
+			continue;
+
+		if ( b->debounce_ms == 0 )
+		{
+			button_sig_state_t state = LL_GPIO_IsInputPinSet(b->port, b->pin);
+
+			// Če se signal do branja že vrne na staro vrednost (odskok), novo
+			// stanje prebere šele časovnik ob koncu okna.
+			if ( state != b->state )
+				KBD_set_state(i, state, timestamp);
+		}
+
+		LL_EXTI_DisableIT_0_31(exti_line);
+		b->debounce_ms = KBD_DEBOUNCE_MS;
+		LL_TIM_EnableCounter(keyboard.debounce_timer);
+	}
+}
+
+
+
+
+// Funkcijo KBD_debounce_timer_Callback() kliče prekinitev časovnika TIM7 vsako
+// milisekundo, dokler je kakšna tipka v oknu odskakovanja ali se ponavlja.
+void KBD_debounce_timer_Callback(void)
+{
+	uint8_t active = 0;
+
+	for(int i=0; i < NUM_OF_BTNS; i++)
+	{
+		button_handle_t *b = &keyboard.buttons[i];
+
+		// Okno odskakovanja
+		if ( b->debounce_ms != 0 )
+		{
+			if ( --b->debounce_ms == 0 )
+			{
+				button_sig_state_t state = LL_GPIO_IsInputPinSet(b->port, b->pin);
+
+				if ( state != b->state )
+				{
+					// Signal se je med oknom spremenil: novo stanje in novo okno.
+					KBD_set_state(i, state, CYCLE_now());
+					b->debounce_ms = KBD_DEBOUNCE_MS;
+				}
+				else
+				{
+					// Signal je stabilen: ponovno omogočimo prekinitev. Če se je signal
+					// spremenil tik pred tem, prekinitev sprožimo programsko.
+					LL_EXTI_ClearFlag_0_31(b->exti_line);
+					LL_EXTI_EnableIT_0_31(b->exti_line);
+
+					if ( LL_GPIO_IsInputPinSet(b->port, b->pin) != b->state )
+						LL_EXTI_GenerateSWI_0_31(b->exti_line);
+				}
+			}
+		}
+
+		// Samodejno ponavljanje držane tipke
+		if ( b->repeat && ( b->state == BTN_PRESSED_SIGNAL_STATE ) )
+		{
+			if ( --b->repeat_ms == 0 )
+			{
+				KBD_put_event(i, KBD_EVENT_REPEAT, CYCLE_now());
+				b->repeat_ms = KBD_REPEAT_PERIOD_MS;
+			}
+			active = 1;
+		}
+
+		if ( b->debounce_ms != 0 )
+			active = 1;
+	}
+
+	// Ko se tipk nihče ne dotika, časovnik ustavimo.
+	if ( !active )
+		LL_TIM_DisableCounter(keyboard.debounce_timer);
 }
 
 
@@ -572,3 +791,37 @@ void KBD_demo_toggle_LEDs_if_buttons_pressed(void)
 // -------------- Private function implementations -------------
 
 
+// Shrani novo stanje tipke. Pritisk shrani v medpomnilnik tipkovnice, sprostitev
+// le zabeleži čas sprostitve.
+static void KBD_set_state(buttons_enum_t button, button_sig_state_t state, uint32_t timestamp)
+{
+	button_handle_t *b = &keyboard.buttons[button];
+
+	b->state = state;
+
+	if ( state == BTN_PRESSED_SIGNAL_STATE )
+	{
+		b->pressed_ms = HAL_GetTick();
+		b->repeat_ms = KBD_REPEAT_DELAY_MS;
+		KBD_put_event(button, KBD_EVENT_PRESS, timestamp);
+	}
+	else
+	{
+		b->released_ms = HAL_GetTick();
+	}
+}
+
+
+
+
+// Shrani dogodek v medpomnilnik tipkovnice in zbudi opravila, ki čakajo na tipke.
+// Če je medpomnilnik poln, se dogodek zavrže.
+static void KBD_put_event(buttons_enum_t button, kbd_event_type_t type, uint32_t timestamp)
+{
+	kbd_event_t event = { timestamp, button, type, 0 };
+
+	if ( RING_write(&kbd_buf_handle, (uint8_t *) &event, sizeof(event)) == BUFFER_OK )
+		SCHED_publish(SCHED_SIG_KEY, KBD_EVENT_PARAM(type, button));
+}
+
+
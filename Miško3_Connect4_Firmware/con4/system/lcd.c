@@ -18,7 +18,7 @@
 
 #include "lcd.h"
 
-#include "SCI.h"
+#include "console.h"
 
 
 
@@ -34,7 +34,10 @@ UG_GUI gui;
 // ------------------ Privatni prototipi funkcij ------------------------------
 
 void UserPixelSetFunction(UG_S16 x, UG_S16 y, UG_COLOR c);
-UG_RESULT _HW_FillFrame_(UG_S16 x, UG_S16 y, UG_S16 w, UG_S16 h, UG_COLOR c);
+UG_RESULT _HW_FillFrame_(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR c);
+void* _HW_FillArea_(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2);
+static void LCD_StatsPrint(void);
+static void LCD_StatsReset(void);
 
 
 
@@ -115,6 +118,9 @@ void LCD_Init()
 
 	LCD_BKLT_init();
 
+	// Stroške izrisa izpišemo na zahtevo prek SCI vmesnika.
+	CONSOLE_register('s', LCD_StatsPrint, "render stats CSV");
+	CONSOLE_register('r', LCD_StatsReset, "reset render stats");
 }
 
 
@@ -132,6 +138,26 @@ void LCD_ClearScreen()
 
 
 
+/*!
+ * @brief Izpiši števce področij izrisa v CSV obliki (ukaz 's', console.c)
+ */
+static void LCD_StatsPrint(void)
+{
+	ILI9341_StatsPrintCSV();
+}
+
+
+/*!
+ * @brief Ponastavi števce področij izrisa (ukaz 'r', console.c)
+ */
+static void LCD_StatsReset(void)
+{
+	ILI9341_StatsReset();
+}
+
+
+
+
 // ------------------ Testne demo funkcije ----------------
 
 
@@ -184,15 +210,170 @@ void UserPixelSetFunction(UG_S16 x, UG_S16 y, UG_COLOR c)
 
 
 // Implementacija funkcije za izris pravokotnika na zaslon.
-UG_RESULT _HW_FillFrame_(UG_S16 x, UG_S16 y, UG_S16 w, UG_S16 h, UG_COLOR c)
+// uGUI poda koordinate obeh vogalov (x1,y1) in (x2,y2), ne širine in višine.
+UG_RESULT _HW_FillFrame_(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR c)
 {
-	LCD_FillRect(x, y, w, h, c);
+	LCD_FillRect(x1, y1, x2 - x1 + 1, y2 - y1 + 1, c);
 
 	return UG_RESULT_OK;
 }
 
 
 
+// ------ Strojno pospešen izris znakov -------
+
+
+#if LCD_GLYPH_CACHE_SIZE > 0
+
+// Vnos v predpomnilniku že izrisanih znakov. Znak je shranjen kot
+// pravokotnik slikovnih točk, ki ga lahko naenkrat pošljemo v GRAM.
+typedef struct
+{
+	const unsigned char *font;		// ključ: font, znak in obe barvi
+	char chr;
+	UG_COLOR fc;
+	UG_COLOR bc;
+	uint16_t w;
+	uint16_t h;
+	uint32_t last_use;				// za zamenjavo najdlje neuporabljenega vnosa
+	uint16_t pixels[LCD_GLYPH_MAX_PIXELS];
+} LCD_Glyph_t;
+
+static LCD_Glyph_t glyph_cache[LCD_GLYPH_CACHE_SIZE];
+static uint32_t glyph_use_counter;
+
+// Kadar ni NULL, _HW_FillArea_ ne piše na zaslon, ampak v ta vnos.
+static LCD_Glyph_t *glyph_capture;
+static uint32_t glyph_capture_count;
+
+
+// Zapis ene točke v vnos predpomnilnika, ki se trenutno izrisuje.
+static void _Glyph_PushPixel_(UG_COLOR c)
+{
+	if (glyph_capture_count < LCD_GLYPH_MAX_PIXELS)
+		glyph_capture->pixels[glyph_capture_count++] = c;
+}
+
+#endif
+
+
+// Zapis ene točke v že odprto okno grafičnega pomnilnika.
+static void _HW_PushPixel_(UG_COLOR c)
+{
+	ILI9341_SendData((LCD_IO_Data_t *)&c, 1);
+}
+
+
+// Implementacija DRIVER_FILL_AREA: odpre okno (x1,y1)-(x2,y2) in vrne
+// funkcijo, s katero uGUI zaporedno pošlje vse točke okna. Okno se tako
+// nastavi enkrat na znak namesto enkrat na vsako točko.
+void* _HW_FillArea_(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2)
+{
+#if LCD_GLYPH_CACHE_SIZE > 0
+	if (glyph_capture != NULL)
+	{
+		glyph_capture->w = x2 - x1 + 1;
+		glyph_capture->h = y2 - y1 + 1;
+		glyph_capture_count = 0;
+		return (void *)_Glyph_PushPixel_;
+	}
+#endif
+
+	ILI9341_SetDisplayWindow(x1, y1, x2 - x1 + 1, y2 - y1 + 1);
+	return (void *)_HW_PushPixel_;
+}
+
+
+#if LCD_GLYPH_CACHE_SIZE > 0
+
+// Poišči znak v predpomnilniku. Ob zgrešitvi ga uGUI izriše v najdlje
+// neuporabljen vnos. Vrne NULL, če znak ne gre v vnos.
+static LCD_Glyph_t* LCD_GetGlyph(char chr, UG_COLOR fc, UG_COLOR bc)
+{
+	LCD_Glyph_t *victim = &glyph_cache[0];
+	uint16_t w = gui.font.widths ? gui.font.widths[chr - gui.font.start_char] : gui.font.char_width;
+
+	if ((uint32_t)w * gui.font.char_height > LCD_GLYPH_MAX_PIXELS)
+		return NULL;
+
+	glyph_use_counter++;
+
+	for (uint32_t i = 0; i < LCD_GLYPH_CACHE_SIZE; i++)
+	{
+		LCD_Glyph_t *g = &glyph_cache[i];
+
+		if (g->font == gui.font.p && g->chr == chr && g->fc == fc && g->bc == bc)
+		{
+			g->last_use = glyph_use_counter;
+			return g;
+		}
+		if (g->last_use < victim->last_use)
+			victim = g;
+	}
+
+	// Znak izriše uGUI, točke pa prestrežemo v _Glyph_PushPixel_.
+	glyph_capture = victim;
+	UG_PutChar(chr, 0, 0, fc, bc);
+	glyph_capture = NULL;
+
+	victim->font = gui.font.p;
+	victim->chr = chr;
+	victim->fc = fc;
+	victim->bc = bc;
+	victim->last_use = glyph_use_counter;
+
+	return victim;
+}
+
+#endif
+
+
+/*!
+ * @brief Izpis niza z izbranim fontom in barvami uGUI
+ * @param x x koordinata začetka niza
+ * @param y y koordinata začetka niza
+ * @param str niz, ki ga izpišemo
+ *
+ * Razporeditev znakov je enaka kot pri UG_PutString(). Če je vklopljen
+ * predpomnilnik znakov (LCD_GLYPH_CACHE_SIZE > 0), se vsak znak pošlje
+ * v GRAM kot celota, sicer pa prek DRIVER_FILL_AREA.
+ */
+void LCD_PutString(int16_t x, int16_t y, const char *str)
+{
+	int16_t xp = x, yp = y;
+	uint8_t cw;
+	char chr;
+
+	while (*str != 0)
+	{
+		chr = *str++;
+		if (chr < gui.font.start_char || chr > gui.font.end_char) continue;
+
+		cw = gui.font.widths ? gui.font.widths[chr - gui.font.start_char] : gui.font.char_width;
+
+		if (xp + cw > gui.x_dim - 1)
+		{
+			xp = x;
+			yp += gui.font.char_height + gui.char_v_space;
+		}
+
+#if LCD_GLYPH_CACHE_SIZE > 0
+		LCD_Glyph_t *g = LCD_GetGlyph(chr, gui.fore_color, gui.back_color);
+		if (g != NULL)
+		{
+			ILI9341_SetDisplayWindow(xp, yp, g->w, g->h);
+			ILI9341_SendData((LCD_IO_Data_t *)g->pixels, g->w * g->h);
+		}
+		else
+#endif
+			UG_PutChar(chr, xp, yp, gui.fore_color, gui.back_color);
+
+		xp += cw + gui.char_h_space;
+	}
+}
+
+
+
 // ------------ Inicializacija uGUI za delo z našim zaslonom -------------------
 
 
@@ -211,6 +392,10 @@ void LCD_uGUI_init(void)
 	// Registracija funkcij za izris pravokotnika.
 	UG_DriverRegister(DRIVER_FILL_FRAME, (void *)_HW_FillFrame_);
 	UG_DriverEnable(DRIVER_FILL_FRAME);
+
+	// Registracija funkcije za izris znakov v odprto okno.
+	UG_DriverRegister(DRIVER_FILL_AREA, (void *)_HW_FillArea_);
+	UG_DriverEnable(DRIVER_FILL_AREA);
 }
 
 
@@ -6,6 +6,11 @@
 
 #include "lcd_ili9341.h"
 
+#if ILI9341_RENDER_STATS
+#include <stdio.h>
+#include "cycle_timer.h"
+#endif
+
 //! @brief Tabela orientacij. Izbrano vrednost se pošlje na naslov "Memory Data Access Control".
 static uint32_t orientations[4] = {
 	0x00U, /* Portrait orientation choice of LCD screen               */
@@ -21,6 +26,33 @@ static struct LCD_Attributes {
 	uint32_t orientation;
 } LCD;
 
+#if ILI9341_RENDER_STATS
+//! @brief Tekoči števci od zagona; področja si zapomnijo stanje ob začetku
+static struct {
+	uint32_t windows;
+	uint32_t pio_pixels;
+	uint32_t dma_pixels;
+} stats;
+
+//! @brief Posnetek števcev ob začetku odprtega področja
+typedef struct {
+	ILI9341_Scope_t *scope;
+	uint32_t windows;
+	uint32_t pio_pixels;
+	uint32_t dma_pixels;
+	uint32_t start_cycles;
+} ILI9341_ScopeMark_t;
+
+static ILI9341_Scope_t scopes[ILI9341_STATS_MAX_SCOPES];
+static uint32_t scope_count;
+static ILI9341_ScopeMark_t scope_stack[ILI9341_STATS_MAX_DEPTH];
+static uint32_t scope_depth;
+
+#define STATS_ADD(counter, n)	(stats.counter += (n))
+#else
+#define STATS_ADD(counter, n)
+#endif
+
 /*!
  * @brief Nastavi spominski naslov enote FSMC
  * @param address želen naslov
@@ -58,6 +90,16 @@ static inline uint16_t FMC_BANK1_ReadData(void)
 	return *(LCD_IO_Data_t *)(FMC_BANK1_MEM);
 }
 
+/*!
+ * @brief Piši parametre ukaza; se ne šteje med poslane piksle
+ * @internal
+ */
+static inline void ILI9341_SendParameters(ILI9341_Data_t *parameter, uint32_t length)
+{
+	for (uint32_t i = 0; i < length; i++)
+		FMC_BANK1_WriteData(parameter[i]);
+}
+
 /*!
  * @brief Podaj spominski naslov LCD krmilniku
  * @param *address *naslov* spremenljivke, v kateri je zapisan ukaz (register)
@@ -77,6 +119,8 @@ void ILI9341_SendData(LCD_IO_Data_t *data, uint32_t length)
 {
 	uint8_t increment = LCD_IO_DATA_WRITE_CYCLES;
 
+	STATS_ADD(pio_pixels, length);
+
 	for (uint32_t i = 0; i < (length/increment); i += increment)
 		FMC_BANK1_WriteData(data[i]);
 }
@@ -90,6 +134,8 @@ void ILI9341_SendRepeatedData(LCD_IO_Data_t data, uint32_t num_copies)
 {
 	uint8_t increment = LCD_IO_DATA_WRITE_CYCLES;
 
+	STATS_ADD(pio_pixels, num_copies);
+
 	for (uint32_t i = 0; i < (num_copies/increment); i += increment)
 		FMC_BANK1_WriteData(data);
 }
@@ -122,9 +168,26 @@ int32_t ILI9341_SendDataDMA(LCD_IO_Data_t *data, uint32_t length)
     return 1;
   }
 
+  STATS_ADD(dma_pixels, length);
+
   return 0;
 }
 
+/*!
+  * @brief  Ali DMA prenos v GRAM še poteka
+  * @return 1, če prenos še ni končan, sicer 0
+  */
+uint8_t ILI9341_IsDMABusy()
+{
+	return HAL_DMA_GetState(&hLCDDMA) == HAL_DMA_STATE_BUSY;
+}
+
+//! @brief Počakaj, da se DMA prenos v GRAM zaključi
+void ILI9341_WaitDMA()
+{
+	while (ILI9341_IsDMABusy());
+}
+
 /*!
  * @brief Preberi podatek iz naslova grafičnega pomnilnika (GRAM)
  * @param *address *naslov* tabele, kamor se bodo zapisali podatki
@@ -178,6 +241,8 @@ void ILI9341_SetDisplayWindow(uint32_t Xpos, uint32_t Ypos, uint32_t Width, uint
 	ILI9341_Data_t command;
 	ILI9341_Data_t parameter[4];
 
+	STATS_ADD(windows, 1);
+
 	/* Column addr set, 4 args, no delay: XSTART = Xpos, XEND = (Xpos + Width - 1) */
 	command = ILI9341_CASET;
 	parameter[0] = (ILI9341_Data_t)(Xpos >> 8U);
@@ -185,7 +250,7 @@ void ILI9341_SetDisplayWindow(uint32_t Xpos, uint32_t Ypos, uint32_t Width, uint
 	parameter[2] = (ILI9341_Data_t)((Xpos + Width - 1U) >> 8U);
 	parameter[3] = (ILI9341_Data_t)((Xpos + Width - 1U) & 0xFFU);
 	ILI9341_SetAddress(&command);
-	ILI9341_SendData(parameter, 4);
+	ILI9341_SendParameters(parameter, 4);
 
 	/* Row addr set, 4 args, no delay: YSTART = Ypos, YEND = (Ypos + Height - 1) */
 	command = ILI9341_RASET;
@@ -194,7 +259,7 @@ void ILI9341_SetDisplayWindow(uint32_t Xpos, uint32_t Ypos, uint32_t Width, uint
 	parameter [2] = (ILI9341_Data_t)((Ypos + Height - 1U) >> 8U);
 	parameter [3] = (ILI9341_Data_t)((Ypos + Height - 1U) & 0xFFU);
 	ILI9341_SetAddress(&command);
-	ILI9341_SendData(parameter, 4);
+	ILI9341_SendParameters(parameter, 4);
 
 	// Zapusti nastavitev okna v načinu za vpis barve v GRAM
 	command = ILI9341_GRAM;
@@ -212,6 +277,8 @@ void ILI9341_Init(uint32_t color_space, uint32_t orientation)
 	ILI9341_Data_t command;
 	ILI9341_Data_t parameter[5];
 
+	ILI9341_StatsReset();
+
 	ILI9341_SetOrientation(orientation);
 	ILI9341_SetDisplayWindow(0U, 0U, LCD.width, LCD.height);
 
@@ -373,3 +440,119 @@ uint32_t ILI9341_GetParam(LCD_Param_t param)
 
 	return value;
 }
+
+
+
+// ----------------------- Merjenje stroškov izrisa -----------------------
+
+#if ILI9341_RENDER_STATS
+
+/*!
+ * @brief Ponastavi vse števce in omogoči DWT števec ciklov
+ */
+void ILI9341_StatsReset(void)
+{
+	CYCLE_init();
+
+	for (uint32_t i = 0; i < scope_count; i++) {
+		const char *name = scopes[i].name;
+		scopes[i] = (ILI9341_Scope_t){ .name = name };
+	}
+	scope_depth = 0;
+}
+
+/*!
+ * @brief Začni meriti poimenovano področje izrisa
+ * @param name ime področja; kazalec mora ostati veljaven (niz v flash)
+ *
+ * Področja se lahko gnezdijo; števci notranjega se prištejejo tudi zunanjemu.
+ */
+void ILI9341_StatsScopeBegin(const char *name)
+{
+	ILI9341_Scope_t *scope = NULL;
+
+	if (scope_depth >= ILI9341_STATS_MAX_DEPTH)
+		return;
+
+	for (uint32_t i = 0; i < scope_count; i++) {
+		if (scopes[i].name == name) {
+			scope = &scopes[i];
+			break;
+		}
+	}
+	if (scope == NULL && scope_count < ILI9341_STATS_MAX_SCOPES) {
+		scope = &scopes[scope_count++];
+		scope->name = name;
+	}
+
+	ILI9341_ScopeMark_t *mark = &scope_stack[scope_depth++];
+	mark->scope = scope;
+	mark->windows = stats.windows;
+	mark->pio_pixels = stats.pio_pixels;
+	mark->dma_pixels = stats.dma_pixels;
+	mark->start_cycles = CYCLE_now();
+}
+
+/*!
+ * @brief Zaključi nazadnje odprto področje in prištej njegove stroške
+ */
+void ILI9341_StatsScopeEnd(void)
+{
+	uint32_t now = CYCLE_now();
+
+	if (scope_depth == 0)
+		return;
+
+	ILI9341_ScopeMark_t *mark = &scope_stack[--scope_depth];
+	ILI9341_Scope_t *scope = mark->scope;
+	uint32_t cycles = now - mark->start_cycles;
+
+	// Tabela področij je polna
+	if (scope == NULL)
+		return;
+
+	scope->calls++;
+	scope->windows += stats.windows - mark->windows;
+	scope->pio_pixels += stats.pio_pixels - mark->pio_pixels;
+	scope->dma_pixels += stats.dma_pixels - mark->dma_pixels;
+	scope->cycles += cycles;
+	if (cycles > scope->max_cycles)
+		scope->max_cycles = cycles;
+}
+
+//! @brief Število do sedaj zabeleženih področij
+uint32_t ILI9341_StatsGetScopeCount(void)
+{
+	return scope_count;
+}
+
+//! @brief Števci področja z indeksom `index', NULL če ne obstaja
+const ILI9341_Scope_t* ILI9341_StatsGetScope(uint32_t index)
+{
+	return (index < scope_count) ? &scopes[index] : NULL;
+}
+
+/*!
+ * @brief Izpiši števce vseh področij v CSV obliki na standardni izhod (SCI)
+ *
+ * Ena vrstica na področje; časi so v mikrosekundah (cycle_timer.c).
+ */
+void ILI9341_StatsPrintCSV(void)
+{
+	uint32_t cycles_per_us = CYCLE_hz() / 1000000;
+
+	printf("scope,calls,windows,pio_pixels,dma_pixels,total_us,avg_us,max_us\n");
+	for (uint32_t i = 0; i < scope_count; i++) {
+		const ILI9341_Scope_t *s = &scopes[i];
+		uint32_t total_us = (uint32_t)(s->cycles / cycles_per_us);
+
+		printf("%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", s->name,
+				(unsigned long)s->calls, (unsigned long)s->windows,
+				(unsigned long)s->pio_pixels, (unsigned long)s->dma_pixels,
+				(unsigned long)total_us,
+				(unsigned long)(s->calls ? total_us / s->calls : 0),
+				(unsigned long)(s->max_cycles / cycles_per_us));
+	}
+}
+
+#endif
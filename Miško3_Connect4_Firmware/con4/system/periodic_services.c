@@ -9,6 +9,7 @@
 #include "periodic_services.h"
 #include "kbd.h"
 #include "LED.h"
+#include "scheduler.h"
 
 
 
@@ -51,7 +52,13 @@ void PSERV_disable(void)
 
 void PSERV_run_services_Callback(void)
 {
+	// Tipke s prekinitvami (KBD_USE_EXTI) same objavijo SCHED_SIG_KEY, zato
+	// jih tu beremo le pri periodičnem branju tipkovnice.
+#if !KBD_USE_EXTI
 	KBD_scan();
+#endif
+
+	SCHED_tick_Callback();
 
 	//KBD_demo_toggle_LEDs_if_buttons_pressed();
 }
@@ -0,0 +1,222 @@
+/*
+ * ring.c
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+/* **************** MODULE DESCRIPTION *************************
+
+Lock-free single-producer single-consumer (SPSC) ring buffer. It is meant
+for byte streams shared between one interrupt routine and the main loop,
+e.g. the SCI RX/TX buffers and the keyboard buffer.
+
+Operation:
+The buffer length must be a power of two. "head" counts all bytes ever
+written and "tail" all bytes ever read; both run freely and wrap at 2^32.
+The array index is obtained by masking with (length - 1).
+Data size: head - tail. Empty: head == tail. Full: head - tail == length,
+so, unlike buf.c, the whole array can be used.
+
+Only the producer writes "head" and only the consumer writes "tail".
+The producer first stores the data and then publishes the new head with
+release semantics; the consumer loads head with acquire semantics before
+it touches the data (and vice versa for tail). On the Cortex-M4 this
+compiles to a DMB, so it is also correct with the write buffer and with
+DMA or a second bus master reading the array.
+
+Bulk operations copy in at most two contiguous memcpy() segments. The
+peek/commit functions give direct access to the contiguous part of the
+buffer, so data can be produced or consumed in place without a copy.
+
+************************************************************* */
+
+
+
+
+// ----------- Include other modules (for private) -------------
+
+#include <string.h>
+
+#include "ring.h"
+
+
+// ---------------------- Private definitions ------------------
+
+#define RING_LOAD_ACQUIRE(x)		__atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define RING_STORE_RELEASE(x, v)	__atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+
+#define RING_MIN(a, b)				( (a) < (b) ? (a) : (b) )
+
+
+
+
+// -------------- Public function implementations --------------
+
+
+// Initialize the ring. buf_length should be a power of two; any other length is rounded
+// down to the nearest power of two, so the extra bytes of the array are left unused.
+void RING_init(ring_handle_t *ring, uint8_t *buffer_ptr, uint32_t buf_length)
+{
+	uint32_t length = 1;
+
+	while ( length * 2 <= buf_length && length * 2 != 0 )
+		length *= 2;
+
+	ring->buffer = buffer_ptr;
+	ring->mask = length - 1;
+	ring->head = 0;
+	ring->tail = 0;
+}
+
+
+// Discard all data in the buffer. Must be called from the consumer side.
+buf_rtrn_codes_t RING_flush(ring_handle_t *ring)
+{
+	RING_STORE_RELEASE(ring->tail, RING_LOAD_ACQUIRE(ring->head));
+
+	return BUFFER_OK;
+}
+
+
+
+
+// ------ Producer side -------
+
+
+// Store one byte of data.
+buf_rtrn_codes_t RING_put(ring_handle_t *ring, uint8_t data)
+{
+	uint32_t head = ring->head;
+
+	if ( head - RING_LOAD_ACQUIRE(ring->tail) > ring->mask )
+		return BUFFER_FULL;
+
+	ring->buffer[head & ring->mask] = data;
+	RING_STORE_RELEASE(ring->head, head + 1);
+
+	return BUFFER_OK;
+}
+
+
+// Store "size" bytes, either all of them or none.
+buf_rtrn_codes_t RING_write(ring_handle_t *ring, const uint8_t *data, uint32_t size)
+{
+	uint32_t head = ring->head;
+	uint32_t space = ring->mask + 1 - (head - RING_LOAD_ACQUIRE(ring->tail));
+
+	if ( size > space )
+		return BUFFER_NOT_ENOUGH_SPACE;
+
+	// First segment up to the end of the array, the rest wraps to the beginning.
+	uint32_t index = head & ring->mask;
+	uint32_t first = RING_MIN(size, ring->mask + 1 - index);
+
+	memcpy(&ring->buffer[index], data, first);
+	memcpy(ring->buffer, data + first, size - first);
+
+	RING_STORE_RELEASE(ring->head, head + size);
+
+	return BUFFER_OK;
+}
+
+
+// Zero-copy write: returns the number of contiguous free bytes and sets *data to the
+// first of them. Write into that space and then publish it with RING_commit_write().
+uint32_t RING_peek_write(ring_handle_t *ring, uint8_t **data)
+{
+	uint32_t head = ring->head;
+	uint32_t space = ring->mask + 1 - (head - RING_LOAD_ACQUIRE(ring->tail));
+	uint32_t index = head & ring->mask;
+
+	*data = &ring->buffer[index];
+
+	return RING_MIN(space, ring->mask + 1 - index);
+}
+
+
+// Publish "size" bytes written in place after RING_peek_write().
+void RING_commit_write(ring_handle_t *ring, uint32_t size)
+{
+	RING_STORE_RELEASE(ring->head, ring->head + size);
+}
+
+
+
+
+// ------ Consumer side -------
+
+
+// Read one byte of data and store it to the given location.
+buf_rtrn_codes_t RING_get(ring_handle_t *ring, uint8_t *data)
+{
+	uint32_t tail = ring->tail;
+
+	if ( RING_LOAD_ACQUIRE(ring->head) == tail )
+		return BUFFER_EMPTY;
+
+	*data = ring->buffer[tail & ring->mask];
+	RING_STORE_RELEASE(ring->tail, tail + 1);
+
+	return BUFFER_OK;
+}
+
+
+// Read "size" bytes, either all of them or none.
+buf_rtrn_codes_t RING_read(ring_handle_t *ring, uint8_t *data, uint32_t size)
+{
+	uint32_t tail = ring->tail;
+	uint32_t available = RING_LOAD_ACQUIRE(ring->head) - tail;
+
+	if ( size > available )
+		return BUFFER_NOT_ENOUGH_DATA;
+
+	uint32_t index = tail & ring->mask;
+	uint32_t first = RING_MIN(size, ring->mask + 1 - index);
+
+	memcpy(data, &ring->buffer[index], first);
+	memcpy(data + first, ring->buffer, size - first);
+
+	RING_STORE_RELEASE(ring->tail, tail + size);
+
+	return BUFFER_OK;
+}
+
+
+// Zero-copy read: returns the number of contiguous bytes available and sets *data to the
+// first of them. Release the bytes that were used with RING_commit_read().
+uint32_t RING_peek_read(ring_handle_t *ring, const uint8_t **data)
+{
+	uint32_t tail = ring->tail;
+	uint32_t available = RING_LOAD_ACQUIRE(ring->head) - tail;
+	uint32_t index = tail & ring->mask;
+
+	*data = &ring->buffer[index];
+
+	return RING_MIN(available, ring->mask + 1 - index);
+}
+
+
+// Release "size" bytes consumed in place after RING_peek_read().
+void RING_commit_read(ring_handle_t *ring, uint32_t size)
+{
+	RING_STORE_RELEASE(ring->tail, ring->tail + size);
+}
+
+
+
+
+// ------ Either side -------
+
+
+// Get the number of bytes currently in the buffer.
+uint32_t RING_get_data_size(ring_handle_t *ring)
+{
+	return RING_LOAD_ACQUIRE(ring->head) - RING_LOAD_ACQUIRE(ring->tail);
+}
+
+
+// Get the size of the free space in the buffer in bytes.
+uint32_t RING_get_free_size(ring_handle_t *ring)
+{
+	return ring->mask + 1 - RING_get_data_size(ring);
+}
@@ -0,0 +1,418 @@
+/*
+ * scheduler.c
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+
+/* **************** MODULE DESCRIPTION *************************
+
+Ta modul implementira preprost razvrščevalnik opravil (angl. cooperative
+run-to-completion scheduler), ki nadomesti neskončno zanko s stalnim
+preverjanjem stanj.
+
+Vsako opravilo ima svojo vrsto dogodkov. Razvrščevalnik vedno izbere
+opravilo z najvišjo prioriteto (prej dodano opravilo ima višjo
+prioriteto), ki ima v vrsti vsaj en dogodek, in pokliče njegovo funkcijo
+z enim dogodkom. Funkcija dogodek obdela in se vrne; opravil se ne
+prekinja. Ko nobeno opravilo nima dela, razvrščevalnik pokliče
+IDLE_enter() (idle.c) s časom do naslednjega časovnika, ki izbere
+Sleep ali Stop način in čaka, dokler procesorja ne zbudi prekinitev.
+
+Dogodke ustvarjajo:
+	- opravila sama (SCHED_post(), SCHED_publish()),
+	- prekinitve (npr. pritisk tipke v periodic_services.c),
+	- programski časovniki, ki jih z milisekundno ločljivostjo osvežuje
+	  SCHED_tick_Callback(), klicana iz TIM6 prekinitve.
+
+Časovnik, označen s SCHED_timer_set_deferrable(), ne šteje pri izračunu
+naslednjega bujenja: v Stop načinu zamuja, dokler procesorja ne zbudi
+kaj drugega (primerno za periodične servisne naloge).
+
+Za vsako opravilo se beležijo število izvajanj, čas izvajanja (DWT števec
+ciklov), največja zasedenost vrste in izgubljeni dogodki.
+
+************************************************************* */
+
+
+
+
+// ----------- Include other modules (for private) -------------
+
+#include <stdio.h>
+
+#include "scheduler.h"
+#include "cycle_timer.h"
+#include "idle.h"
+#include "console.h"
+#include "stm32g4xx_hal.h"
+
+
+// ---------------------- Private definitions ------------------
+
+#if (SCHED_QUEUE_LEN & (SCHED_QUEUE_LEN - 1)) != 0
+#error "SCHED_QUEUE_LEN must be a power of two"
+#endif
+
+typedef struct
+{
+	SCHED_handler_t handler;
+	SCHED_event_t queue[SCHED_QUEUE_LEN];
+	uint32_t head;						// free-running indeksa, kot v ring.c
+	uint32_t tail;
+	SCHED_task_stats_t stats;
+
+} SCHED_task_handle_t;
+
+typedef struct
+{
+	uint8_t used;
+	uint8_t active;
+	uint8_t deferrable;					// 1 = ne zbudi procesorja iz Stop načina
+	SCHED_task_t task;
+	uint16_t signal;
+	uint32_t remaining_ms;
+	uint32_t period_ms;					// 0 = enkratni časovnik
+
+} SCHED_timer_handle_t;
+
+typedef struct
+{
+	SCHED_task_t task;
+	uint16_t signal;
+
+} SCHED_subscription_t;
+
+static SCHED_task_handle_t tasks[SCHED_MAX_TASKS];
+static uint32_t task_count;
+static volatile uint32_t ready_mask;	// bit n: opravilo n ima dogodke v vrsti
+
+static SCHED_timer_handle_t timers[SCHED_MAX_TIMERS];
+static uint32_t last_tick_ms;
+
+static SCHED_subscription_t subscriptions[SCHED_MAX_SUBSCRIBERS];
+static uint32_t subscription_count;
+
+static uint32_t stats_start_ms;			// začetek obdobja statistike
+
+
+
+
+// -------------- Private function implementations -------------
+
+
+// Vzame naslednji dogodek opravila z najvišjo prioriteto. Vrne 0, če dela ni.
+static uint8_t SCHED_next_event(SCHED_task_t *task, SCHED_event_t *event)
+{
+	uint32_t primask = __get_PRIMASK();
+	SCHED_task_handle_t *t;
+
+	__disable_irq();
+
+	if ( ready_mask == 0 )
+	{
+		__set_PRIMASK(primask);
+		return 0;
+	}
+
+	*task = __builtin_ctz(ready_mask);
+	t = &tasks[*task];
+	*event = t->queue[t->tail & (SCHED_QUEUE_LEN - 1)];
+	t->tail++;
+	if ( t->head == t->tail )
+		ready_mask &= ~(1UL << *task);
+
+	__set_PRIMASK(primask);
+	return 1;
+}
+
+
+// Vrne čas v ms do naslednjega (ne odložljivega) časovnika oziroma UINT32_MAX,
+// če noben ne teče. Kličemo jo z onemogočenimi prekinitvami.
+static uint32_t SCHED_next_timer_ms(void)
+{
+	uint32_t elapsed = HAL_GetTick() - last_tick_ms;
+	uint32_t next = UINT32_MAX;
+
+	for ( uint32_t i = 0; i < SCHED_MAX_TIMERS; i++ )
+	{
+		SCHED_timer_handle_t *t = &timers[i];
+		uint32_t remaining;
+
+		if ( !t->active || t->deferrable )
+			continue;
+
+		remaining = ( t->remaining_ms > elapsed ) ? t->remaining_ms - elapsed : 0;
+		if ( remaining < next )
+			next = remaining;
+	}
+	return next;
+}
+
+
+
+
+// -------------- Public function implementations --------------
+
+
+// Omogoči DWT števec ciklov za merjenje časa izvajanja opravil.
+void SCHED_init(void)
+{
+	CYCLE_init();
+
+	last_tick_ms = HAL_GetTick();
+	stats_start_ms = last_tick_ms;
+
+	CONSOLE_register('p', SCHED_stats_print, "scheduler task stats");
+}
+
+
+// Doda opravilo. Opravila, dodana prej, imajo višjo prioriteto.
+// Vrne SCHED_NO_TASK, če je opravil že SCHED_MAX_TASKS; takega opravila
+// ostale funkcije ne poznajo, zato ne more dobiti dogodkov drugega opravila.
+SCHED_task_t SCHED_add_task(const char *name, SCHED_handler_t handler)
+{
+	if ( task_count >= SCHED_MAX_TASKS )
+	{
+		printf("SCHED_add_task(): too many tasks (%s)\n", name);
+		return SCHED_NO_TASK;
+	}
+
+	tasks[task_count].handler = handler;
+	tasks[task_count].stats.name = name;
+
+	return task_count++;
+}
+
+
+// Glavna zanka razvrščevalnika; se nikoli ne vrne.
+void SCHED_run(void)
+{
+	SCHED_task_t task;
+	SCHED_event_t event;
+
+	while (1)
+	{
+		if ( SCHED_next_event(&task, &event) )
+		{
+			SCHED_task_handle_t *t = &tasks[task];
+			uint32_t start = CYCLE_now();
+
+			t->handler(event);
+
+			uint32_t cycles = CYCLE_now() - start;
+			t->stats.runs++;
+			t->stats.cycles += cycles;
+			if ( cycles > t->stats.max_cycles )
+				t->stats.max_cycles = cycles;
+			continue;
+		}
+
+		// Prekinitve onemogočimo pred zadnjim preverjanjem, sicer bi lahko dogodek,
+		// objavljen tik pred WFI, obležal do naslednje prekinitve.
+		// WFI se zbudi tudi ob onemogočenih prekinitvah.
+		__disable_irq();
+		if ( ready_mask == 0 )
+			IDLE_enter(SCHED_next_timer_ms());
+		__enable_irq();
+	}
+}
+
+
+// Doda dogodek v vrsto opravila. Klic je dovoljen tudi iz prekinitev.
+// Vrne 0, če je vrsta polna ali opravilo neveljavno in je bil dogodek zavržen.
+uint8_t SCHED_post(SCHED_task_t task, uint16_t signal, uint16_t param)
+{
+	SCHED_task_handle_t *t;
+	uint32_t primask = __get_PRIMASK();
+	uint32_t queued;
+
+	if ( task >= task_count )
+		return 0;
+	t = &tasks[task];
+
+	__disable_irq();
+
+	queued = t->head - t->tail;
+	if ( queued >= SCHED_QUEUE_LEN )
+	{
+		t->stats.events_lost++;
+		__set_PRIMASK(primask);
+		return 0;
+	}
+
+	t->queue[t->head & (SCHED_QUEUE_LEN - 1)] = (SCHED_event_t){ signal, param };
+	t->head++;
+	ready_mask |= 1UL << task;
+
+	if ( queued + 1 > t->stats.max_queue )
+		t->stats.max_queue = queued + 1;
+
+	__set_PRIMASK(primask);
+	return 1;
+}
+
+
+// Opravilo "task" bo prejelo vse dogodke s signalom "signal", objavljene s SCHED_publish().
+void SCHED_subscribe(SCHED_task_t task, uint16_t signal)
+{
+	if ( task < task_count && subscription_count < SCHED_MAX_SUBSCRIBERS )
+		subscriptions[subscription_count++] = (SCHED_subscription_t){ task, signal };
+}
+
+
+void SCHED_publish(uint16_t signal, uint16_t param)
+{
+	for ( uint32_t i = 0; i < subscription_count; i++ )
+	{
+		if ( subscriptions[i].signal == signal )
+			SCHED_post(subscriptions[i].task, signal, param);
+	}
+}
+
+
+
+
+// ------ Časovniki -------
+
+
+// Ustvari (ustavljen) časovnik, ki opravilu "task" pošilja signal "signal".
+SCHED_timer_t SCHED_timer_create(SCHED_task_t task, uint16_t signal)
+{
+	if ( task >= task_count )
+		return SCHED_NO_TIMER;
+
+	for ( uint32_t i = 0; i < SCHED_MAX_TIMERS; i++ )
+	{
+		if ( !timers[i].used )
+		{
+			timers[i] = (SCHED_timer_handle_t){ .used = 1, .task = task, .signal = signal };
+			return i;
+		}
+	}
+	printf("SCHED_timer_create(): no free timers\n");
+	return SCHED_NO_TIMER;
+}
+
+
+// (Ponovno) zažene časovnik: prvi dogodek čez "delay_ms", nato vsakih "period_ms"
+// (0 = le enkrat). Parameter dogodka je indeks časovnika.
+void SCHED_timer_start(SCHED_timer_t timer, uint32_t delay_ms, uint32_t period_ms)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	if ( timer == SCHED_NO_TIMER )
+		return;
+
+	__disable_irq();
+	timers[timer].remaining_ms = delay_ms;
+	timers[timer].period_ms = period_ms;
+	timers[timer].active = 1;
+	__set_PRIMASK(primask);
+}
+
+
+void SCHED_timer_stop(SCHED_timer_t timer)
+{
+	if ( timer != SCHED_NO_TIMER )
+		timers[timer].active = 0;
+}
+
+
+// Odložljiv časovnik ne skrajša Stop načina; njegov dogodek pride ob naslednjem bujenju.
+void SCHED_timer_set_deferrable(SCHED_timer_t timer, uint8_t deferrable)
+{
+	if ( timer != SCHED_NO_TIMER )
+		timers[timer].deferrable = deferrable;
+}
+
+
+// Osveži časovnike. Kličemo jo iz periodične prekinitve (TIM6); časovniki
+// tečejo po HAL_GetTick(), zato frekvenca klicanja ni pomembna.
+void SCHED_tick_Callback(void)
+{
+	uint32_t now = HAL_GetTick();
+	uint32_t elapsed = now - last_tick_ms;
+
+	if ( elapsed == 0 )
+		return;
+	last_tick_ms = now;
+
+	// 64-bitni čas ciklov mora opaziti vsak preliv števca (~25 s)
+	CYCLE_now64();
+
+	for ( uint32_t i = 0; i < SCHED_MAX_TIMERS; i++ )
+	{
+		SCHED_timer_handle_t *t = &timers[i];
+
+		if ( !t->active )
+			continue;
+
+		if ( t->remaining_ms > elapsed )
+		{
+			t->remaining_ms -= elapsed;
+			continue;
+		}
+
+		SCHED_post(t->task, t->signal, i);
+		if ( t->period_ms != 0 )
+			t->remaining_ms = t->period_ms;
+		else
+			t->active = 0;
+	}
+}
+
+
+
+
+// ------ Statistika -------
+
+
+// Vrne NULL za neveljavno opravilo.
+const SCHED_task_stats_t* SCHED_get_task_stats(SCHED_task_t task)
+{
+	if ( task >= task_count )
+		return NULL;
+	return &tasks[task].stats;
+}
+
+
+void SCHED_stats_reset(void)
+{
+	for ( uint32_t i = 0; i < task_count; i++ )
+	{
+		const char *name = tasks[i].stats.name;
+		tasks[i].stats = (SCHED_task_stats_t){ .name = name };
+	}
+	stats_start_ms = HAL_GetTick();
+}
+
+
+// Izpiše statistiko v CSV obliki: ime, število izvajanj, povprečni in najdaljši
+// čas izvajanja v us, delež procesorskega časa v promilih, največja zasedenost
+// vrste in izgubljeni dogodki. Vrstica "idle" pove, koliko časa je procesor
+// čakal v IDLE_enter() (in v prekinitvah); razdelitev na načine izpiše IDLE_stats_print().
+void SCHED_stats_print(void)
+{
+	uint32_t cycles_per_us = CYCLE_hz() / 1000000;
+	uint64_t window = (uint64_t)(HAL_GetTick() - stats_start_ms) * 1000 * cycles_per_us;
+	uint64_t busy = 0;
+
+	if ( window == 0 )
+		window = 1;
+
+	printf("sched,task,runs,avg_us,max_us,load_permille,max_queue,lost\n");
+	for ( uint32_t i = 0; i < task_count; i++ )
+	{
+		const SCHED_task_stats_t *s = &tasks[i].stats;
+		uint32_t avg = s->runs ? (uint32_t)(s->cycles / s->runs / cycles_per_us) : 0;
+
+		busy += s->cycles;
+		printf("sched,%s,%lu,%lu,%lu,%lu,%lu,%lu\n", s->name,
+				(unsigned long) s->runs, (unsigned long) avg,
+				(unsigned long) (s->max_cycles / cycles_per_us),
+				(unsigned long) (s->cycles * 1000 / window),
+				(unsigned long) s->max_queue, (unsigned long) s->events_lost);
+	}
+	printf("sched,idle,,,,%lu,,\n", (unsigned long) (busy < window ? (window - busy) * 1000 / window : 0));
+}
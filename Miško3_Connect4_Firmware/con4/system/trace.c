@@ -0,0 +1,197 @@
+/*
+ * trace.c
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+
+/* **************** MODULE DESCRIPTION *************************
+
+Ta modul implementira odloženo binarno beleženje dogodkov (angl. deferred
+binary logging). Namesto da bi sporočila oblikovali s printf() na
+mikrokrmilniku, zapišemo le kratek binarni zapis: ID dogodka, časovni žig
+in nekaj bajtov podatkov. Besedilo iz zapisov sestavi šele dekodirnik na
+osebnem računalniku (tools/trace_decode).
+
+Zapisi se shranjujejo v RAM krožni medpomnilnik (ring.c). Funkcija
+TRACE_service(), ki jo kličemo iz glavne zanke, jih prenaša v DMA
+medpomnilnik SCI vmesnika, od koder jih DMA pošlje preko USART-a.
+Tudi printf() sporočila se zapišejo kot zapisi (TRACE_ID_TEXT), tako da
+se besedilo in binarni zapisi na povezavi nikoli ne prepletejo.
+
+Zapis dogodka stane nekaj deset ciklov, zato ga lahko pustimo vklopljenega
+tudi v zanki iskanja. Če je medpomnilnik poln, se zapis zavrže, število
+zavrženih zapisov pa se sporoči z zapisom TRACE_ID_OVERFLOW.
+
+POZOR: zapise lahko ustvarja le glavna zanka (en sam "producer"),
+ne pa prekinitvene rutine.
+
+************************************************************* */
+
+
+
+
+// ----------- Include other modules (for private) -------------
+
+#include "trace.h"
+
+#if TRACE_ENABLED
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cycle_timer.h"
+#include "ring.h"
+#include "SCI.h"
+#include "console.h"
+
+
+// ---------------------- Private definitions ------------------
+
+#if (TRACE_BUF_LEN & (TRACE_BUF_LEN - 1)) != 0
+#error "TRACE_BUF_LEN must be a power of two"
+#endif
+
+static uint8_t trace_buffer[TRACE_BUF_LEN];
+
+// Medpomnilnik je inicializiran že ob zagonu, zato printf() deluje tudi pred TRACE_init().
+static ring_handle_t trace_ring = { trace_buffer, TRACE_BUF_LEN - 1, 0, 0 };
+
+static TRACE_stats_t trace_stats;
+static uint32_t trace_pending_dropped;		// zavrženi zapisi, ki še niso bili sporočeni
+
+
+
+
+// -------------- Private function implementations -------------
+
+
+// Zapiše glavo in podatke, če je za oboje dovolj prostora.
+static uint8_t TRACE_write(uint8_t id, const void *payload, uint32_t size)
+{
+	uint8_t header[TRACE_HEADER_SIZE];
+	uint32_t timestamp = CYCLE_now();
+	uint32_t occupancy;
+
+	if ( RING_get_free_size(&trace_ring) < TRACE_HEADER_SIZE + size )
+		return 0;
+
+	header[0] = TRACE_SYNC;
+	header[1] = id;
+	header[2] = (uint8_t) size;
+	memcpy(&header[3], &timestamp, sizeof(timestamp));
+
+	// Prostor smo preverili vnaprej, drugi "producer" pa ga ne more porabiti.
+	RING_write(&trace_ring, header, TRACE_HEADER_SIZE);
+	RING_write(&trace_ring, payload, size);
+
+	trace_stats.records++;
+	trace_stats.bytes += TRACE_HEADER_SIZE + size;
+
+	occupancy = RING_get_data_size(&trace_ring);
+	if ( occupancy > trace_stats.peak_occupancy )
+		trace_stats.peak_occupancy = occupancy;
+
+	return 1;
+}
+
+
+
+
+// -------------- Public function implementations --------------
+
+
+// Omogoči DWT števec ciklov, ki služi kot časovni žig zapisov, in registriraj ukaz 't'.
+void TRACE_init(void)
+{
+	CYCLE_init();
+
+	CONSOLE_register('t', TRACE_stats_print, "trace stats");
+}
+
+
+// Zapiše dogodek "id" s "size" bajti podatkov (največ TRACE_MAX_PAYLOAD).
+void TRACE_record(uint8_t id, const void *payload, uint32_t size)
+{
+	if ( size > TRACE_MAX_PAYLOAD )
+		size = TRACE_MAX_PAYLOAD;
+
+	// Najprej sporočimo morebitne prej zavržene zapise.
+	if ( trace_pending_dropped != 0 )
+	{
+		if ( !TRACE_write(TRACE_ID_OVERFLOW, &trace_pending_dropped, sizeof(trace_pending_dropped)) )
+		{
+			trace_pending_dropped++;
+			trace_stats.dropped++;
+			return;
+		}
+		trace_pending_dropped = 0;
+	}
+
+	if ( !TRACE_write(id, payload, size) )
+	{
+		trace_pending_dropped++;
+		trace_stats.dropped++;
+	}
+}
+
+
+// Zapiše besedilo (npr. iz _write()), po potrebi razdeljeno na več zapisov.
+void TRACE_text(const char *text, uint32_t length)
+{
+	while ( length > 0 )
+	{
+		uint32_t size = ( length > TRACE_MAX_PAYLOAD ) ? TRACE_MAX_PAYLOAD : length;
+
+		TRACE_record(TRACE_ID_TEXT, text, size);
+		text += size;
+		length -= size;
+	}
+}
+
+
+// Prenese čim več zapisov iz RAM medpomnilnika v DMA medpomnilnik SCI vmesnika.
+// Kličemo jo periodično iz glavne zanke.
+void TRACE_service(void)
+{
+	const uint8_t *data;
+	uint32_t size;
+	uint32_t space;
+
+	while ( (size = RING_peek_read(&trace_ring, &data)) > 0 )
+	{
+		space = SCI_DMA_get_free_size();
+		if ( space == 0 )
+			break;
+		if ( size > space )
+			size = space;
+
+		SCI_send_bytes_DMA( (uint8_t *) data, size );
+		RING_commit_read(&trace_ring, size);
+	}
+}
+
+
+// Vrne število prostih bajtov v medpomnilniku. Zapis s "size" bajti podatkov
+// potrebuje TRACE_HEADER_SIZE + size bajtov.
+uint32_t TRACE_free_size(void)
+{
+	return RING_get_free_size(&trace_ring);
+}
+
+
+void TRACE_stats_get(TRACE_stats_t *stats)
+{
+	*stats = trace_stats;
+}
+
+
+void TRACE_stats_print(void)
+{
+	printf("trace,records=%lu,bytes=%lu,dropped=%lu,peak=%lu/%u\n",
+			(unsigned long) trace_stats.records, (unsigned long) trace_stats.bytes,
+			(unsigned long) trace_stats.dropped, (unsigned long) trace_stats.peak_occupancy,
+			TRACE_BUF_LEN);
+}
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ * ai_batch.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Throughput of the host network kernels on one core, in positions per
+ * second, and how far each batched path is from ai_kernel_run():
+ *
+ *   kernel         ai_kernel_run(), one position at a time
+ *   kernel_batch   ai_kernel_run_batch() (ai_kernel.c, portable)
+ *   scalar/avx2/avx512   ai_simd_run_batch() (tools/host/ai_simd.c) on each
+ *                  path this CPU supports
+ *
+ * The positions are random games from a fixed seed, encoded by get_state().
+ *
+ * Usage: ai_batch [-n positions] [-b batch] [-r repeat] [-i isa] [-t tolerance]
+ *   -n positions  default 4096
+ *   -b batch      positions per call, default 64, 128 and 256
+ *   -r repeat     passes over the positions, default 20
+ *   -i isa        only this ai_simd path (scalar, avx2, avx512)
+ *   -t tolerance  largest max_abs_diff of avx2 and avx512, default 1e-4
+ *
+ * Output CSV: ai_batch,kernel,batch,positions_per_s,ns_per_position,
+ * max_abs_diff,argmax_agree (both against ai_kernel_run()).
+ *
+ * kernel_batch and scalar add in the same order as ai_kernel_run(), so their
+ * max_abs_diff must be 0; the FMA paths must stay within the tolerance. The
+ * exit status is 1 if a path misses its bound or picks another column for
+ * any position, so ctest runs this as the check of the batched kernels.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "game.h"
+#include "bitboard.h"
+#include "ai_kernel.h"
+#include "ai_simd.h"
+
+typedef void (*batch_fn_t)(const float* inputs, float* outputs, int count);
+
+static float* inputs;
+static float* reference;
+static float* outputs;
+static int positions = 4096;
+static int repeat = 20;
+static double tolerance = 1e-4;
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t xorshift32(uint32_t* s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+// Random positions of 0 to 30 plies without a finished game
+static void build_positions(void) {
+    uint32_t seed = 0x2545F491;
+
+    for (int n = 0; n < positions; n++) {
+        bitboard_t pos = { 0, 0, 0 };
+        int plies = xorshift32(&seed) % 31;
+        ai_i8 state[AI_KERNEL_INPUTS];
+
+        while (pos.moves < plies) {
+            int col = xorshift32(&seed) % COLS;
+            if (bb_can_play(&pos, col) && !bb_is_winning_move(&pos, col)) {
+                bb_play(&pos, col);
+            } else if (xorshift32(&seed) % 8 == 0) {
+                break;                    // no quiet move left, or unlucky: stop here
+            }
+        }
+        bb_to_board(&pos, game.board, game.PLAYER_AI, game.PLAYER_HUMAN);
+        get_state(state);
+        ai_kernel_input_from_state(state, &inputs[n * AI_KERNEL_INPUTS]);
+    }
+}
+
+static int argmax(const float* values) {
+    int best = 0;
+
+    for (int col = 1; col < AI_KERNEL_OUTPUTS; col++) {
+        if (values[col] > values[best]) {
+            best = col;
+        }
+    }
+    return best;
+}
+
+static void single(const float* in, float* out, int count) {
+    for (int i = 0; i < count; i++) {
+        ai_kernel_run(&in[i * AI_KERNEL_INPUTS], &out[i * AI_KERNEL_OUTPUTS]);
+    }
+}
+
+// Returns 1 if the outputs are further from ai_kernel_run() than allowed
+static int measure(const char* name, batch_fn_t fn, int batch, int exact) {
+    double start, seconds, max_diff = 0;
+    int agree = 0;
+
+    fn(inputs, outputs, positions < batch ? positions : batch);    // warm up
+    start = now_seconds();
+    for (int r = 0; r < repeat; r++) {
+        for (int b = 0; b < positions; b += batch) {
+            int n = (positions - b < batch) ? positions - b : batch;
+            fn(&inputs[b * AI_KERNEL_INPUTS], &outputs[b * AI_KERNEL_OUTPUTS], n);
+        }
+    }
+    seconds = now_seconds() - start;
+
+    for (int i = 0; i < positions; i++) {
+        const float* out = &outputs[i * AI_KERNEL_OUTPUTS];
+        const float* ref = &reference[i * AI_KERNEL_OUTPUTS];
+
+        for (int col = 0; col < AI_KERNEL_OUTPUTS; col++) {
+            max_diff = fmax(max_diff, fabs((double)out[col] - ref[col]));
+        }
+        agree += argmax(out) == argmax(ref);
+    }
+    printf("ai_batch,%s,%d,%.0f,%.1f,%.3g,%.4f\n", name, batch,
+           (double)positions * repeat / seconds, seconds * 1e9 / ((double)positions * repeat),
+           max_diff, (double)agree / positions);
+    fflush(stdout);
+
+    if (max_diff > (exact ? 0.0 : tolerance) || agree != positions) {
+        fprintf(stderr, "%s, batch %d: max_abs_diff %.3g, argmax_agree %d of %d\n",
+                name, batch, max_diff, agree, positions);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int batches[3] = { 64, 128, 256 }, batch_count = 3;
+    int only = -1;
+    int failed = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:b:r:i:t:")) != -1) {
+        switch (opt) {
+            case 'n': positions = atoi(optarg); break;
+            case 'b': batches[0] = atoi(optarg); batch_count = 1; break;
+            case 'r': repeat = atoi(optarg); break;
+            case 'i':
+                for (int isa = 0; isa < AI_SIMD_COUNT; isa++) {
+                    if (strcmp(optarg, ai_simd_name(isa)) == 0) {
+                        only = isa;
+                    }
+                }
+                if (only < 0) {
+                    fprintf(stderr, "unknown isa %s\n", optarg);
+                    return 2;
+                }
+                break;
+            case 't': tolerance = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-n positions] [-b batch] [-r repeat] [-i isa] [-t tolerance]\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+    if (positions < 1 || batches[0] < 1 || repeat < 1) {
+        fprintf(stderr, "bad option value\n");
+        return 2;
+    }
+    if (ai_simd_init() != 0) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    inputs = malloc((size_t)positions * AI_KERNEL_INPUTS * sizeof(float));
+    reference = malloc((size_t)positions * AI_KERNEL_OUTPUTS * sizeof(float));
+    outputs = malloc((size_t)positions * AI_KERNEL_OUTPUTS * sizeof(float));
+    if (!inputs || !reference || !outputs) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    build_positions();
+    single(inputs, reference, positions);
+
+    printf("ai_batch,kernel,batch,positions_per_s,ns_per_position,max_abs_diff,argmax_agree\n");
+    if (only < 0) {
+        failed |= measure("kernel", single, 1, 1);
+    }
+    for (int b = 0; b < batch_count; b++) {
+        if (only < 0) {
+            failed |= measure("kernel_batch", ai_kernel_run_batch, batches[b], 1);
+        }
+        for (int isa = 0; isa < AI_SIMD_COUNT; isa++) {
+            if ((only >= 0 && isa != only) || ai_simd_select(isa) != 0) {
+                continue;
+            }
+            failed |= measure(ai_simd_name(isa), ai_simd_run_batch, batches[b], isa == AI_SIMD_SCALAR);
+        }
+    }
+    if (only >= 0 && !ai_simd_supported(only)) {
+        fprintf(stderr, "this CPU cannot run %s\n", ai_simd_name(only));
+        return 1;
+    }
+    return failed;
+}
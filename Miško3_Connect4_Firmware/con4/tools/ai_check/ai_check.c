@@ -0,0 +1,220 @@
+/*
+ * ai_check.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Cross-checks the host network (ai_kernel.c, weights from the X-CUBE-AI
+ * blob) against reference outputs for the same inputs, e.g.
+ *
+ *   the board      trace_decode -a capture.bin > ref.csv
+ *                  (TRACE_AI_INPUT/OUTPUT of the X-CUBE-AI runtime)
+ *   the trainer    np.savetxt("ref.csv", np.hstack([x, model(x)]),
+ *                             delimiter=",", fmt="%.9g")
+ *   reference.csv  64 positions in float64 from make_reference.py, which reads
+ *                  the X-CUBE-AI sources without ai_kernel.c; ctest checks it
+ *
+ * One reference per line: the 147 inputs, then the 7 outputs. Every input
+ * is evaluated one by one with ai_kernel_run() and in batches with
+ * ai_kernel_run_batch(); the two must agree bit for bit. Against the
+ * reference the tool reports the worst absolute and relative error (relative
+ * to |reference|, at least 1e-3), the mean absolute error, how many outputs
+ * are bit-identical, and how often the best column agrees, over all columns
+ * and over the columns the input marks as valid (what the AI plays).
+ *
+ * Usage: ai_check [-t tolerance] [-n repeat] [file]
+ *   -t tolerance  largest absolute error accepted, default 1e-4
+ *   -n repeat     timing passes over the inputs, default 1
+ *
+ * Output CSV: ai_check,positions,bit_exact,max_abs_err,max_rel_err,
+ * mean_abs_err,argmax_agree,valid_argmax_agree,single_per_s,batch_per_s.
+ * The exit status is 1 if an error is above the tolerance, a valid-column
+ * choice differs, or the batch and single results differ.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ai_kernel.h"
+
+#define VALID_OFFSET    (3 * ROWS * COLS)    // get_state(): valid moves after the board
+
+typedef struct {
+    float* inputs;
+    float* reference;
+    float* single;
+    float* batch;
+    size_t count;
+    size_t capacity;
+} ref_set_t;
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Highest value, over the valid columns only if `input` is given
+static int best_column(const float* values, const float* input) {
+    int best = -1;
+
+    for (int col = 0; col < AI_KERNEL_OUTPUTS; col++) {
+        if (input && input[VALID_OFFSET + col] == 0) {
+            continue;
+        }
+        if (best < 0 || values[col] > values[best]) {
+            best = col;
+        }
+    }
+    return best;
+}
+
+static int grow(ref_set_t* set) {
+    size_t capacity = set->capacity ? 2 * set->capacity : 1024;
+    float* inputs = realloc(set->inputs, capacity * AI_KERNEL_INPUTS * sizeof(float));
+    float* reference = inputs ? realloc(set->reference, capacity * AI_KERNEL_OUTPUTS * sizeof(float)) : NULL;
+
+    if (inputs) {
+        set->inputs = inputs;
+    }
+    if (!reference) {
+        return -1;
+    }
+    set->reference = reference;
+    set->capacity = capacity;
+    return 0;
+}
+
+static int read_references(FILE* in, ref_set_t* set) {
+    char line[4096];
+    unsigned long line_no = 0;
+
+    while (fgets(line, sizeof(line), in)) {
+        float values[AI_KERNEL_INPUTS + AI_KERNEL_OUTPUTS];
+        char* p = line;
+        int n = 0;
+
+        line_no++;
+        if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0') {
+            continue;
+        }
+        while (n < AI_KERNEL_INPUTS + AI_KERNEL_OUTPUTS) {
+            char* end;
+
+            values[n] = strtof(p, &end);
+            if (end == p) {
+                break;
+            }
+            n++;
+            p = end + strspn(end, ", \t");
+        }
+        if (n != AI_KERNEL_INPUTS + AI_KERNEL_OUTPUTS || p[strspn(p, " \t\r\n")] != '\0') {
+            fprintf(stderr, "line %lu: expected %d inputs and %d outputs\n", line_no,
+                    AI_KERNEL_INPUTS, AI_KERNEL_OUTPUTS);
+            return -1;
+        }
+        if (set->count == set->capacity && grow(set) != 0) {
+            fprintf(stderr, "out of memory\n");
+            return -1;
+        }
+        memcpy(&set->inputs[set->count * AI_KERNEL_INPUTS], values, AI_KERNEL_INPUTS * sizeof(float));
+        memcpy(&set->reference[set->count * AI_KERNEL_OUTPUTS], &values[AI_KERNEL_INPUTS],
+               AI_KERNEL_OUTPUTS * sizeof(float));
+        set->count++;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    FILE* in = stdin;
+    ref_set_t set = { 0 };
+    double tolerance = 1e-4, max_abs = 0, max_rel = 0, sum_abs = 0;
+    double single_seconds, batch_seconds;
+    unsigned long bit_exact = 0, argmax_agree = 0, valid_agree = 0, batch_mismatch = 0;
+    long repeat = 1;
+    double start;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:n:")) != -1) {
+        switch (opt) {
+            case 't': tolerance = atof(optarg); break;
+            case 'n': repeat = atol(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-t tolerance] [-n repeat] [file]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (repeat < 1) {
+        fprintf(stderr, "bad repeat count\n");
+        return 2;
+    }
+    if (optind < argc && !(in = fopen(argv[optind], "r"))) {
+        perror(argv[optind]);
+        return 1;
+    }
+    if (read_references(in, &set) != 0) {
+        return 1;
+    }
+    if (set.count == 0) {
+        fprintf(stderr, "no references\n");
+        return 1;
+    }
+    set.single = malloc(set.count * AI_KERNEL_OUTPUTS * sizeof(float));
+    set.batch = malloc(set.count * AI_KERNEL_OUTPUTS * sizeof(float));
+    if (!set.single || !set.batch) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    start = now_seconds();
+    for (long r = 0; r < repeat; r++) {
+        for (size_t i = 0; i < set.count; i++) {
+            ai_kernel_run(&set.inputs[i * AI_KERNEL_INPUTS], &set.single[i * AI_KERNEL_OUTPUTS]);
+        }
+    }
+    single_seconds = now_seconds() - start;
+
+    start = now_seconds();
+    for (long r = 0; r < repeat; r++) {
+        ai_kernel_run_batch(set.inputs, set.batch, set.count);
+    }
+    batch_seconds = now_seconds() - start;
+
+    for (size_t i = 0; i < set.count; i++) {
+        const float* input = &set.inputs[i * AI_KERNEL_INPUTS];
+        const float* ref = &set.reference[i * AI_KERNEL_OUTPUTS];
+        const float* host = &set.single[i * AI_KERNEL_OUTPUTS];
+
+        if (memcmp(host, &set.batch[i * AI_KERNEL_OUTPUTS], AI_KERNEL_OUTPUTS * sizeof(float)) != 0) {
+            batch_mismatch++;
+        }
+        for (int col = 0; col < AI_KERNEL_OUTPUTS; col++) {
+            double err = fabs((double)host[col] - ref[col]);
+
+            bit_exact += memcmp(&host[col], &ref[col], sizeof(float)) == 0;
+            sum_abs += err;
+            max_abs = fmax(max_abs, err);
+            max_rel = fmax(max_rel, err / fmax(fabs(ref[col]), 1e-3));
+        }
+        argmax_agree += best_column(host, NULL) == best_column(ref, NULL);
+        valid_agree += best_column(host, input) == best_column(ref, input);
+    }
+
+    printf("ai_check,positions,bit_exact,max_abs_err,max_rel_err,mean_abs_err,"
+           "argmax_agree,valid_argmax_agree,single_per_s,batch_per_s\n");
+    printf("ai_check,%zu,%.4f,%.3g,%.3g,%.3g,%.4f,%.4f,%.0f,%.0f\n", set.count,
+           (double)bit_exact / (set.count * AI_KERNEL_OUTPUTS), max_abs, max_rel,
+           sum_abs / (set.count * AI_KERNEL_OUTPUTS),
+           (double)argmax_agree / set.count, (double)valid_agree / set.count,
+           set.count * repeat / single_seconds, set.count * repeat / batch_seconds);
+
+    if (batch_mismatch) {
+        fprintf(stderr, "%lu positions differ between ai_kernel_run() and ai_kernel_run_batch()\n",
+                batch_mismatch);
+    }
+    return (batch_mismatch || max_abs > tolerance || valid_agree != set.count) ? 1 : 0;
+}
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+#
+# make_reference.py
+#
+#  Created on: 19 Oct 2026
+#
+# Writes a reference file for ai_check: positions from seeded random games,
+# encoded as get_state() does (board.c), and the network outputs computed in
+# float64 with plain Python. Nothing is shared with ai_kernel.c: the weight
+# offsets are read from python_model_configure_weights() in the X-CUBE-AI
+# generated python_model.c, the tensors from python_model_data_params.c, and
+# the layer shapes follow the ONNX Gemm layout (out, in) of the generate report.
+#
+# Usage: make_reference.py [-n positions] [-s seed] > reference.csv
+# The committed reference.csv is `make_reference.py -n 64 -s 1`.
+
+import argparse
+import random
+import re
+import struct
+import sys
+from pathlib import Path
+
+ROWS, COLS = 6, 7
+EMPTY, AI, HUMAN = 0, 1, 2
+APP = Path(__file__).resolve().parents[2] / "X-CUBE-AI" / "App"
+
+# (weights, bias) offset names in python_model.c and the layer shapes
+LAYERS = [
+    ("_fc1_Gemm_output_0", 147, 100, True),
+    ("_fc2_Gemm_output_0", 100, 100, True),
+    ("output_0", 100, 7, False),
+]
+
+
+def load_blob():
+    text = (APP / "python_model_data_params.c").read_text(errors="replace")
+    body = text[text.index("s_python_model_weights_array_u64"):]
+    body = body[body.index("{") + 1:body.index("}")]
+    words = [int(w, 16) for w in re.findall(r"0x[0-9a-fA-F]+", body)]
+    return struct.pack("<%dQ" % len(words), *words)
+
+
+def load_layers(blob):
+    text = (APP / "python_model.c").read_text(errors="replace")
+    layers = []
+    for name, n_in, n_out, relu in LAYERS:
+        offsets = []
+        for part in ("weights", "bias"):
+            m = re.search(r"(?<![\w])%s_%s_array\.data = AI_PTR\(g_python_model_weights_map\[0\] \+ (\d+)\)" % (name, part), text)
+            offsets.append(int(m.group(1)))
+        w = struct.unpack_from("<%df" % (n_in * n_out), blob, offsets[0])
+        b = struct.unpack_from("<%df" % n_out, blob, offsets[1])
+        layers.append((w, b, n_in, n_out, relu))
+    return layers
+
+
+def evaluate(layers, x):
+    for w, b, n_in, n_out, relu in layers:
+        y = []
+        for o in range(n_out):
+            acc = b[o] + sum(w[o * n_in + i] * x[i] for i in range(n_in))
+            y.append(max(acc, 0.0) if relu else acc)
+        x = y
+    return x
+
+
+# ---- Board, as board.c: row 0 at the bottom ----
+
+def drop_row(board, col):
+    for row in range(ROWS):
+        if board[row][col] == EMPTY:
+            return row
+    return -1
+
+
+def wins(board, player):
+    for row in range(ROWS):
+        for col in range(COLS):
+            for dr, dc in ((0, 1), (1, 0), (1, 1), (1, -1)):
+                if all(0 <= row + k * dr < ROWS and 0 <= col + k * dc < COLS and
+                       board[row + k * dr][col + k * dc] == player for k in range(4)):
+                    return True
+    return False
+
+
+def wins_with(board, col, player):
+    row = drop_row(board, col)
+    if row < 0:
+        return False
+    board[row][col] = player
+    won = wins(board, player)
+    board[row][col] = EMPTY
+    return won
+
+
+def get_state(board):
+    state = []
+    for row in range(ROWS):
+        for col in range(COLS):
+            state += [board[row][col] == EMPTY, board[row][col] == AI, board[row][col] == HUMAN]
+    state += [drop_row(board, col) >= 0 for col in range(COLS)]
+    state += [wins_with(board, col, HUMAN) for col in range(COLS)]
+    state += [wins_with(board, col, AI) for col in range(COLS)]
+    return [1.0 if v else 0.0 for v in state]
+
+
+# A position with the AI to move after a random number of random plies
+def random_position(rng):
+    while True:
+        board = [[EMPTY] * COLS for _ in range(ROWS)]
+        plies = 2 * rng.randrange(0, 18)
+        player = AI
+        over = False
+        for _ in range(plies):
+            col = rng.choice([c for c in range(COLS) if drop_row(board, c) >= 0])
+            board[drop_row(board, col)][col] = player
+            if wins(board, player):
+                over = True
+                break
+            player = HUMAN if player == AI else AI
+        if not over:
+            return board
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("-n", type=int, default=64)
+    parser.add_argument("-s", type=int, default=1)
+    args = parser.parse_args()
+
+    layers = load_layers(load_blob())
+    rng = random.Random(args.s)
+    out = sys.stdout
+    for _ in range(args.n):
+        x = get_state(random_position(rng))
+        y = evaluate(layers, x)
+        out.write(",".join("%.9g" % v for v in x + y) + "\n")
+
+
+if __name__ == "__main__":
+    main()
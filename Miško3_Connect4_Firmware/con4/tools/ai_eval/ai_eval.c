@@ -0,0 +1,121 @@
+/*
+ * ai_eval.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Runs the firmware's feature extraction (board.c) and the portable network
+ * kernel (ai_kernel.c) on the host, one position per input line, and prints
+ * what the AI would play. A position is the list of columns played so far,
+ * 1..7 (e.g. "4453"), or "-" for the empty board; the last move is the
+ * human's, so the AI is to move. Empty lines and "#" comments are skipped.
+ *
+ * Usage: ai_eval [-n repeat] [-q] [file]
+ *   -n repeat   evaluate every position this many times (for perf/callgrind)
+ *   -q          no per-position output, only the timing summary
+ *
+ * Output: one CSV line per position, moves,value1..value7,best_column, then
+ * the cycle_timer summary (host "cycles" are nanoseconds).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "game.h"
+#include "ai_kernel.h"
+#include "cycle_timer.h"
+
+// Sets up game.board from a move list; returns 0 if a move is not legal
+static int load_position(const char* moves) {
+    int n = strlen(moves);
+    int player = (n % 2 == 0) ? game.PLAYER_AI : game.PLAYER_HUMAN;
+
+    reset_board();
+    for (int i = 0; i < n; i++) {
+        int col = moves[i] - '1';
+        if (col < 0 || col >= COLS || !check_if_valid(col)) {
+            return 0;
+        }
+        make_move(col, player);
+        player = (player == game.PLAYER_AI) ? game.PLAYER_HUMAN : game.PLAYER_AI;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    FILE* in = stdin;
+    long repeat = 1;
+    int quiet = 0;
+    char line[128];
+    int opt;
+    long positions = 0;
+    cycle_timer_t state_timer, kernel_timer;
+
+    while ((opt = getopt(argc, argv, "n:q")) != -1) {
+        switch (opt) {
+            case 'n': repeat = atol(optarg); break;
+            case 'q': quiet = 1; break;
+            default:
+                fprintf(stderr, "usage: %s [-n repeat] [-q] [file]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (repeat < 1) {
+        fprintf(stderr, "bad repeat count\n");
+        return 2;
+    }
+    if (optind < argc && !(in = fopen(argv[optind], "r"))) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    CYCLE_init();
+    CYCLE_timer_init(&state_timer, "get_state");
+    CYCLE_timer_init(&kernel_timer, "ai_kernel_run");
+
+    if (!quiet) {
+        printf("moves,v1,v2,v3,v4,v5,v6,v7,best\n");
+    }
+    while (fgets(line, sizeof(line), in)) {
+        ai_i8 state[AI_KERNEL_INPUTS];
+        float input[AI_KERNEL_INPUTS];
+        float values[AI_KERNEL_OUTPUTS];
+
+        line[strcspn(line, " \t\r\n#")] = '\0';
+        if (line[0] == '\0') {
+            continue;
+        }
+        if (!load_position(strcmp(line, "-") ? line : "")) {
+            fprintf(stderr, "illegal position: %s\n", line);
+            continue;
+        }
+
+        for (long r = 0; r < repeat; r++) {
+            CYCLE_timer_start(&state_timer);
+            get_state(state);
+            CYCLE_timer_stop(&state_timer);
+
+            CYCLE_timer_start(&kernel_timer);
+            ai_kernel_input_from_state(state, input);
+            ai_kernel_run(input, values);
+            CYCLE_timer_stop(&kernel_timer);
+        }
+        positions++;
+
+        if (!quiet) {
+            printf("%s", line);
+            for (int col = 0; col < COLS; col++) {
+                printf(",%.6f", values[col]);
+            }
+            printf(",%d\n", ai_kernel_best_move(values) + 1);
+        }
+    }
+
+    if (positions == 0) {
+        fprintf(stderr, "no positions\n");
+        return 1;
+    }
+    CYCLE_print_all();
+    return 0;
+}
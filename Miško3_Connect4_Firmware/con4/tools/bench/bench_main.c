@@ -0,0 +1,111 @@
+/*
+ * bench_main.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Host runner for the engine micro-benchmarks in Aplication/bench.c. Prints
+ * the same CSV as the board's serial command 'b'; on the host a "cycle" is
+ * a nanosecond (tools/host/cycle_clock_host.c).
+ *
+ * Usage: bench [-p passes] [-b baseline.csv] [-t percent]
+ *   -p passes     passes over the corpus per benchmark, default 20
+ *   -b file       compare cycles_per_op with an earlier run of this tool
+ *   -t percent    slowdown that counts as a regression, default 10
+ *
+ * With -b the exit status is 1 if any benchmark regressed, e.g.
+ *   ./bench > baseline.csv        (before the change)
+ *   ./bench -b baseline.csv       (after it)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+#define MAX_RESULTS    32
+
+static struct {
+    char name[32];
+    double cycles_per_op;
+} results[MAX_RESULTS];
+static int result_count;
+
+static void report(const bench_result_t* r) {
+    bench_print_csv(r);
+    if (result_count < MAX_RESULTS) {
+        snprintf(results[result_count].name, sizeof(results[0].name), "%s", r->name);
+        results[result_count].cycles_per_op = r->ops ? (double)r->cycles / r->ops : 0;
+        result_count++;
+    }
+}
+
+// Returns the number of regressions, or -1 if the baseline cannot be read
+static int compare(const char* path, double threshold) {
+    FILE* f = fopen(path, "r");
+    char line[256];
+    int regressions = 0;
+
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        char name[32];
+        unsigned long ops;
+        double old;
+
+        if (sscanf(line, "bench,%31[^,],%lu,%lf", name, &ops, &old) != 3) {
+            continue;
+        }
+        for (int i = 0; i < result_count; i++) {
+            double change;
+
+            if (strcmp(results[i].name, name) != 0 || old <= 0) {
+                continue;
+            }
+            change = (results[i].cycles_per_op / old - 1) * 100;
+            if (change > threshold) {
+                fprintf(stderr, "regression,%s,%.2f,%.2f,%+.1f%%\n", name, old,
+                        results[i].cycles_per_op, change);
+                regressions++;
+            }
+        }
+    }
+    fclose(f);
+    return regressions;
+}
+
+int main(int argc, char** argv) {
+    const char* baseline = NULL;
+    double threshold = 10;
+    long passes = 20;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:b:t:")) != -1) {
+        switch (opt) {
+            case 'p': passes = atol(optarg); break;
+            case 'b': baseline = optarg; break;
+            case 't': threshold = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-p passes] [-b baseline.csv] [-t percent]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (passes < 1) {
+        fprintf(stderr, "bad pass count\n");
+        return 2;
+    }
+
+    bench_print_csv_header();
+    bench_run(passes, report);
+
+    if (baseline) {
+        int regressions = compare(baseline, threshold);
+        if (regressions != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,240 @@
+/*
+ * dataset.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Writer, mmap reader and conversions for the training dataset format in
+ * dataset.h. The writer streams records and fills in the count and CRCs when
+ * it finishes; until then the header says zero records, so a file cut short
+ * by a crash reads as empty instead of half written.
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "dataset.h"
+
+#define HEADER_CRC_BYTES    offsetof(dataset_header_t, header_crc)
+
+// ------------------- CRC-32 ---------------------
+
+static uint32_t crc_table[256];
+static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+
+static void crc_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        crc_table[i] = c;
+    }
+}
+
+// zlib's crc32(): start with 0 and chain the result over the pieces
+uint32_t dataset_crc32(uint32_t crc, const void* data, size_t size) {
+    const uint8_t* p = data;
+
+    pthread_once(&crc_once, crc_init);
+    crc = ~crc;
+    while (size--) {
+        crc = crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// ------------------- Writer ---------------------
+
+static int write_header(dataset_writer_t* w) {
+    w->header.header_crc = dataset_crc32(0, &w->header, HEADER_CRC_BYTES);
+    if (fseek(w->file, 0, SEEK_SET) != 0 ||
+        fwrite(&w->header, sizeof(w->header), 1, w->file) != 1) {
+        return -1;
+    }
+    return 0;
+}
+
+int dataset_create(dataset_writer_t* w, const char* path, uint64_t seed) {
+    memset(&w->header, 0, sizeof(w->header));
+    memcpy(w->header.magic, "C4DS", 4);
+    w->header.version = DATASET_VERSION;
+    w->header.record_size = sizeof(dataset_record_t);
+    w->header.features = DATASET_FEATURES;
+    w->header.seed = seed;
+
+    if (!(w->file = fopen(path, "wb"))) {
+        perror(path);
+        return -1;
+    }
+    if (write_header(w) != 0) {
+        perror(path);
+        fclose(w->file);
+        w->file = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int dataset_write(dataset_writer_t* w, const dataset_record_t* records, size_t count) {
+    if (fwrite(records, sizeof(*records), count, w->file) != count) {
+        perror("dataset_write");
+        return -1;
+    }
+    w->header.records += count;
+    w->header.records_crc = dataset_crc32(w->header.records_crc, records, count * sizeof(*records));
+    return 0;
+}
+
+int dataset_finish(dataset_writer_t* w) {
+    int err = write_header(w);
+
+    err |= ferror(w->file);
+    err |= fclose(w->file);
+    w->file = NULL;
+    if (err) {
+        perror("dataset_finish");
+        return -1;
+    }
+    return 0;
+}
+
+// ------------------- Reader ---------------------
+
+int dataset_open(dataset_reader_t* r, const char* path, int verify) {
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    const dataset_header_t* h;
+
+    memset(r, 0, sizeof(*r));
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror(path);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    if ((size_t)st.st_size < sizeof(dataset_header_t)) {
+        fprintf(stderr, "%s: too short for a dataset\n", path);
+        close(fd);
+        return -1;
+    }
+    r->map_size = st.st_size;
+    r->map = mmap(NULL, r->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (r->map == MAP_FAILED) {
+        perror(path);
+        r->map = NULL;
+        return -1;
+    }
+    madvise(r->map, r->map_size, MADV_SEQUENTIAL);
+
+    h = r->map;
+    r->header = *h;
+    r->records = (const dataset_record_t*)(h + 1);
+    if (memcmp(h->magic, "C4DS", 4) != 0 || h->header_crc != dataset_crc32(0, h, HEADER_CRC_BYTES)) {
+        fprintf(stderr, "%s: not a dataset\n", path);
+    } else if (h->version != DATASET_VERSION || h->record_size != sizeof(dataset_record_t)) {
+        fprintf(stderr, "%s: dataset version %u is not supported\n", path, h->version);
+    } else if (h->records > (r->map_size - sizeof(*h)) / sizeof(dataset_record_t)) {
+        fprintf(stderr, "%s: truncated\n", path);
+    } else if (verify && h->records_crc != dataset_crc32(0, r->records, h->records * sizeof(dataset_record_t))) {
+        fprintf(stderr, "%s: record checksum mismatch\n", path);
+    } else {
+        return 0;
+    }
+    dataset_close(r);
+    return -1;
+}
+
+// Up to `max` records from the mapping, without copying; returns 0 at the end
+size_t dataset_next_batch(dataset_reader_t* r, size_t max, const dataset_record_t** batch) {
+    uint64_t left = r->header.records - r->next;
+    size_t count = left < max ? (size_t)left : max;
+
+    *batch = r->records + r->next;
+    r->next += count;
+    return count;
+}
+
+void dataset_rewind(dataset_reader_t* r) {
+    r->next = 0;
+}
+
+void dataset_close(dataset_reader_t* r) {
+    if (r->map) {
+        munmap(r->map, r->map_size);
+    }
+    memset(r, 0, sizeof(*r));
+}
+
+// ------------------- Conversions ---------------------
+
+// Position fields of `record` from `pos`; the targets are set to unknown
+void dataset_from_bitboard(const bitboard_t* pos, dataset_record_t* record) {
+    bitboard_t other = { pos->current ^ pos->mask, pos->mask, pos->moves };
+
+    memset(record, 0, sizeof(*record));
+    for (int col = 0; col < COLS; col++) {
+        for (int row = 0; row < ROWS; row++) {
+            uint64_t bit = 1ULL << (col * BB_HEIGHT + row);
+            uint64_t cell = 1ULL << (row * COLS + col);
+
+            if (pos->current & bit) {
+                record->mover |= cell;
+            } else if (pos->mask & bit) {
+                record->opponent |= cell;
+            }
+        }
+        if (bb_can_play(pos, col)) {
+            record->legal |= 1 << col;
+            record->win |= bb_is_winning_move(pos, col) << col;
+            record->threat |= bb_is_winning_move(&other, col) << col;
+        }
+    }
+    record->move = DATASET_NO_MOVE;
+    record->outcome = DATASET_NO_VALUE;
+    record->value = DATASET_NO_VALUE;
+    record->distance = DATASET_NO_DISTANCE;
+    record->ply = pos->moves;
+}
+
+void dataset_to_bitboard(const dataset_record_t* record, bitboard_t* pos) {
+    pos->current = 0;
+    pos->mask = 0;
+    for (int col = 0; col < COLS; col++) {
+        for (int row = 0; row < ROWS; row++) {
+            uint64_t bit = 1ULL << (col * BB_HEIGHT + row);
+            uint64_t cell = 1ULL << (row * COLS + col);
+
+            if (record->mover & cell) {
+                pos->current |= bit;
+            }
+            if ((record->mover | record->opponent) & cell) {
+                pos->mask |= bit;
+            }
+        }
+    }
+    pos->moves = record->ply;
+}
+
+// The get_state() encoding of the position, the side to move as PLAYER_AI
+void dataset_to_state(const dataset_record_t* record, ai_i8* state) {
+    for (int cell = 0; cell < ROWS * COLS; cell++) {
+        int mover = (record->mover >> cell) & 1;
+        int opponent = (record->opponent >> cell) & 1;
+
+        state[3 * cell] = !(mover | opponent);
+        state[3 * cell + 1] = mover;
+        state[3 * cell + 2] = opponent;
+    }
+    for (int col = 0; col < COLS; col++) {
+        state[3 * ROWS * COLS + col] = (record->legal >> col) & 1;
+        state[3 * ROWS * COLS + COLS + col] = (record->threat >> col) & 1;
+        state[3 * ROWS * COLS + 2 * COLS + col] = (record->win >> col) & 1;
+    }
+}
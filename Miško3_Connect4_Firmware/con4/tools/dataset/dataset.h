@@ -0,0 +1,99 @@
+/*
+ * dataset.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef TOOLS_DATASET_H_
+#define TOOLS_DATASET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "game.h"
+#include "bitboard.h"
+
+/*
+ * Training positions for python_model, in fixed 24-byte records behind a
+ * 64-byte header, little endian (x86-64 and ARM hosts write it as it is in
+ * memory). A record holds exactly what get_state() encodes, so the 147
+ * network inputs come back without the board code:
+ *
+ *   features 0..125    one-hot empty/mover/opponent of cell row * COLS + col
+ *   features 126..132  legal, 133..139 threat, 140..146 win, bit = column
+ *
+ * The reader maps the file and hands out pointers into it. In numpy:
+ *
+ *   np.memmap(f, offset=64, dtype=[("mover", "<u8"), ("opponent", "<u8"),
+ *       ("legal", "u1"), ("threat", "u1"), ("win", "u1"), ("move", "u1"),
+ *       ("outcome", "i1"), ("value", "i1"), ("distance", "u1"), ("ply", "u1")])
+ *
+ * The CRCs are zlib.crc32 of the records and of the first 60 header bytes.
+ */
+
+#define DATASET_VERSION        1
+#define DATASET_FEATURES       147
+#define DATASET_NO_MOVE        0xFF
+#define DATASET_NO_VALUE       (-128)
+#define DATASET_NO_DISTANCE    0xFF
+
+typedef struct {
+    uint64_t mover;                // discs of the side to move, bit row * COLS + col
+    uint64_t opponent;
+    uint8_t legal;                 // bit col: the column is open
+    uint8_t threat;                // the opponent would win by playing col (get_state's blocking moves)
+    uint8_t win;                   // the side to move wins by playing col
+    uint8_t move;                  // move played or best move, DATASET_NO_MOVE
+    int8_t outcome;                // game result for the side to move: +1, 0, -1, DATASET_NO_VALUE
+    int8_t value;                  // search or solver value for the side to move, DATASET_NO_VALUE
+    uint8_t distance;              // plies to the end with perfect play, DATASET_NO_DISTANCE
+    uint8_t ply;                   // discs on the board
+} dataset_record_t;
+
+typedef struct {
+    char magic[4];                 // "C4DS"
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t features;             // network inputs the records encode, 147
+    uint32_t flags;                // 0
+    uint64_t records;
+    uint64_t seed;                 // up to the producer (selfplay: its -s)
+    uint32_t records_crc;
+    uint8_t reserved[24];
+    uint32_t header_crc;
+} dataset_header_t;
+
+_Static_assert(sizeof(dataset_record_t) == 24, "dataset record layout");
+_Static_assert(sizeof(dataset_header_t) == 64, "dataset header layout");
+
+typedef struct {
+    FILE* file;
+    dataset_header_t header;
+} dataset_writer_t;
+
+typedef struct {
+    void* map;
+    size_t map_size;
+    dataset_header_t header;
+    const dataset_record_t* records;
+    uint64_t next;                 // first record of the next batch
+} dataset_reader_t;
+
+// Errors return -1 after printing the reason to stderr
+int dataset_create(dataset_writer_t* w, const char* path, uint64_t seed);
+int dataset_write(dataset_writer_t* w, const dataset_record_t* records, size_t count);
+int dataset_finish(dataset_writer_t* w);
+
+int dataset_open(dataset_reader_t* r, const char* path, int verify);
+size_t dataset_next_batch(dataset_reader_t* r, size_t max, const dataset_record_t** batch);
+void dataset_rewind(dataset_reader_t* r);
+void dataset_close(dataset_reader_t* r);
+
+void dataset_from_bitboard(const bitboard_t* pos, dataset_record_t* record);
+void dataset_to_bitboard(const dataset_record_t* record, bitboard_t* pos);
+void dataset_to_state(const dataset_record_t* record, ai_i8* state);
+
+uint32_t dataset_crc32(uint32_t crc, const void* data, size_t size);
+
+#endif /* TOOLS_DATASET_H_ */
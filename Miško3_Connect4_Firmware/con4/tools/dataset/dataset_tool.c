@@ -0,0 +1,121 @@
+/*
+ * dataset_tool.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Checks and summarises dataset files (dataset.h): verifies the checksums,
+ * reads every record through the mmap batch reader, decodes it to the 147
+ * network inputs and counts the targets. With -c every decoded input is
+ * also compared with get_state() of board.c on the same position, the
+ * check that the format still encodes what the firmware feeds the network.
+ *
+ * Usage: dataset [-c] [-b batch] file...
+ *   -c          compare with get_state()
+ *   -b batch    records per batch, default 4096
+ *
+ * Output CSV: dataset,file,records,seed,wins,draws,losses,no_outcome,valued,
+ * mismatches,seconds,records_per_s. The exit status is 1 if a file cannot be
+ * read or a record does not match.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dataset.h"
+
+// The decoded inputs feed this, so the compiler cannot drop the decoding
+static volatile unsigned sink;
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Does `state` match get_state() of the record's position?
+static int matches_board(const dataset_record_t* record, const ai_i8* state) {
+    ai_i8 expected[DATASET_FEATURES];
+    bitboard_t pos;
+
+    dataset_to_bitboard(record, &pos);
+    bb_to_board(&pos, game.board, game.PLAYER_AI, game.PLAYER_HUMAN);
+    get_state(expected);
+    return memcmp(state, expected, sizeof(expected)) == 0;
+}
+
+static int check_file(const char* path, int compare, size_t batch_size) {
+    dataset_reader_t r;
+    const dataset_record_t* batch;
+    unsigned long long outcomes[3] = { 0 }, unknown = 0, valued = 0, mismatches = 0;
+    char mismatch_text[24] = "";
+    double start, seconds;
+    size_t n;
+
+    if (dataset_open(&r, path, 1) != 0) {
+        return 0;
+    }
+
+    start = now_seconds();
+    while ((n = dataset_next_batch(&r, batch_size, &batch)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            ai_i8 state[DATASET_FEATURES];
+
+            dataset_to_state(&batch[i], state);
+            sink += state[DATASET_FEATURES - 1];
+            if (batch[i].outcome >= -1 && batch[i].outcome <= 1) {
+                outcomes[batch[i].outcome + 1]++;
+            } else {
+                unknown++;
+            }
+            valued += batch[i].value != DATASET_NO_VALUE;
+            if (compare && !matches_board(&batch[i], state)) {
+                if (mismatches++ == 0) {
+                    fprintf(stderr, "%s: record %llu does not match get_state()\n", path,
+                            (unsigned long long)(r.next - n + i));
+                }
+            }
+        }
+    }
+    seconds = now_seconds() - start;
+
+    if (compare) {
+        snprintf(mismatch_text, sizeof(mismatch_text), "%llu", mismatches);
+    }
+
+    printf("dataset,%s,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%s,%.3f,%.0f\n", path,
+           (unsigned long long)r.header.records, (unsigned long long)r.header.seed,
+           outcomes[2], outcomes[1], outcomes[0], unknown, valued, mismatch_text, seconds,
+           seconds > 0 ? r.header.records / seconds : 0);
+    dataset_close(&r);
+    return mismatches == 0;
+}
+
+int main(int argc, char** argv) {
+    int compare = 0, failures = 0;
+    long batch = 4096;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "cb:")) != -1) {
+        switch (opt) {
+            case 'c': compare = 1; break;
+            case 'b': batch = atol(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-c] [-b batch] file...\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind >= argc || batch < 1) {
+        fprintf(stderr, "usage: %s [-c] [-b batch] file...\n", argv[0]);
+        return 2;
+    }
+
+    printf("dataset,file,records,seed,wins,draws,losses,no_outcome,valued,mismatches,seconds,records_per_s\n");
+    for (int i = optind; i < argc; i++) {
+        failures += !check_file(argv[i], compare, batch);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,256 @@
+/*
+ * ai_simd.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Batched host kernel for python_model, see ai_simd.h.
+ *
+ * Positions go through the network AI_SIMD_BLOCK at a time. Per block and
+ * per group of AI_SIMD_LANES outputs the partial sums stay in registers
+ * while the inputs stream past: one load of transposed weights, then one
+ * broadcast and multiply-add per position. Hidden activations are kept
+ * padded to whole vectors; the padding has zero weights and bias, so it
+ * stays 0 through the ReLU and adds nothing to the next layer.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AI_SIMD_X86
+#endif
+
+#include "ai_simd.h"
+
+#define AI_SIMD_BLOCK    8              // positions per block
+#define PAD(n)           (((n) + AI_SIMD_LANES - 1) / AI_SIMD_LANES * AI_SIMD_LANES)
+#define HIDDEN_PAD       PAD(AI_KERNEL_HIDDEN)
+#define OUTPUT_PAD       PAD(AI_KERNEL_OUTPUTS)
+
+typedef struct {
+    float* weights;                     // [input][padded output]
+    float* bias;                        // [padded output]
+    int inputs;
+    int padded;
+    int relu;
+} simd_layer_t;
+
+// out[p * layer->padded + o] for the AI_SIMD_BLOCK positions in[p * in_stride + i]
+typedef void (*dense_fn_t)(const simd_layer_t* layer, const float* in, int in_stride, float* out);
+
+static simd_layer_t simd_layers[AI_KERNEL_LAYERS];
+static dense_fn_t dense;
+static ai_simd_isa_t selected;
+
+// ------------------- Kernels ---------------------
+
+// Sums in ai_kernel_dense()'s order (bias, then input 0, 1, ...) without
+// fused multiply-add, so the results are the same bit for bit. The inner
+// loop runs over outputs and the compiler vectorises it.
+static void dense_scalar(const simd_layer_t* layer, const float* in, int in_stride, float* out) {
+    for (int p = 0; p < AI_SIMD_BLOCK; p++) {
+        float* restrict acc = &out[p * layer->padded];
+
+        memcpy(acc, layer->bias, layer->padded * sizeof(float));
+        for (int i = 0; i < layer->inputs; i++) {
+            const float* restrict w = &layer->weights[i * layer->padded];
+            float x = in[p * in_stride + i];
+
+            for (int o = 0; o < layer->padded; o++) {
+                acc[o] += w[o] * x;
+            }
+        }
+        if (layer->relu) {
+            for (int o = 0; o < layer->padded; o++) {
+                acc[o] = (acc[o] < 0.0f) ? 0.0f : acc[o];
+            }
+        }
+    }
+}
+
+#ifdef AI_SIMD_X86
+
+// 4 positions x 16 outputs = 8 ymm accumulators
+__attribute__((target("avx2,fma")))
+static void dense_avx2(const simd_layer_t* layer, const float* in, int in_stride, float* out) {
+    const __m256 zero = _mm256_setzero_ps();
+
+    for (int p0 = 0; p0 < AI_SIMD_BLOCK; p0 += 4) {
+        for (int o = 0; o < layer->padded; o += AI_SIMD_LANES) {
+            __m256 acc[4][2];
+
+            for (int p = 0; p < 4; p++) {
+                acc[p][0] = _mm256_load_ps(&layer->bias[o]);
+                acc[p][1] = _mm256_load_ps(&layer->bias[o + 8]);
+            }
+            for (int i = 0; i < layer->inputs; i++) {
+                const float* w = &layer->weights[i * layer->padded + o];
+                __m256 w0 = _mm256_load_ps(w);
+                __m256 w1 = _mm256_load_ps(w + 8);
+
+                for (int p = 0; p < 4; p++) {
+                    __m256 x = _mm256_broadcast_ss(&in[(p0 + p) * in_stride + i]);
+                    acc[p][0] = _mm256_fmadd_ps(x, w0, acc[p][0]);
+                    acc[p][1] = _mm256_fmadd_ps(x, w1, acc[p][1]);
+                }
+            }
+            for (int p = 0; p < 4; p++) {
+                float* dst = &out[(p0 + p) * layer->padded + o];
+                if (layer->relu) {
+                    acc[p][0] = _mm256_max_ps(acc[p][0], zero);
+                    acc[p][1] = _mm256_max_ps(acc[p][1], zero);
+                }
+                _mm256_store_ps(dst, acc[p][0]);
+                _mm256_store_ps(dst + 8, acc[p][1]);
+            }
+        }
+    }
+}
+
+// 8 positions x 16 outputs = 8 zmm accumulators
+__attribute__((target("avx512f")))
+static void dense_avx512(const simd_layer_t* layer, const float* in, int in_stride, float* out) {
+    const __m512 zero = _mm512_setzero_ps();
+
+    for (int o = 0; o < layer->padded; o += AI_SIMD_LANES) {
+        __m512 acc[AI_SIMD_BLOCK];
+
+        for (int p = 0; p < AI_SIMD_BLOCK; p++) {
+            acc[p] = _mm512_load_ps(&layer->bias[o]);
+        }
+        for (int i = 0; i < layer->inputs; i++) {
+            __m512 w = _mm512_load_ps(&layer->weights[i * layer->padded + o]);
+
+            for (int p = 0; p < AI_SIMD_BLOCK; p++) {
+                acc[p] = _mm512_fmadd_ps(_mm512_set1_ps(in[p * in_stride + i]), w, acc[p]);
+            }
+        }
+        for (int p = 0; p < AI_SIMD_BLOCK; p++) {
+            if (layer->relu) {
+                acc[p] = _mm512_max_ps(acc[p], zero);
+            }
+            _mm512_store_ps(&out[p * layer->padded + o], acc[p]);
+        }
+    }
+}
+
+#endif /* AI_SIMD_X86 */
+
+// ------------------- Public ---------------------
+
+static const struct {
+    const char* name;
+    dense_fn_t fn;
+} isas[AI_SIMD_COUNT] = {
+    [AI_SIMD_SCALAR] = { "scalar", dense_scalar },
+#ifdef AI_SIMD_X86
+    [AI_SIMD_AVX2]   = { "avx2",   dense_avx2 },
+    [AI_SIMD_AVX512] = { "avx512", dense_avx512 },
+#else
+    [AI_SIMD_AVX2]   = { "avx2",   NULL },
+    [AI_SIMD_AVX512] = { "avx512", NULL },
+#endif
+};
+
+// Transposes the weights and selects the best path. Call once, before any
+// thread uses ai_simd_run_batch(). Returns -1 if out of memory.
+int ai_simd_init(void) {
+    for (int l = 0; l < AI_KERNEL_LAYERS; l++) {
+        const ai_kernel_layer_t* src = ai_kernel_layer(l);
+        simd_layer_t* dst = &simd_layers[l];
+
+        if (dst->weights) {
+            continue;
+        }
+        dst->inputs = src->inputs;
+        dst->padded = PAD(src->outputs);
+        dst->relu = src->relu;
+        dst->weights = aligned_alloc(64, (size_t)dst->inputs * dst->padded * sizeof(float));
+        dst->bias = aligned_alloc(64, dst->padded * sizeof(float));
+        if (!dst->weights || !dst->bias) {
+            return -1;
+        }
+        memset(dst->weights, 0, (size_t)dst->inputs * dst->padded * sizeof(float));
+        memset(dst->bias, 0, dst->padded * sizeof(float));
+        for (int o = 0; o < src->outputs; o++) {
+            dst->bias[o] = src->bias[o];
+            for (int i = 0; i < src->inputs; i++) {
+                dst->weights[i * dst->padded + o] = src->weights[o * src->inputs + i];
+            }
+        }
+    }
+    return ai_simd_select(ai_simd_best());
+}
+
+int ai_simd_supported(ai_simd_isa_t isa) {
+    switch (isa) {
+        case AI_SIMD_SCALAR:
+            return 1;
+#ifdef AI_SIMD_X86
+        case AI_SIMD_AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case AI_SIMD_AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return 0;
+    }
+}
+
+ai_simd_isa_t ai_simd_best(void) {
+    ai_simd_isa_t best = AI_SIMD_SCALAR;
+
+    for (int isa = AI_SIMD_SCALAR; isa < AI_SIMD_COUNT; isa++) {
+        if (ai_simd_supported(isa)) {
+            best = isa;
+        }
+    }
+    return best;
+}
+
+// Returns -1 if the CPU cannot run `isa`
+int ai_simd_select(ai_simd_isa_t isa) {
+    if (isa >= AI_SIMD_COUNT || !ai_simd_supported(isa)) {
+        return -1;
+    }
+    selected = isa;
+    dense = isas[isa].fn;
+    return 0;
+}
+
+ai_simd_isa_t ai_simd_selected(void) {
+    return selected;
+}
+
+const char* ai_simd_name(ai_simd_isa_t isa) {
+    return (isa < AI_SIMD_COUNT) ? isas[isa].name : "?";
+}
+
+// ai_kernel_run() on `count` positions, AI_KERNEL_INPUTS floats each in and
+// AI_KERNEL_OUTPUTS out, with the path ai_simd_init() or ai_simd_select() chose
+void ai_simd_run_batch(const float* inputs, float* outputs, int count) {
+    _Alignas(64) float tail[AI_SIMD_BLOCK * AI_KERNEL_INPUTS];
+    _Alignas(64) float hidden1[AI_SIMD_BLOCK * HIDDEN_PAD];
+    _Alignas(64) float hidden2[AI_SIMD_BLOCK * HIDDEN_PAD];
+    _Alignas(64) float values[AI_SIMD_BLOCK * OUTPUT_PAD];
+
+    for (int b = 0; b < count; b += AI_SIMD_BLOCK) {
+        const float* in = &inputs[b * AI_KERNEL_INPUTS];
+        int n = (count - b < AI_SIMD_BLOCK) ? count - b : AI_SIMD_BLOCK;
+
+        // A short last block is padded with empty positions
+        if (n < AI_SIMD_BLOCK) {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, in, n * AI_KERNEL_INPUTS * sizeof(float));
+            in = tail;
+        }
+        dense(&simd_layers[0], in, AI_KERNEL_INPUTS, hidden1);
+        dense(&simd_layers[1], hidden1, HIDDEN_PAD, hidden2);
+        dense(&simd_layers[2], hidden2, HIDDEN_PAD, values);
+        for (int p = 0; p < n; p++) {
+            memcpy(&outputs[(b + p) * AI_KERNEL_OUTPUTS], &values[p * OUTPUT_PAD],
+                   AI_KERNEL_OUTPUTS * sizeof(float));
+        }
+    }
+}
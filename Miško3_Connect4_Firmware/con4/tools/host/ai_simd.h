@@ -0,0 +1,43 @@
+/*
+ * ai_simd.h
+ *
+ *  Created on: 19 Oct 2026
+ */
+
+#ifndef TOOLS_HOST_AI_SIMD_H_
+#define TOOLS_HOST_AI_SIMD_H_
+
+#include "ai_kernel.h"
+
+/*
+ * Batched python_model for the host tools, with the weights transposed
+ * once to [input][output] and the outputs padded to AI_SIMD_LANES, so one
+ * vector of weights serves a block of positions per input. The bias is the
+ * starting value and ReLU is applied on the way out.
+ *
+ * Three paths, picked at run time from what the CPU supports: scalar
+ * (plain C, bit-exact with ai_kernel_run()), AVX2+FMA and AVX-512. The
+ * fused multiply-add rounds once instead of twice, so the vector paths
+ * differ from ai_kernel_run() in the last bits; tools/ai_batch reports by
+ * how much.
+ */
+
+#define AI_SIMD_LANES    16              // output padding, one AVX-512 vector
+
+typedef enum {
+    AI_SIMD_SCALAR = 0,
+    AI_SIMD_AVX2,
+    AI_SIMD_AVX512,
+    AI_SIMD_COUNT
+} ai_simd_isa_t;
+
+int ai_simd_init(void);
+int ai_simd_supported(ai_simd_isa_t isa);
+ai_simd_isa_t ai_simd_best(void);
+int ai_simd_select(ai_simd_isa_t isa);
+ai_simd_isa_t ai_simd_selected(void);
+const char* ai_simd_name(ai_simd_isa_t isa);
+
+void ai_simd_run_batch(const float* inputs, float* outputs, int count);
+
+#endif /* TOOLS_HOST_AI_SIMD_H_ */
@@ -0,0 +1,47 @@
+/*
+ * cycle_clock_host.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Host replacement for the DWT counter access in system/cycle_timer.c
+ * (built with CYCLE_HOST_CLOCK). One "cycle" is one nanosecond of
+ * CLOCK_MONOTONIC, so CYCLE_hz() is 1 GHz and the 32-bit counter wraps
+ * every ~4.3 s; cycle_timer_t statistics and CYCLE_print_all() work as on
+ * the board.
+ */
+
+#include <time.h>
+
+#include "cycle_timer.h"
+
+#define HOST_CLOCK_HZ    1000000000u
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * HOST_CLOCK_HZ + ts.tv_nsec;
+}
+
+void CYCLE_init(void) {
+}
+
+uint32_t CYCLE_now(void) {
+    return (uint32_t)host_ns();
+}
+
+uint64_t CYCLE_now64(void) {
+    return host_ns();
+}
+
+uint32_t CYCLE_hz(void) {
+    return HOST_CLOCK_HZ;
+}
+
+uint32_t CYCLE_to_us(uint32_t cycles) {
+    return cycles / (HOST_CLOCK_HZ / 1000000);
+}
+
+uint32_t CYCLE_to_ns(uint32_t cycles) {
+    return cycles;
+}
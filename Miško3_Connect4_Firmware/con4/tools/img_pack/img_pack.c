@@ -0,0 +1,510 @@
+/*
+ * img_pack.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Host tool that packs the raw RGB565 end-screen bitmaps into the
+ * compressed format decoded by Aplication/image_decoder.c.
+ *
+ * Usage: img_pack [-c colours] <images_raw.h> <images.h>
+ *
+ * Every "const static uint16_t NAME[]" array of the input header (together
+ * with its NAME_WIDTH / NAME_HEIGHT defines) is reduced to a palette of at
+ * most 256 distinct colours (median cut, exact when the image already has
+ * fewer colours) and the palette indices are coded line by line with three
+ * tokens:
+ *
+ *   0x00..0x7F -> (token + 1) literal pixels, that many index bytes follow
+ *   0x80..0xBF -> run of (token & 0x3F) + 2 pixels, one index byte follows
+ *   0xC0..0xFF -> copy (token & 0x3F) + 2 pixels from the line above
+ *
+ * Tokens never cross a line, so the firmware can decode one line at a time
+ * while it still holds the previous line.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+
+#define MAX_IMAGES   8
+#define MAX_COLOURS  256
+#define RUN_MIN      2
+#define RUN_MAX      (0x3F + RUN_MIN)
+#define LITERAL_MAX  0x80
+
+#define TOKEN_RUN    0x80
+#define TOKEN_COPY   0xC0
+
+typedef struct {
+    char name[64];
+    int width;
+    int height;
+    uint16_t* pixels;
+} raw_image_t;
+
+typedef struct {
+    uint16_t colour;
+    uint32_t count;
+} colour_count_t;
+
+typedef struct {
+    int first;   // index into the colour table
+    int count;   // number of distinct colours in the box
+} box_t;
+
+// ------------------- Input parsing ---------------------
+
+static char* read_file(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    char* text = malloc(size + 1);
+    if (fread(text, 1, size, f) != (size_t)size) {
+        perror(path);
+        fclose(f);
+        free(text);
+        return NULL;
+    }
+    text[size] = '\0';
+    fclose(f);
+    return text;
+}
+
+/* Look up "#define <NAME>_<suffix> <value>", NAME in upper case */
+static int find_define(const char* text, const char* name, const char* suffix) {
+    char key[128];
+    int n = snprintf(key, sizeof(key), "#define ");
+    for (const char* c = name; *c; c++) {
+        key[n++] = (char)toupper((unsigned char)*c);
+    }
+    snprintf(key + n, sizeof(key) - n, "_%s", suffix);
+
+    const char* at = strstr(text, key);
+    if (!at) {
+        return -1;
+    }
+    return atoi(at + strlen(key));
+}
+
+static int parse_images(char* text, raw_image_t* images) {
+    int num = 0;
+    char* at = text;
+    const char* marker = "const static uint16_t";
+
+    while ((at = strstr(at, marker)) != NULL && num < MAX_IMAGES) {
+        raw_image_t* img = &images[num];
+        at += strlen(marker);
+        while (isspace((unsigned char)*at)) at++;
+
+        int n = 0;
+        while ((isalnum((unsigned char)*at) || *at == '_') && n < (int)sizeof(img->name) - 1) {
+            img->name[n++] = *at++;
+        }
+        img->name[n] = '\0';
+
+        img->width = find_define(text, img->name, "WIDTH");
+        img->height = find_define(text, img->name, "HEIGHT");
+        if (img->width <= 0 || img->height <= 0) {
+            fprintf(stderr, "img_pack: missing size defines for %s\n", img->name);
+            return -1;
+        }
+
+        at = strchr(at, '{');
+        if (!at) {
+            return -1;
+        }
+        at++;
+
+        int total = img->width * img->height;
+        img->pixels = malloc(total * sizeof(uint16_t));
+        for (int i = 0; i < total; i++) {
+            char* end;
+            unsigned long value = strtoul(at, &end, 16);
+            if (end == at) {
+                fprintf(stderr, "img_pack: %s has %d pixels, expected %d\n", img->name, i, total);
+                return -1;
+            }
+            img->pixels[i] = (uint16_t)value;
+            at = end;
+            while (*at == ',' || isspace((unsigned char)*at)) at++;
+        }
+        num++;
+    }
+    return num;
+}
+
+// ------------------- Palette (median cut) ---------------------
+
+static int channel(uint16_t c, int ch) {
+    switch (ch) {
+        case 0:  return ((c >> 11) & 0x1F) << 3;  // R
+        case 1:  return ((c >> 5) & 0x3F) << 2;   // G
+        default: return (c & 0x1F) << 3;          // B
+    }
+}
+
+static uint16_t to_rgb565(int r, int g, int b) {
+    return (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+static int sort_channel;
+
+static int compare_channel(const void* a, const void* b) {
+    const colour_count_t* ca = a;
+    const colour_count_t* cb = b;
+    return channel(ca->colour, sort_channel) - channel(cb->colour, sort_channel);
+}
+
+static int box_range(const colour_count_t* colours, const box_t* box, int* widest) {
+    int best = -1;
+    *widest = 0;
+    for (int ch = 0; ch < 3; ch++) {
+        int lo = 255, hi = 0;
+        for (int i = box->first; i < box->first + box->count; i++) {
+            int v = channel(colours[i].colour, ch);
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+        }
+        if (hi - lo > best) {
+            best = hi - lo;
+            *widest = ch;
+        }
+    }
+    return best;
+}
+
+/* Split the colours into at most num_wanted boxes, one palette colour per box */
+static int median_cut(colour_count_t* colours, int distinct, int num_wanted, uint16_t* palette) {
+    box_t* boxes = malloc(num_wanted * sizeof(box_t));
+    int num_boxes = 1;
+    boxes[0].first = 0;
+    boxes[0].count = distinct;
+
+    while (num_boxes < num_wanted) {
+        // Split the box with the widest channel range weighted by pixel count
+        int split = -1, split_channel = 0;
+        double split_score = 0;
+        for (int b = 0; b < num_boxes; b++) {
+            if (boxes[b].count < 2) continue;
+            int ch;
+            int range = box_range(colours, &boxes[b], &ch);
+            uint32_t pixels = 0;
+            for (int i = boxes[b].first; i < boxes[b].first + boxes[b].count; i++) {
+                pixels += colours[i].count;
+            }
+            double score = (double)range * pixels;
+            if (score > split_score) {
+                split_score = score;
+                split = b;
+                split_channel = ch;
+            }
+        }
+        if (split < 0) break;
+
+        box_t* box = &boxes[split];
+        sort_channel = split_channel;
+        qsort(&colours[box->first], box->count, sizeof(colour_count_t), compare_channel);
+
+        // Weighted median
+        uint32_t half = 0, acc = 0;
+        for (int i = box->first; i < box->first + box->count; i++) half += colours[i].count;
+        half /= 2;
+        int cut = box->first + 1;
+        for (int i = box->first; i < box->first + box->count - 1; i++) {
+            acc += colours[i].count;
+            if (acc >= half) {
+                cut = i + 1;
+                break;
+            }
+        }
+
+        boxes[num_boxes].first = cut;
+        boxes[num_boxes].count = box->first + box->count - cut;
+        box->count = cut - box->first;
+        num_boxes++;
+    }
+
+    for (int b = 0; b < num_boxes; b++) {
+        double r = 0, g = 0, bl = 0, n = 0;
+        for (int i = boxes[b].first; i < boxes[b].first + boxes[b].count; i++) {
+            r  += channel(colours[i].colour, 0) * (double)colours[i].count;
+            g  += channel(colours[i].colour, 1) * (double)colours[i].count;
+            bl += channel(colours[i].colour, 2) * (double)colours[i].count;
+            n  += colours[i].count;
+        }
+        palette[b] = to_rgb565((int)(r / n + 0.5), (int)(g / n + 0.5), (int)(bl / n + 0.5));
+    }
+
+    free(boxes);
+    return num_boxes;
+}
+
+/* Drop repeated colours, keeping the first of each. Returns the new size. */
+static int dedup_palette(uint16_t* palette, int num_colours) {
+    int num = 0;
+    for (int i = 0; i < num_colours; i++) {
+        int j = 0;
+        while (j < num && palette[j] != palette[i]) j++;
+        if (j == num) {
+            palette[num++] = palette[i];
+        }
+    }
+    return num;
+}
+
+static int build_palette(const raw_image_t* img, int max_colours, uint16_t* palette) {
+    int total = img->width * img->height;
+    colour_count_t* colours = calloc(total, sizeof(colour_count_t));
+    colour_count_t* work = calloc(total, sizeof(colour_count_t));
+    int distinct = 0;
+
+    // Histogram of distinct colours
+    uint32_t* histogram = calloc(65536, sizeof(uint32_t));
+    for (int i = 0; i < total; i++) {
+        histogram[img->pixels[i]]++;
+    }
+    for (int c = 0; c < 65536; c++) {
+        if (histogram[c]) {
+            colours[distinct].colour = (uint16_t)c;
+            colours[distinct].count = histogram[c];
+            distinct++;
+        }
+    }
+    free(histogram);
+
+    if (distinct <= max_colours) {
+        for (int i = 0; i < distinct; i++) {
+            palette[i] = colours[i].colour;
+        }
+        free(colours);
+        free(work);
+        return distinct;
+    }
+
+    /*
+     * Boxes whose averages round to the same RGB565 colour leave repeated
+     * entries that nearest() never picks. Merge them and cut more boxes
+     * until the palette is full of distinct colours again.
+     */
+    int num_colours = 0;
+    for (int wanted = max_colours; wanted <= distinct; wanted++) {
+        uint16_t candidate[2 * MAX_COLOURS];
+        memcpy(work, colours, distinct * sizeof(colour_count_t));
+        int num = dedup_palette(candidate, median_cut(work, distinct, wanted, candidate));
+        if (num > max_colours) {
+            break;
+        }
+        memcpy(palette, candidate, num * sizeof(uint16_t));
+        num_colours = num;
+        if (num == max_colours || wanted >= 2 * MAX_COLOURS) {
+            break;
+        }
+    }
+
+    free(colours);
+    free(work);
+    return num_colours;
+}
+
+static uint8_t nearest(const uint16_t* palette, int num_colours, uint16_t colour) {
+    int best = 0;
+    long best_dist = -1;
+    for (int i = 0; i < num_colours; i++) {
+        long dr = channel(colour, 0) - channel(palette[i], 0);
+        long dg = channel(colour, 1) - channel(palette[i], 1);
+        long db = channel(colour, 2) - channel(palette[i], 2);
+        long dist = 3 * dr * dr + 4 * dg * dg + 2 * db * db;
+        if (best_dist < 0 || dist < best_dist) {
+            best_dist = dist;
+            best = i;
+        }
+    }
+    return (uint8_t)best;
+}
+
+// ------------------- Run-length coding ---------------------
+
+/* Length of the repeated-index run starting at x */
+static int run_length(const uint8_t* line, int width, int x) {
+    int run = 1;
+    while (x + run < width && line[x + run] == line[x] && run < RUN_MAX) run++;
+    return run;
+}
+
+/* Length of the stretch starting at x that matches the line above */
+static int copy_length(const uint8_t* line, const uint8_t* above, int width, int x) {
+    int copy = 0;
+    if (!above) return 0;
+    while (x + copy < width && line[x + copy] == above[x + copy] && copy < RUN_MAX) copy++;
+    return copy;
+}
+
+static int encode_line(const uint8_t* line, const uint8_t* above, int width, uint8_t* out) {
+    int n = 0;
+    int x = 0;
+
+    while (x < width) {
+        int run = run_length(line, width, x);
+        int copy = copy_length(line, above, width, x);
+
+        if (copy >= RUN_MIN && copy >= run) {
+            out[n++] = (uint8_t)(TOKEN_COPY | (copy - RUN_MIN));
+            x += copy;
+            continue;
+        }
+        if (run >= RUN_MIN) {
+            out[n++] = (uint8_t)(TOKEN_RUN | (run - RUN_MIN));
+            out[n++] = line[x];
+            x += run;
+            continue;
+        }
+
+        // Collect literals until a run or copy of at least RUN_MIN pixels starts
+        int start = x;
+        int count = 0;
+        while (x < width && count < LITERAL_MAX) {
+            if (run_length(line, width, x) >= RUN_MIN ||
+                copy_length(line, above, width, x) >= RUN_MIN) {
+                break;
+            }
+            x++;
+            count++;
+        }
+        out[n++] = (uint8_t)(count - 1);
+        memcpy(&out[n], &line[start], count);
+        n += count;
+    }
+    return n;
+}
+
+// ------------------- Output ---------------------
+
+static void write_bytes(FILE* f, const uint8_t* data, int size) {
+    for (int i = 0; i < size; i++) {
+        fprintf(f, "%s0x%02x,%s", (i % 16) ? " " : "  ", data[i], (i % 16 == 15 || i == size - 1) ? "\n" : "");
+    }
+}
+
+static void write_words(FILE* f, const uint16_t* data, int size) {
+    for (int i = 0; i < size; i++) {
+        fprintf(f, "%s0x%04x,%s", (i % 12) ? " " : "  ", data[i], (i % 12 == 11 || i == size - 1) ? "\n" : "");
+    }
+}
+
+static void upper(char* dst, const char* src) {
+    while (*src) *dst++ = (char)toupper((unsigned char)*src++);
+    *dst = '\0';
+}
+
+int main(int argc, char** argv) {
+    int max_colours = MAX_COLOURS;
+    int arg = 1;
+
+    if (argc > 2 && strcmp(argv[1], "-c") == 0) {
+        max_colours = atoi(argv[2]);
+        arg = 3;
+    }
+    if (argc - arg != 2 || max_colours < 2 || max_colours > MAX_COLOURS) {
+        fprintf(stderr, "usage: img_pack [-c colours] <images_raw.h> <images.h>\n");
+        return 1;
+    }
+
+    char* text = read_file(argv[arg]);
+    if (!text) return 1;
+
+    raw_image_t images[MAX_IMAGES];
+    int num_images = parse_images(text, images);
+    if (num_images <= 0) {
+        fprintf(stderr, "img_pack: no images found in %s\n", argv[arg]);
+        return 1;
+    }
+
+    FILE* out = fopen(argv[arg + 1], "w");
+    if (!out) {
+        perror(argv[arg + 1]);
+        return 1;
+    }
+
+    fprintf(out,
+        "/*\n"
+        " * images.h\n"
+        " *\n"
+        " * End-screen bitmaps in the packed (palette + run-length) format.\n"
+        " * Generated by tools/img_pack from tools/img_pack/images_raw.h - do not edit.\n"
+        " */\n\n"
+        "#ifndef INLCUDE_IMAGES_H_\n"
+        "#define INLCUDE_IMAGES_H_\n\n"
+        "#include \"stdint.h\"\t\t// support for data type definitions\n"
+        "#include \"image_decoder.h\"\n\n"
+        "#define SCREEN_WITH 320\n"
+        "#define SCREEN_HEIGHT 240\n\n");
+
+    size_t raw_total = 0, packed_total = 0;
+
+    for (int i = 0; i < num_images; i++) {
+        raw_image_t* img = &images[i];
+        char name_upper[64];
+        upper(name_upper, img->name);
+
+        uint16_t palette[MAX_COLOURS];
+        int num_colours = build_palette(img, max_colours, palette);
+
+        uint8_t* indices = malloc((size_t)img->width * img->height);
+        uint8_t* packed = malloc((size_t)img->height * (img->width + img->width / LITERAL_MAX + 1));
+        int packed_size = 0;
+
+        for (int y = 0; y < img->height; y++) {
+            uint8_t* line = &indices[y * img->width];
+            for (int x = 0; x < img->width; x++) {
+                line[x] = nearest(palette, num_colours, img->pixels[y * img->width + x]);
+            }
+            packed_size += encode_line(line, y ? line - img->width : NULL, img->width, packed + packed_size);
+        }
+
+        size_t raw_size = (size_t)img->width * img->height * sizeof(uint16_t);
+        size_t total_size = packed_size + num_colours * sizeof(uint16_t);
+        raw_total += raw_size;
+        packed_total += total_size;
+
+        fprintf(out, "#define %s_HEIGHT %d\n#define %s_WIDTH %d\n\n", name_upper, img->height, name_upper, img->width);
+        fprintf(out, "// %d colours, %d packed bytes (raw %zu bytes)\n", num_colours, packed_size, raw_size);
+        fprintf(out, "const static uint16_t %s_palette[] = {\n", img->name);
+        write_words(out, palette, num_colours);
+        fprintf(out, "};\n\n");
+        fprintf(out, "const static uint8_t %s_data[] = {\n", img->name);
+        write_bytes(out, packed, packed_size);
+        fprintf(out, "};\n\n");
+        fprintf(out,
+            "const static packed_image_t %s = {\n"
+            "    .width   = %s_WIDTH,\n"
+            "    .height  = %s_HEIGHT,\n"
+            "    .palette = %s_palette,\n"
+            "    .data    = %s_data,\n"
+            "    .size    = sizeof(%s_data)\n"
+            "};\n\n\n",
+            img->name, name_upper, name_upper, img->name, img->name, img->name);
+
+        printf("%-12s %3dx%-3d %3d colours %7zu -> %6zu bytes (%.2fx)\n",
+               img->name, img->width, img->height, num_colours, raw_size, total_size,
+               (double)raw_size / total_size);
+
+        free(indices);
+        free(packed);
+        free(img->pixels);
+    }
+
+    fprintf(out, "#endif /* INLCUDE_IMAGES_H_ */\n");
+    fclose(out);
+    free(text);
+
+    printf("total        %zu -> %zu bytes (%.2fx)\n", raw_total, packed_total, (double)raw_total / packed_total);
+    return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * joy_filter_test.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Unit test of system/joy_filter.c: fixed sample sequences go through the
+ * filter, the dead zone and the stepper, and every output is compared with
+ * the value worked out by hand from the parameters in joy_filter.h.
+ *
+ * Usage: joy_filter_test      (exit status 1 if any check fails)
+ * Run by `make test` here and by ctest in the tools/ CMake build.
+ */
+
+#include <stdio.h>
+
+#include "joy_filter.h"
+
+#define CENTER        2048
+#define HALF_RANGE    2048
+
+static int failures;
+
+#define CHECK_EQ(actual, expected)                                                  \
+    do {                                                                            \
+        long a_ = (long)(actual), e_ = (long)(expected);                            \
+        if (a_ != e_) {                                                             \
+            printf("%s:%d: %s = %ld, expected %ld\n", __FILE__, __LINE__, #actual, \
+                   a_, e_);                                                         \
+            failures++;                                                             \
+        }                                                                           \
+    } while (0)
+
+// Steps the stepper gives for `deflection` held for `ms` milliseconds in dt_ms updates
+static int steps_for(joy_stepper_t* stepper, int8_t deflection, uint32_t ms, uint32_t dt_ms) {
+    int steps = 0;
+    for (uint32_t t = 0; t < ms; t += dt_ms) {
+        steps += JOY_STEP_update(stepper, deflection, dt_ms);
+    }
+    return steps;
+}
+
+// ---- Filter ----
+
+static void test_filter_steady(void) {
+    joy_filter_t f;
+
+    JOY_FILTER_init(&f, CENTER);
+    for (int i = 0; i < 100; i++) {
+        CHECK_EQ(JOY_FILTER_update(&f, CENTER), CENTER);
+    }
+}
+
+// The median of three removes single-sample spikes completely
+static void test_filter_spike(void) {
+    const uint16_t in[] = { 2000, 4095, 2000, 2000, 0, 2000, 2000 };
+    joy_filter_t f;
+
+    JOY_FILTER_init(&f, 2000);
+    for (unsigned i = 0; i < sizeof(in) / sizeof(in[0]); i++) {
+        CHECK_EQ(JOY_FILTER_update(&f, in[i]), 2000);
+    }
+}
+
+// Step 0 -> 1600: the median delays it by one sample, then y += (x - y) / 8 in Q4
+static void test_filter_step(void) {
+    const uint16_t expected[] = { 0, 200, 375, 528, 662 };
+    joy_filter_t f;
+    uint16_t out = 0;
+
+    JOY_FILTER_init(&f, 0);
+    for (unsigned i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        CHECK_EQ(JOY_FILTER_update(&f, 1600), expected[i]);
+    }
+    // Settles on the input exactly, not one LSB short
+    for (int i = 0; i < 200; i++) {
+        out = JOY_FILTER_update(&f, 1600);
+    }
+    CHECK_EQ(out, 1600);
+}
+
+// ---- Dead zone ----
+
+static void test_dead_zone(void) {
+    // 15 % of 2048 ends between 327 (15.96 %) and 328 (16.02 %) counts from the centre
+    CHECK_EQ(JOY_FILTER_deflection(CENTER, CENTER, HALF_RANGE), 0);
+    CHECK_EQ(JOY_FILTER_deflection(CENTER + 327, CENTER, HALF_RANGE), 0);
+    CHECK_EQ(JOY_FILTER_deflection(CENTER + 328, CENTER, HALF_RANGE), 1);
+    CHECK_EQ(JOY_FILTER_deflection(CENTER - 327, CENTER, HALF_RANGE), 0);
+    CHECK_EQ(JOY_FILTER_deflection(CENTER - 328, CENTER, HALF_RANGE), -1);
+
+    // The rest of the range is stretched to 1..100
+    CHECK_EQ(JOY_FILTER_deflection(CENTER + 1024, CENTER, HALF_RANGE), 41);     // 50 %
+    CHECK_EQ(JOY_FILTER_deflection(4095, CENTER, HALF_RANGE), 98);              // 99 %
+    CHECK_EQ(JOY_FILTER_deflection(0, CENTER, HALF_RANGE), -100);
+
+    // Past the calibrated range it saturates; no range, no deflection
+    CHECK_EQ(JOY_FILTER_deflection(CENTER + 1500, CENTER, 1000), 100);
+    CHECK_EQ(JOY_FILTER_deflection(CENTER - 1500, CENTER, 1000), -100);
+    CHECK_EQ(JOY_FILTER_deflection(4095, CENTER, 0), 0);
+}
+
+// ---- Stepper ----
+
+static void test_step_hysteresis(void) {
+    joy_stepper_t s;
+
+    JOY_STEP_init(&s);
+    CHECK_EQ(JOY_STEP_update(&s, 0, 1), 0);
+
+    // Leaving the dead zone steps at once
+    CHECK_EQ(JOY_STEP_update(&s, 50, 1), 1);
+    CHECK_EQ(JOY_STEP_update(&s, 50, 1), 0);
+
+    // Back in the dead zone for less than JOY_STEP_RELEASE_MS: still held,
+    // so coming out again is not a new first step
+    CHECK_EQ(steps_for(&s, 0, JOY_STEP_RELEASE_MS - 1, 1), 0);
+    CHECK_EQ(JOY_STEP_update(&s, 50, 1), 0);
+
+    // Released after JOY_STEP_RELEASE_MS: the next push steps at once again
+    CHECK_EQ(steps_for(&s, 0, JOY_STEP_RELEASE_MS, 1), 0);
+    CHECK_EQ(JOY_STEP_update(&s, 50, 1), 1);
+
+    // Reversing needs no release
+    CHECK_EQ(JOY_STEP_update(&s, -50, 1), -1);
+    CHECK_EQ(JOY_STEP_update(&s, 50, 1), 1);
+
+    // Chatter across the dead zone edge every sample gives only the first step
+    JOY_STEP_init(&s);
+    int steps = 0;
+    for (int i = 0; i < 50; i++) {
+        steps += JOY_STEP_update(&s, (i & 1) ? 0 : 1, 1);
+    }
+    CHECK_EQ(steps, 1);
+}
+
+static void test_step_repeat(void) {
+    joy_stepper_t s;
+
+    // Full deflection: JOY_STEP_RATE_MAX steps per second after the first one
+    JOY_STEP_init(&s);
+    CHECK_EQ(JOY_STEP_update(&s, 100, 1), 1);
+    CHECK_EQ(steps_for(&s, 100, 99, 1), 0);
+    CHECK_EQ(JOY_STEP_update(&s, 100, 1), 1);      // 100 ms after the first
+    CHECK_EQ(steps_for(&s, 100, 900, 1), JOY_STEP_RATE_MAX - 1);
+
+    // Just past the dead zone: JOY_STEP_RATE_MIN (+1 %), the second step after 481 ms
+    JOY_STEP_init(&s);
+    CHECK_EQ(JOY_STEP_update(&s, 1, 1), 1);
+    CHECK_EQ(steps_for(&s, 1, 480, 1), 0);
+    CHECK_EQ(JOY_STEP_update(&s, 1, 1), 1);
+
+    // In DMA blocks of 16 ms the remainder carries over, so the rate is the same
+    JOY_STEP_init(&s);
+    CHECK_EQ(JOY_STEP_update(&s, 100, 16), 1);
+    CHECK_EQ(steps_for(&s, 100, 1600, 16), 16);
+}
+
+int main(void) {
+    test_filter_steady();
+    test_filter_spike();
+    test_filter_step();
+    test_dead_zone();
+    test_step_hysteresis();
+    test_step_repeat();
+
+    if (failures) {
+        printf("joy_filter_test: %d checks failed\n", failures);
+        return 1;
+    }
+    printf("joy_filter_test: all checks passed\n");
+    return 0;
+}
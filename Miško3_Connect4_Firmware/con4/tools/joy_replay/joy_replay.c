@@ -0,0 +1,207 @@
+/*
+ * joy_replay.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Runs recorded joystick samples through the firmware filter
+ * (system/joy_filter.c) the same way system/joystick.c does in the DMA
+ * callbacks, block by block, and prints what the game would have seen.
+ *
+ * Recording: send 'j' over the serial port to start and stop, then
+ *   trace_decode capture.bin | joy_replay
+ * Any line of the form "x,y" is taken as one sample; other lines are skipped.
+ *
+ * Usage: joy_replay [-b block] [-r hz] [-h half_range] [-v] [file]
+ *        joy_replay -s            write a synthetic trace (noise, spikes, tilts)
+ *   -b block       samples per axis per DMA half buffer, default 16 (JOY_DMA_BLOCK)
+ *   -r hz          sample rate, default 1000 (JOY_SAMPLE_RATE_HZ)
+ *   -h half_range  half of the axis range, default 2048 (JOY_DEFAULT_HALF_RANGE)
+ *   -v             print every block as CSV: ms,x,y,deflection_x,deflection_y,column
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "joy_filter.h"
+
+#define AXES           2
+#define MAX_BLOCK      256
+#define COLUMNS        7
+
+typedef struct {
+    uint32_t count;
+    double sum;
+    double sum_sq;
+    uint16_t min;
+    uint16_t max;
+} axis_stats_t;
+
+static void stats_add(axis_stats_t* s, uint16_t v) {
+    if (s->count == 0 || v < s->min) {
+        s->min = v;
+    }
+    if (s->count == 0 || v > s->max) {
+        s->max = v;
+    }
+    s->count++;
+    s->sum += v;
+    s->sum_sq += (double)v * v;
+}
+
+static void stats_print(const char* name, const axis_stats_t* s) {
+    double mean, var;
+
+    if (s->count == 0) {
+        printf("%-12s no samples\n", name);
+        return;
+    }
+    mean = s->sum / s->count;
+    var = s->sum_sq / s->count - mean * mean;
+    printf("%-12s mean %7.1f  std %6.2f  peak-to-peak %4u\n",
+           name, mean, var > 0 ? sqrt(var) : 0, s->max - s->min);
+}
+
+// ------------------- Synthetic trace ---------------------
+
+static double noise(void) {
+    return (rand() / (double)RAND_MAX - 0.5) * 2;
+}
+
+// Rest, full tilt right, rest, half tilt left, rest; 12-bit noise and
+// single-sample spikes as seen with long joystick wires
+static void synthesize(void) {
+    static const struct { int ms; double x; } phases[] = {
+        { 500, 0 }, { 1000, 1.0 }, { 500, 0 }, { 1500, -0.5 }, { 500, 0 },
+    };
+    const double center = 2048, half = 1900;
+
+    srand(1);
+    for (unsigned p = 0; p < sizeof(phases) / sizeof(phases[0]); p++) {
+        for (int ms = 0; ms < phases[p].ms; ms++) {
+            double x = center + phases[p].x * half + 12 * noise();
+            double y = center + 12 * noise();
+
+            if (rand() % 100 == 0) {
+                x += (rand() % 2 ? 1 : -1) * 900;
+            }
+            if (x < 0) x = 0;
+            if (x > 4095) x = 4095;
+            printf("%d,%d\n", (int)x, (int)y);
+        }
+    }
+}
+
+// ------------------- Main ---------------------
+
+int main(int argc, char** argv) {
+    FILE* in = stdin;
+    int block_len = 16, rate = 1000, half_range = 2048, verbose = 0;
+    uint16_t block[MAX_BLOCK][AXES];
+    joy_filter_t filter[AXES];
+    joy_stepper_t stepper;
+    uint16_t center[AXES];
+    axis_stats_t raw_rest[AXES] = { 0 }, filtered_rest[AXES] = { 0 };
+    int n = 0, blocks = 0, centered = 0, column = COLUMNS / 2, steps = 0;
+    char line[256];
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:r:h:vs")) != -1) {
+        switch (opt) {
+            case 'b': block_len = atoi(optarg); break;
+            case 'r': rate = atoi(optarg); break;
+            case 'h': half_range = atoi(optarg); break;
+            case 'v': verbose = 1; break;
+            case 's': synthesize(); return 0;
+            default:
+                fprintf(stderr, "usage: %s [-b block] [-r hz] [-h half_range] [-v] [file] | -s\n", argv[0]);
+                return 2;
+        }
+    }
+    if (block_len < 1 || block_len > MAX_BLOCK || rate < 1) {
+        fprintf(stderr, "bad block length or rate\n");
+        return 2;
+    }
+    if (optind < argc && !(in = fopen(argv[optind], "r"))) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    JOY_STEP_init(&stepper);
+    if (verbose) {
+        printf("ms,x,y,deflection_x,deflection_y,column\n");
+    }
+
+    while (fgets(line, sizeof(line), in)) {
+        unsigned x, y;
+        uint16_t value[AXES];
+        int8_t deflection[AXES], step;
+
+        if (sscanf(line, " %u,%u", &x, &y) != 2) {
+            continue;
+        }
+        block[n][0] = x;
+        block[n][1] = y;
+        if (++n < block_len) {
+            continue;
+        }
+        n = 0;
+
+        // Same steps as JOY_process_block()
+        for (int axis = 0; axis < AXES; axis++) {
+            if (!centered) {
+                JOY_FILTER_init(&filter[axis], block[0][axis]);
+            }
+            for (int i = 0; i < block_len; i++) {
+                value[axis] = JOY_FILTER_update(&filter[axis], block[i][axis]);
+            }
+            if (!centered) {
+                center[axis] = value[axis];
+            }
+            deflection[axis] = JOY_FILTER_deflection(value[axis], center[axis], half_range);
+        }
+        centered = 1;
+
+        step = JOY_STEP_update(&stepper, deflection[0], block_len * 1000 / rate);
+        if (step) {
+            steps++;
+            column += step;
+            column = column < 0 ? 0 : column >= COLUMNS ? COLUMNS - 1 : column;
+        }
+
+        // Noise at rest, before and after filtering
+        if (deflection[0] == 0 && deflection[1] == 0) {
+            for (int axis = 0; axis < AXES; axis++) {
+                for (int i = 0; i < block_len; i++) {
+                    stats_add(&raw_rest[axis], block[i][axis]);
+                }
+                stats_add(&filtered_rest[axis], value[axis]);
+            }
+        }
+
+        if (verbose) {
+            printf("%d,%u,%u,%d,%d,%d\n", blocks * block_len * 1000 / rate,
+                   value[0], value[1], deflection[0], deflection[1], column + 1);
+        } else if (step) {
+            printf("%8.3f s  %s  column %d\n", (double)blocks * block_len / rate,
+                   step > 0 ? "RIGHT" : "LEFT ", column + 1);
+        }
+        blocks++;
+    }
+
+    if (blocks == 0) {
+        fprintf(stderr, "no complete block of samples\n");
+        return 1;
+    }
+    if (!verbose) {
+        printf("\n%d blocks (%.3f s), center %u,%u, %d column steps\n", blocks,
+               (double)blocks * block_len / rate, center[0], center[1], steps);
+        printf("at rest:\n");
+        stats_print("  raw x", &raw_rest[0]);
+        stats_print("  filtered x", &filtered_rest[0]);
+        stats_print("  raw y", &raw_rest[1]);
+        stats_print("  filtered y", &filtered_rest[1]);
+    }
+    return 0;
+}
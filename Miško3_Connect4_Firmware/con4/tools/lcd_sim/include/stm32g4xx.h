@@ -0,0 +1,45 @@
+/*
+ * stm32g4xx.h
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Host stand-in for the CMSIS device header. Provides only what the LCD
+ * layer, uGUI and the game graphics need to compile on Linux.
+ */
+
+#ifndef LCD_SIM_STM32G4XX_H_
+#define LCD_SIM_STM32G4XX_H_
+
+#include <stdint.h>
+
+#define __DSB()
+
+#define WRITE_REG(REG, VAL)   ((REG) = (VAL))
+
+typedef struct { uint32_t BSRR; uint32_t BRR; } GPIO_TypeDef;
+typedef struct { uint32_t CNT; } TIM_TypeDef;
+typedef struct { uint32_t ISR; } USART_TypeDef;
+
+extern GPIO_TypeDef lcd_sim_gpio;
+#define GPIOD                 (&lcd_sim_gpio)
+#define LL_GPIO_PIN_3         (1U << 3)
+
+typedef enum { HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+typedef enum { HAL_DMA_STATE_RESET, HAL_DMA_STATE_READY, HAL_DMA_STATE_BUSY } HAL_DMA_StateTypeDef;
+
+#define DMA_PDATAALIGN_BYTE      0x0U
+#define DMA_PDATAALIGN_HALFWORD  0x1U
+#define DMA_PDATAALIGN_WORD      0x2U
+
+typedef struct {
+    struct { uint32_t PeriphDataAlignment; } Init;
+    HAL_DMA_StateTypeDef State;
+} DMA_HandleTypeDef;
+
+typedef struct { uint32_t State; } ADC_HandleTypeDef;
+typedef struct { uint32_t State; } TIM_HandleTypeDef;
+
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetTick(void);
+
+#endif /* LCD_SIM_STM32G4XX_H_ */
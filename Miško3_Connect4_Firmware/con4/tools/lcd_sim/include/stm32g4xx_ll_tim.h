@@ -0,0 +1,2 @@
+/* Host stand-in, see stm32g4xx.h */
+#include "stm32g4xx.h"
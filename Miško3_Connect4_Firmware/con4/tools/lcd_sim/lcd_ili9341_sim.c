@@ -0,0 +1,302 @@
+/*
+ * lcd_ili9341_sim.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Host replacement for system/lcd_ili9341.c. Commands and parameters are
+ * decoded the way the ILI9341 decodes them (CASET, RASET, GRAM), pixels land
+ * in lcd_sim_framebuffer and every FMC write is counted and costed.
+ * The orientation is fixed to the landscape mode the firmware uses.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lcd_ili9341.h"
+#include "lcd_sim.h"
+
+uint16_t lcd_sim_framebuffer[LCD_SIM_HEIGHT][LCD_SIM_WIDTH];
+GPIO_TypeDef lcd_sim_gpio;
+DMA_HandleTypeDef hdma_memtomem_dma1_channel2 = { .Init = { DMA_PDATAALIGN_HALFWORD }, .State = HAL_DMA_STATE_READY };
+
+static lcd_sim_counters_t counters;
+static uint64_t total_cycles;       // never reset, drives HAL_GetTick()
+static uint32_t idle_ms;            // time spent in HAL_Delay() and lcd_sim_advance_ms()
+
+static struct {
+    ILI9341_Data_t command;
+    uint32_t param_count;
+    uint16_t params[4];
+    uint16_t x1, x2, y1, y2;        // window
+    uint16_t x, y;                  // GRAM write pointer
+} chip = { .x2 = LCD_SIM_WIDTH - 1, .y2 = LCD_SIM_HEIGHT - 1 };
+
+// ------------------- Bus model ---------------------
+
+static void bus_writes(uint64_t n) {
+    counters.bus_writes += n;
+    counters.bus_cycles += n * LCD_SIM_WRITE_CYCLES;
+    total_cycles += n * LCD_SIM_WRITE_CYCLES;
+}
+
+static void bus_call(void) {
+    counters.bus_cycles += LCD_SIM_CALL_CYCLES;
+    total_cycles += LCD_SIM_CALL_CYCLES;
+}
+
+static void write_pixel(uint16_t colour) {
+    if (chip.x < LCD_SIM_WIDTH && chip.y < LCD_SIM_HEIGHT) {
+        lcd_sim_framebuffer[chip.y][chip.x] = colour;
+    }
+    counters.pixel_writes++;
+
+    // The controller wraps inside the window, like the real GRAM pointer
+    if (++chip.x > chip.x2) {
+        chip.x = chip.x1;
+        if (++chip.y > chip.y2) {
+            chip.y = chip.y1;
+        }
+    }
+}
+
+static void write_parameter(uint16_t data) {
+    if (chip.command == ILI9341_GRAM) {
+        write_pixel(data);
+        return;
+    }
+    if (chip.param_count < 4) {
+        chip.params[chip.param_count] = data;
+    }
+    chip.param_count++;
+
+    if (chip.param_count == 4) {
+        uint16_t start = (chip.params[0] << 8) | (chip.params[1] & 0xFF);
+        uint16_t end = (chip.params[2] << 8) | (chip.params[3] & 0xFF);
+        if (chip.command == ILI9341_CASET) {
+            chip.x1 = start;
+            chip.x2 = end;
+        } else if (chip.command == ILI9341_RASET) {
+            chip.y1 = start;
+            chip.y2 = end;
+        }
+    }
+}
+
+// ------------------- ILI9341 interface ---------------------
+
+void ILI9341_SetAddress(LCD_IO_Data_t *address) {
+    bus_call();
+    bus_writes(1);
+    counters.commands++;
+
+    chip.command = *address;
+    chip.param_count = 0;
+    if (chip.command == ILI9341_GRAM) {
+        chip.x = chip.x1;
+        chip.y = chip.y1;
+    }
+}
+
+void ILI9341_SendData(LCD_IO_Data_t *data, uint32_t length) {
+    bus_call();
+    bus_writes(length);
+    for (uint32_t i = 0; i < length; i++) {
+        write_parameter(data[i]);
+    }
+}
+
+void ILI9341_SendRepeatedData(LCD_IO_Data_t data, uint32_t num_copies) {
+    bus_call();
+    bus_writes(num_copies);
+    for (uint32_t i = 0; i < num_copies; i++) {
+        write_parameter(data);
+    }
+}
+
+// The transfer completes at once, only the bus time is accounted for
+int32_t ILI9341_SendDataDMA(LCD_IO_Data_t *data, uint32_t length) {
+    counters.dma_transfers++;
+    bus_call();
+    bus_writes(length);
+    for (uint32_t i = 0; i < length; i++) {
+        write_parameter(data[i]);
+    }
+    return 0;
+}
+
+uint8_t ILI9341_IsDMABusy() {
+    return 0;
+}
+
+void ILI9341_WaitDMA() {
+}
+
+void ILI9341_RecvData(LCD_IO_Data_t *address, uint32_t length) {
+    memset(address, 0, length * sizeof(LCD_IO_Data_t));
+}
+
+void ILI9341_SetOrientation(uint32_t Orientation) {
+    ILI9341_Data_t command = ILI9341_MAC;
+    ILI9341_Data_t parameter = Orientation;
+
+    ILI9341_SetAddress(&command);
+    ILI9341_SendData(&parameter, 1);
+}
+
+// Same command sequence as the firmware: CASET + 4, RASET + 4, GRAM
+void ILI9341_SetDisplayWindow(uint32_t Xpos, uint32_t Ypos, uint32_t Width, uint32_t Height) {
+    ILI9341_Data_t command;
+    ILI9341_Data_t parameter[4];
+
+    counters.window_commands++;
+
+    command = ILI9341_CASET;
+    parameter[0] = (ILI9341_Data_t)(Xpos >> 8U);
+    parameter[1] = (ILI9341_Data_t)(Xpos & 0xFFU);
+    parameter[2] = (ILI9341_Data_t)((Xpos + Width - 1U) >> 8U);
+    parameter[3] = (ILI9341_Data_t)((Xpos + Width - 1U) & 0xFFU);
+    ILI9341_SetAddress(&command);
+    ILI9341_SendData(parameter, 4);
+
+    command = ILI9341_RASET;
+    parameter[0] = (ILI9341_Data_t)(Ypos >> 8U);
+    parameter[1] = (ILI9341_Data_t)(Ypos & 0xFFU);
+    parameter[2] = (ILI9341_Data_t)((Ypos + Height - 1U) >> 8U);
+    parameter[3] = (ILI9341_Data_t)((Ypos + Height - 1U) & 0xFFU);
+    ILI9341_SetAddress(&command);
+    ILI9341_SendData(parameter, 4);
+
+    command = ILI9341_GRAM;
+    ILI9341_SetAddress(&command);
+}
+
+void ILI9341_Init(uint32_t color_space, uint32_t orientation) {
+    (void)color_space;
+    ILI9341_SetOrientation(orientation);
+    ILI9341_SetDisplayWindow(0U, 0U, LCD_SIM_WIDTH, LCD_SIM_HEIGHT);
+}
+
+void ILI9341_WaitTransfer() {
+}
+
+void ILI9341_DisplayOn() {
+}
+
+void ILI9341_DisplayOff() {
+}
+
+void ILI9341_InvertDisplay(uint8_t invert) {
+    (void)invert;
+}
+
+void ILI9341_SetSleep(uint8_t state) {
+    (void)state;
+}
+
+void ILI9341_SetScrollArea(uint16_t start_pos, uint16_t end_pos) {
+    (void)start_pos;
+    (void)end_pos;
+}
+
+void ILI9341_ScrollScreen(uint16_t position, uint8_t direction) {
+    (void)position;
+    (void)direction;
+}
+
+uint32_t ILI9341_GetParam(LCD_Param_t param) {
+    switch (param) {
+        case LCD_WIDTH:       return LCD_SIM_WIDTH;
+        case LCD_HEIGHT:      return LCD_SIM_HEIGHT;
+        case LCD_AREA:        return ILI9341_AREA;
+        case LCD_ORIENTATION: return ILI9341_MISKO_ROTATE_0;
+        default:              return 0;
+    }
+}
+
+// ------------------- Simulated HAL time ---------------------
+
+// The clock advances with the modelled LCD time, so animations run at the
+// pace the real bus would allow.
+uint32_t HAL_GetTick(void) {
+    return idle_ms + (uint32_t)(total_cycles / (LCD_SIM_HCLK_HZ / 1000));
+}
+
+void HAL_Delay(uint32_t Delay) {
+    idle_ms += Delay;
+}
+
+void lcd_sim_advance_ms(uint32_t ms) {
+    idle_ms += ms;
+}
+
+// ------------------- Counters and frame dumps ---------------------
+
+void lcd_sim_reset_counters(void) {
+    memset(&counters, 0, sizeof(counters));
+}
+
+const lcd_sim_counters_t* lcd_sim_counters(void) {
+    return &counters;
+}
+
+uint32_t lcd_sim_modelled_us(const lcd_sim_counters_t* c) {
+    return (uint32_t)(c->bus_cycles / (LCD_SIM_HCLK_HZ / 1000000));
+}
+
+static void rgb565_to_rgb888(uint16_t c, uint8_t* rgb) {
+    rgb[0] = ((c >> 11) & 0x1F) * 255 / 31;
+    rgb[1] = ((c >> 5) & 0x3F) * 255 / 63;
+    rgb[2] = (c & 0x1F) * 255 / 31;
+}
+
+int lcd_sim_write_ppm(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", LCD_SIM_WIDTH, LCD_SIM_HEIGHT);
+    for (int y = 0; y < LCD_SIM_HEIGHT; y++) {
+        for (int x = 0; x < LCD_SIM_WIDTH; x++) {
+            uint8_t rgb[3];
+            rgb565_to_rgb888(lcd_sim_framebuffer[y][x], rgb);
+            fwrite(rgb, 1, 3, f);
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+// Number of pixels that differ from a PPM written by lcd_sim_write_ppm(),
+// -1 if the file cannot be read
+long lcd_sim_compare_ppm(const char* path) {
+    FILE* f = fopen(path, "rb");
+    int width, height, max;
+    long diff = 0;
+
+    if (!f) {
+        return -1;
+    }
+    if (fscanf(f, "P6 %d %d %d", &width, &height, &max) != 3 ||
+        width != LCD_SIM_WIDTH || height != LCD_SIM_HEIGHT || max != 255) {
+        fclose(f);
+        return -1;
+    }
+    fgetc(f);
+
+    for (int y = 0; y < LCD_SIM_HEIGHT; y++) {
+        for (int x = 0; x < LCD_SIM_WIDTH; x++) {
+            uint8_t expected[3], rgb[3];
+            if (fread(expected, 1, 3, f) != 3) {
+                fclose(f);
+                return -1;
+            }
+            rgb565_to_rgb888(lcd_sim_framebuffer[y][x], rgb);
+            if (memcmp(expected, rgb, 3) != 0) {
+                diff++;
+            }
+        }
+    }
+    fclose(f);
+    return diff;
+}
@@ -0,0 +1,45 @@
+/*
+ * lcd_sim.h
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Host model of the ILI9341 on the FMC bus. The firmware LCD layer is
+ * linked against lcd_ili9341_sim.c instead of lcd_ili9341.c and draws into
+ * a 320x240 RGB565 framebuffer while every bus access is counted.
+ */
+
+#ifndef LCD_SIM_H_
+#define LCD_SIM_H_
+
+#include <stdint.h>
+
+#define LCD_SIM_WIDTH   320
+#define LCD_SIM_HEIGHT  240
+
+// Bus cost model at HCLK = 170 MHz, FMC timings from misko_v2.ioc:
+// ADDSET 1 + DATAST 1 + DATAHLD 1 + BUSTURN 1 + 1 cycle per mode 1 write.
+#define LCD_SIM_HCLK_HZ          170000000U
+#define LCD_SIM_WRITE_CYCLES     5U
+// Rough CPU cost of entering one ILI9341_* call (call, loop set-up, DSB)
+#define LCD_SIM_CALL_CYCLES      20U
+
+typedef struct {
+    uint32_t window_commands;   // ILI9341_SetDisplayWindow() calls
+    uint32_t commands;          // command words, window commands included
+    uint32_t pixel_writes;      // GRAM pixels written by the CPU or by DMA
+    uint32_t dma_transfers;     // ILI9341_SendDataDMA() calls
+    uint64_t bus_writes;        // every FMC write: commands, parameters, pixels
+    uint64_t bus_cycles;        // modelled HCLK cycles spent on the LCD
+} lcd_sim_counters_t;
+
+extern uint16_t lcd_sim_framebuffer[LCD_SIM_HEIGHT][LCD_SIM_WIDTH];
+
+void lcd_sim_reset_counters(void);
+const lcd_sim_counters_t* lcd_sim_counters(void);
+uint32_t lcd_sim_modelled_us(const lcd_sim_counters_t* counters);
+void lcd_sim_advance_ms(uint32_t ms);
+
+int lcd_sim_write_ppm(const char* path);
+long lcd_sim_compare_ppm(const char* path);
+
+#endif /* LCD_SIM_H_ */
@@ -0,0 +1,143 @@
+/*
+ * lcd_sim_main.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Renders every game screen through the real graphics.c / lcd.c / uGUI code
+ * into the simulated LCD and reports what each one costs on the bus.
+ *
+ * Usage: lcd_sim [-o dir] [-g dir]
+ *   -o dir   write one <scene>.ppm per scene into dir
+ *   -g dir   compare every scene against dir/<scene>.ppm (golden images),
+ *            exit status is 1 if any pixel differs or a golden is missing
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "lcd.h"
+#include "lcd_sim.h"
+#include "game.h"
+#include "graphics.h"
+#include "animation.h"
+#include "kbd.h"
+#include "LED.h"
+#include "console.h"
+
+typedef struct {
+    const char* name;
+    void (*render)(void);
+} scene_t;
+
+// ------------------- Firmware stubs ---------------------
+
+void LCD_BKLT_init(void) {}
+buttons_enum_t KBD_get_pressed_button(void) { return BTN_NONE; }
+void KBD_flush(void) {}
+uint8_t CONSOLE_register(char key, CONSOLE_handler_t handler, const char *help) { (void)key; (void)handler; (void)help; return 1; }
+void LED_on(LEDs_enum_t LEDn) { (void)LEDn; }
+void LED_off(LEDs_enum_t LEDn) { (void)LEDn; }
+void LED_toggle(LEDs_enum_t LEDn) { (void)LEDn; }
+
+// ------------------- Scenes ---------------------
+
+// A short game so every piece colour is on the board
+static void play_opening(void) {
+    static const int moves[] = { 3, 3, 2, 4, 4, 2, 5, 1 };
+
+    reset_board();
+    for (unsigned i = 0; i < sizeof(moves) / sizeof(moves[0]); i++) {
+        make_move(moves[i], (i % 2) ? game.PLAYER_HUMAN : game.PLAYER_AI);
+    }
+    make_move(6, game.PLAYER_PREMOVE);
+}
+
+static void scene_empty_board(void) {
+    reset_board();
+    render_empty_board();
+    render_pieces();
+}
+
+static void scene_pieces(void) {
+    play_opening();
+    render_pieces();
+}
+
+static void scene_drop(void) {
+    drop_animation_start(0, 0, game.ai_colour);
+    while (drop_animation_update()) {
+        lcd_sim_advance_ms(1);
+    }
+    make_move(0, game.PLAYER_AI);
+}
+
+static const scene_t scenes[] = {
+    { "empty_board",      scene_empty_board },
+    { "pieces",           scene_pieces },
+    { "drop",             scene_drop },
+    { "ai_won",           render_ai_won },
+    { "human_won",        render_human_won },
+    { "draw",             render_draw },
+    { "press_any_button", render_press_any_button },
+};
+
+// ------------------- Main ---------------------
+
+int main(int argc, char** argv) {
+    const char* out_dir = NULL;
+    const char* golden_dir = NULL;
+    char path[512];
+    int failed = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:g:")) != -1) {
+        switch (opt) {
+            case 'o': out_dir = optarg; break;
+            case 'g': golden_dir = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-o dir] [-g dir]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    LCD_Init();
+    LCD_uGUI_init();
+
+    printf("%-18s %8s %8s %9s %10s %10s %9s\n",
+           "scene", "windows", "cmds", "pixels", "bus writes", "cycles", "time us");
+
+    for (unsigned i = 0; i < sizeof(scenes) / sizeof(scenes[0]); i++) {
+        const scene_t* scene = &scenes[i];
+
+        lcd_sim_reset_counters();
+        scene->render();
+        const lcd_sim_counters_t* c = lcd_sim_counters();
+
+        printf("%-18s %8u %8u %9u %10llu %10llu %9u\n", scene->name,
+               c->window_commands, c->commands, c->pixel_writes,
+               (unsigned long long)c->bus_writes, (unsigned long long)c->bus_cycles,
+               lcd_sim_modelled_us(c));
+        if (scene->render == scene_drop) {
+            drop_animation_print_stats();
+        }
+
+        if (out_dir) {
+            snprintf(path, sizeof(path), "%s/%s.ppm", out_dir, scene->name);
+            failed |= lcd_sim_write_ppm(path);
+        }
+        if (golden_dir) {
+            snprintf(path, sizeof(path), "%s/%s.ppm", golden_dir, scene->name);
+            long diff = lcd_sim_compare_ppm(path);
+            if (diff != 0) {
+                if (diff < 0) {
+                    printf("  %s: golden image missing or unreadable\n", path);
+                } else {
+                    printf("  %s: %ld pixels differ\n", path, diff);
+                }
+                failed = 1;
+            }
+        }
+    }
+    return failed;
+}
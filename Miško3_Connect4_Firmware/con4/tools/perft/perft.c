@@ -0,0 +1,225 @@
+/*
+ * perft.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Perft for Connect 4: counts the move sequences of exactly N plies from a
+ * position, a game being over at the first four in a row. A winning move
+ * is a leaf only at the last ply. The counts are checked against reference
+ * values, so the tool is both a correctness oracle and a make/unmake
+ * throughput benchmark for any change to the board engines:
+ *
+ *   board     board.c as the firmware uses it: make_move(), check_win() on
+ *             the mover, subtract_move() on game.board
+ *   bitboard  bitboard.h as the search uses it: bb_is_winning_move(), bb_play()
+ *
+ * Usage: perft [-e board|bitboard|both] [-d depth] [-s] [moves]
+ *   -e engine   default both
+ *   -d depth    perft depth, default 8 (start position) or 7 (suite)
+ *   -s          run the position suite instead of one position
+ *   moves       start from this move list (columns 1..7), default the empty board
+ *
+ * Output: CSV perft,engine,position,depth,leaves,expected,ok,moves,seconds,moves_per_s
+ * where moves is the number of make/unmake pairs (interior and leaf nodes).
+ * The exit status is 1 if any count differs from its reference.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "game.h"
+#include "bitboard.h"
+
+// Start position: depths 1..9 are the published Connect 4 perft values,
+// 10 and 11 were counted by both engines here and agree
+static const unsigned long long start_counts[] = {
+    1, 7, 49, 343, 2401, 16807, 117649, 823536, 5673234, 39394572,
+    268031646, 1844590828,
+};
+#define START_MAX_DEPTH    ((int)(sizeof(start_counts) / sizeof(start_counts[0])) - 1)
+
+// Suite at depth 7, counted by both engines: tall columns, an open centre,
+// a symmetric opening, a full column and a crowded middle game
+static const struct {
+    const char* moves;
+    unsigned long long depth7;
+} suite[] = {
+    { "444444",    262602 },
+    { "3435",      738848 },
+    { "12344321",  772755 },
+    { "7777665",   535396 },
+    { "343434221", 394594 },
+};
+#define SUITE_DEPTH    7
+
+static unsigned long long moves_made;
+
+// ------------------- board.c engine ---------------------
+
+static unsigned long long perft_board(int depth, int player, int opponent) {
+    unsigned long long leaves = 0;
+
+    for (int col = 0; col < COLS; col++) {
+        if (!check_if_valid(col)) {
+            continue;
+        }
+        make_move(col, player);
+        moves_made++;
+        if (check_win(player)) {
+            leaves += (depth == 1);
+        } else if (depth == 1) {
+            leaves++;
+        } else {
+            leaves += perft_board(depth - 1, opponent, player);
+        }
+        subtract_move(col);
+    }
+    return leaves;
+}
+
+// ------------------- bitboard.h engine ---------------------
+
+static unsigned long long perft_bitboard(const bitboard_t* pos, int depth) {
+    unsigned long long leaves = 0;
+
+    for (int col = 0; col < COLS; col++) {
+        bitboard_t child;
+
+        if (!bb_can_play(pos, col)) {
+            continue;
+        }
+        moves_made++;
+        if (bb_is_winning_move(pos, col) || depth == 1) {
+            leaves += (depth == 1);
+            continue;
+        }
+        child = *pos;
+        bb_play(&child, col);
+        leaves += perft_bitboard(&child, depth - 1);
+    }
+    return leaves;
+}
+
+// ------------------- Driver ---------------------
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Sets up game.board and `pos` (side to move first) from a move list.
+// Returns 0 if a move is illegal or ends the game.
+static int load_position(const char* moves, bitboard_t* pos, int* to_move, int* other) {
+    int player = game.PLAYER_AI, opponent = game.PLAYER_HUMAN;
+
+    reset_board();
+    *pos = (bitboard_t){ 0, 0, 0 };
+    for (const char* p = moves; *p; p++) {
+        int col = *p - '1';
+        int swap;
+
+        if (col < 0 || col >= COLS || !bb_can_play(pos, col) || bb_is_winning_move(pos, col)) {
+            return 0;
+        }
+        make_move(col, player);
+        bb_play(pos, col);
+        swap = player;
+        player = opponent;
+        opponent = swap;
+    }
+    *to_move = player;
+    *other = opponent;
+    return 1;
+}
+
+// Runs one engine on one position; returns 1 if the count is as expected
+// (or there is no reference)
+static int run(const char* engine, const char* moves, int depth, long long expected) {
+    bitboard_t pos;
+    int player, opponent;
+    unsigned long long leaves;
+    double start, seconds;
+    int ok;
+
+    if (!load_position(moves, &pos, &player, &opponent)) {
+        fprintf(stderr, "illegal position: %s\n", moves);
+        return 0;
+    }
+
+    moves_made = 0;
+    start = now_seconds();
+    if (depth == 0) {
+        leaves = 1;
+    } else if (strcmp(engine, "board") == 0) {
+        leaves = perft_board(depth, player, opponent);
+    } else {
+        leaves = perft_bitboard(&pos, depth);
+    }
+    seconds = now_seconds() - start;
+
+    ok = (expected < 0 || leaves == (unsigned long long)expected);
+    printf("perft,%s,%s,%d,%llu,", engine, *moves ? moves : "-", depth, leaves);
+    if (expected < 0) {
+        printf(",,");
+    } else {
+        printf("%lld,%s,", expected, ok ? "ok" : "FAIL");
+    }
+    printf("%llu,%.3f,%.0f\n", moves_made, seconds, seconds > 0 ? moves_made / seconds : 0);
+    fflush(stdout);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    const char* engines[2] = { "board", "bitboard" };
+    int first = 0, last = 1;
+    int depth = -1, use_suite = 0, failures = 0;
+    const char* moves = "";
+    int opt;
+
+    while ((opt = getopt(argc, argv, "e:d:s")) != -1) {
+        switch (opt) {
+            case 'e':
+                if (strcmp(optarg, "board") == 0) {
+                    last = 0;
+                } else if (strcmp(optarg, "bitboard") == 0) {
+                    first = 1;
+                } else if (strcmp(optarg, "both") != 0) {
+                    fprintf(stderr, "unknown engine %s\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'd': depth = atoi(optarg); break;
+            case 's': use_suite = 1; break;
+            default:
+                fprintf(stderr, "usage: %s [-e board|bitboard|both] [-d depth] [-s] [moves]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind < argc) {
+        moves = argv[optind];
+    }
+
+    printf("perft,engine,position,depth,leaves,expected,ok,moves,seconds,moves_per_s\n");
+    for (int e = first; e <= last; e++) {
+        if (use_suite) {
+            int d = depth < 0 ? SUITE_DEPTH : depth;
+            for (unsigned i = 0; i < sizeof(suite) / sizeof(suite[0]); i++) {
+                failures += !run(engines[e], suite[i].moves, d,
+                                 d == SUITE_DEPTH ? (long long)suite[i].depth7 : -1);
+            }
+        } else {
+            int d = depth < 0 ? 8 : depth;
+            // From the start position every depth up to d, as perft tools usually do
+            for (int i = (*moves == '\0') ? 1 : d; i <= d; i++) {
+                long long expected = (*moves == '\0' && i <= START_MAX_DEPTH) ? (long long)start_counts[i] : -1;
+                failures += !run(engines[e], moves, i, expected);
+            }
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,376 @@
+/*
+ * replay.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Replays game records (Aplication/game_record.h) from the board through the
+ * engine and checks that every AI move comes out the same.
+ *
+ * The search is stopped by the clock on the board, but the tree walk itself
+ * does not depend on it: re-running search.c with search_set_max_steps() at
+ * the recorded step count ends in the same state, and search_best_move()
+ * with the same prior gives the same move. The prior is the host network
+ * (ai_kernel.c) instead of the X-CUBE-AI runtime; the two agree to a few
+ * ulps (tools/ai_check), so a mismatch on a move the search left to the
+ * network is reported with the gap between the two best values.
+ *
+ * Input, a trace capture or a dump of the flash ring:
+ *   trace     every TRACE_GAME_RECORD in it, e.g. after the 'g' serial command
+ *   -f        the GAMELOG region, e.g.
+ *               STM32_Programmer_CLI -c port=SWD -r 0x0807E000 0x2000 gamelog.bin
+ * The same game seen twice (a game end and a later dump) is replayed once.
+ *
+ * Usage: replay [-f] [-v] [-q seq] [file]
+ *        replay -s games [-t ms] [-S seed] > capture.bin
+ *   -f        the input is a flash dump
+ *   -v        one line per AI move
+ *   -q seq    only the game with this sequence number
+ *   -s games  write a trace capture of host games instead: the AI as on the
+ *             board (network, search stopped by the clock) against random moves
+ *   -t ms     think time for -s, default 20
+ *   -S seed   seed for -s, default 1
+ *
+ * Output CSV: replay,seq,plies,result,ai_moves,matched,first_mismatch,
+ * think_ms_max, one line per game and a total line; move,seq,ply,played,
+ * replayed,match,think_ms,steps,depth,nodes,prior_gap for every AI move with
+ * -v and for every move that differs (columns from 1). The exit status is 1 if a
+ * record is corrupt, a move is illegal, the result differs or an AI move differs.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "game.h"
+#include "bitboard.h"
+#include "ai_kernel.h"
+#include "search.h"
+#include "trace_events.h"
+#include "game_record.h"
+
+#define FLASH_PAGE_SIZE     2048    // game_log.c ring, dual-bank pages
+#define SLOTS_PER_PAGE      (FLASH_PAGE_SIZE / sizeof(game_record_t))
+
+typedef struct {
+    game_record_t* records;
+    size_t count;
+    size_t capacity;
+    unsigned long corrupt;
+} record_set_t;
+
+static int verbose;
+
+// ------------------- Input ---------------------
+
+static int add_record(record_set_t* set, const void* data) {
+    game_record_t rec;
+
+    memcpy(&rec, data, sizeof(rec));
+    if (!game_record_is_valid(&rec)) {
+        set->corrupt++;
+        return 0;
+    }
+    for (size_t i = 0; i < set->count; i++) {
+        if (memcmp(&set->records[i], &rec, sizeof(rec)) == 0) {
+            return 0;
+        }
+    }
+    if (set->count == set->capacity) {
+        size_t capacity = set->capacity ? 2 * set->capacity : 64;
+        game_record_t* records = realloc(set->records, capacity * sizeof(*records));
+
+        if (!records) {
+            return -1;
+        }
+        set->records = records;
+        set->capacity = capacity;
+    }
+    set->records[set->count++] = rec;
+    return 0;
+}
+
+// Framing of system/trace.c; everything but TRACE_GAME_RECORD is skipped
+static int read_trace(FILE* in, record_set_t* set) {
+    uint8_t header[TRACE_HEADER_SIZE];
+    uint8_t payload[TRACE_MAX_PAYLOAD];
+    int c;
+
+    while ((c = fgetc(in)) != EOF) {
+        if (c != TRACE_SYNC) {
+            continue;
+        }
+        if (fread(&header[1], 1, TRACE_HEADER_SIZE - 1, in) != TRACE_HEADER_SIZE - 1 ||
+            fread(payload, 1, header[2], in) != header[2]) {
+            break;
+        }
+        if (header[1] == TRACE_GAME_RECORD && header[2] == sizeof(game_record_t) &&
+            add_record(set, payload) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Whole pages of SLOTS_PER_PAGE slots; erased slots are all 0xFF and skipped
+static int read_flash(FILE* in, record_set_t* set) {
+    uint8_t page[FLASH_PAGE_SIZE];
+    size_t n;
+
+    while ((n = fread(page, 1, sizeof(page), in)) > 0) {
+        for (size_t slot = 0; slot < SLOTS_PER_PAGE && (slot + 1) * sizeof(game_record_t) <= n; slot++) {
+            const uint8_t* p = &page[slot * sizeof(game_record_t)];
+            uint16_t magic;
+
+            memcpy(&magic, p, sizeof(magic));
+            if (magic == 0xFFFF) {
+                continue;
+            }
+            if (add_record(set, p) != 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int by_sequence(const void* a, const void* b) {
+    const game_record_t* x = a;
+    const game_record_t* y = b;
+
+    return (x->sequence > y->sequence) - (x->sequence < y->sequence);
+}
+
+// ------------------- Engine ---------------------
+
+// Network output for `pos`, side to move as the AI: what get_action_values() gave on the board
+static void network_values(const bitboard_t* pos, float* values) {
+    ai_i8 state[AI_KERNEL_INPUTS];
+    float input[AI_KERNEL_INPUTS];
+
+    bb_to_board(pos, game.board, game.PLAYER_AI, game.PLAYER_HUMAN);
+    get_state(state);
+    ai_kernel_input_from_state(state, input);
+    ai_kernel_run(input, values);
+}
+
+// The AI move for `pos`: as tasks.c with think_ms on the clock, or replayed to `steps`
+static int ai_move(const bitboard_t* pos, const float* prior, uint32_t think_ms, uint32_t steps) {
+    search_start(pos, think_ms);
+    search_set_max_steps(steps);
+    while (!search_run(SEARCH_SLICE_US)) {
+    }
+    return search_best_move(prior);
+}
+
+// Gap between the best and second best value among the moves the search left open
+static float prior_gap(const float* values) {
+    float best = -INFINITY, second = -INFINITY;
+
+    for (int col = 0; col < COLS; col++) {
+        if (search_get_result(col) != SEARCH_UNKNOWN) {
+            continue;
+        }
+        if (values[col] > best) {
+            second = best;
+            best = values[col];
+        } else if (values[col] > second) {
+            second = values[col];
+        }
+    }
+    return best - second;
+}
+
+// ------------------- Replay ---------------------
+
+typedef struct {
+    unsigned long games;
+    unsigned long ai_moves;
+    unsigned long matched;
+    unsigned long failed_games;
+} totals_t;
+
+static void replay_game(const game_record_t* rec, totals_t* totals) {
+    bitboard_t pos = { 0, 0, 0 };
+    int result = GAME_RECORD_UNFINISHED;
+    int matched = 0, first_mismatch = -1, bad = 0;
+    unsigned think_ms_max = 0;
+
+    for (int ply = 0; ply < rec->plies && !bad; ply++) {
+        int col = game_record_move(rec, ply);
+        int ai = game_record_ai_index(rec, ply);
+
+        if (col >= COLS || !bb_can_play(&pos, col) || result != GAME_RECORD_UNFINISHED) {
+            fprintf(stderr, "game %u ply %d: column %d cannot be played\n", rec->sequence, ply, col + 1);
+            bad = 1;
+            break;
+        }
+        if (ai >= 0) {
+            float values[COLS];
+            int used_prior = (rec->prior_mask >> ai) & 1;
+            int move;
+
+            if (used_prior) {
+                network_values(&pos, values);
+            }
+            move = ai_move(&pos, used_prior ? values : NULL, 0, rec->search_steps[ai]);
+            if (move == col) {
+                matched++;
+            } else if (first_mismatch < 0) {
+                first_mismatch = ply;
+            }
+            if (rec->ply_ms[ply] > think_ms_max) {
+                think_ms_max = rec->ply_ms[ply];
+            }
+            if (verbose || move != col) {
+                printf("move,%u,%d,%d,%d,%s,%u,%u,%u,%u,%.3g\n", rec->sequence, ply, col + 1, move + 1,
+                       move == col ? "same" : "DIFFERENT", rec->ply_ms[ply], rec->search_steps[ai],
+                       search_get_stats()->depth, search_get_stats()->nodes,
+                       used_prior ? prior_gap(values) : NAN);
+            }
+        }
+        if (bb_is_winning_move(&pos, col)) {
+            result = (ai >= 0) ? GAME_RECORD_AI_WON : GAME_RECORD_HUMAN_WON;
+        }
+        bb_play(&pos, col);
+        if (result == GAME_RECORD_UNFINISHED && pos.moves == BB_CELLS) {
+            result = GAME_RECORD_DRAW;
+        }
+    }
+    if (!bad && result != rec->result) {
+        fprintf(stderr, "game %u: recorded result %u, the moves give %d\n", rec->sequence, rec->result, result);
+        bad = 1;
+    }
+
+    printf("replay,%u,%u,%u,%u,%d,%d,%u\n", rec->sequence, rec->plies, rec->result, rec->ai_moves,
+           matched, first_mismatch, think_ms_max);
+    totals->games++;
+    totals->ai_moves += rec->ai_moves;
+    totals->matched += matched;
+    totals->failed_games += bad || matched != rec->ai_moves;
+}
+
+// ------------------- Synthetic capture (-s) ---------------------
+
+static uint32_t xorshift32(uint32_t* s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+static void write_trace_record(uint8_t id, const void* payload, uint8_t size) {
+    uint8_t header[TRACE_HEADER_SIZE] = { TRACE_SYNC, id, size };
+    uint32_t timestamp = (uint32_t)clock();
+
+    memcpy(&header[3], &timestamp, sizeof(timestamp));
+    fwrite(header, 1, sizeof(header), stdout);
+    fwrite(payload, 1, size, stdout);
+}
+
+static uint32_t now_ms(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000u + ts.tv_nsec / 1000000;
+}
+
+// The AI plays first as on the board, the human picks a random legal column
+static void write_synthetic(int games, uint32_t think_ms, uint32_t seed) {
+    for (int g = 0; g < games; g++) {
+        game_record_t rec;
+        bitboard_t pos = { 0, 0, 0 };
+        game_record_result_t result = GAME_RECORD_UNFINISHED;
+
+        game_record_start(&rec, g, now_ms(), 1);
+        while (result == GAME_RECORD_UNFINISHED) {
+            int ai_turn = (pos.moves % 2) == 0;
+            uint32_t start = now_ms();
+            int col;
+
+            if (ai_turn) {
+                float values[COLS];
+                network_values(&pos, values);
+                col = ai_move(&pos, values, think_ms, 0);
+            } else {
+                do {
+                    col = xorshift32(&seed) % COLS;
+                } while (!bb_can_play(&pos, col));
+            }
+            game_record_add_move(&rec, col, now_ms() - start);
+            if (ai_turn) {
+                game_record_set_search(&rec, search_get_stats()->steps, 1);
+            }
+            if (bb_is_winning_move(&pos, col)) {
+                result = ai_turn ? GAME_RECORD_AI_WON : GAME_RECORD_HUMAN_WON;
+            }
+            bb_play(&pos, col);
+            if (result == GAME_RECORD_UNFINISHED && pos.moves == BB_CELLS) {
+                result = GAME_RECORD_DRAW;
+            }
+        }
+        game_record_finish(&rec, result);
+        write_trace_record(TRACE_GAME_RECORD, &rec, sizeof(rec));
+    }
+}
+
+// ------------------- Main ---------------------
+
+int main(int argc, char** argv) {
+    FILE* in = stdin;
+    record_set_t set = { 0 };
+    totals_t totals = { 0 };
+    int flash = 0, synthetic = 0;
+    long only = -1;
+    uint32_t think_ms = 20, seed = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "fvq:s:t:S:")) != -1) {
+        switch (opt) {
+            case 'f': flash = 1; break;
+            case 'v': verbose = 1; break;
+            case 'q': only = atol(optarg); break;
+            case 's': synthetic = atoi(optarg); break;
+            case 't': think_ms = atoi(optarg); break;
+            case 'S': seed = strtoul(optarg, NULL, 0); break;
+            default:
+                fprintf(stderr, "usage: %s [-f] [-v] [-q seq] [file]\n"
+                                "       %s -s games [-t ms] [-S seed] > capture.bin\n", argv[0], argv[0]);
+                return 2;
+        }
+    }
+    if (synthetic > 0) {
+        if (think_ms == 0 || seed == 0) {
+            fprintf(stderr, "bad option value\n");
+            return 2;
+        }
+        write_synthetic(synthetic, think_ms, seed);
+        return 0;
+    }
+
+    if (optind < argc && !(in = fopen(argv[optind], "rb"))) {
+        perror(argv[optind]);
+        return 1;
+    }
+    if ((flash ? read_flash(in, &set) : read_trace(in, &set)) != 0) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    if (set.corrupt) {
+        fprintf(stderr, "%lu corrupt records skipped\n", set.corrupt);
+    }
+    qsort(set.records, set.count, sizeof(*set.records), by_sequence);
+
+    printf("replay,seq,plies,result,ai_moves,matched,first_mismatch,think_ms_max\n");
+    printf("move,seq,ply,played,replayed,match,think_ms,steps,depth,nodes,prior_gap\n");
+    for (size_t i = 0; i < set.count; i++) {
+        if (only < 0 || set.records[i].sequence == (uint32_t)only) {
+            replay_game(&set.records[i], &totals);
+        }
+    }
+    printf("total,%lu games,%lu ai moves,%lu matched,%lu games failed,%lu corrupt\n",
+           totals.games, totals.ai_moves, totals.matched, totals.failed_games, set.corrupt);
+    return (totals.failed_games || set.corrupt) ? 1 : 0;
+}
@@ -0,0 +1,20 @@
+# replay_roundtrip.cmake
+#
+#  Created on: 19 Oct 2026
+#
+# replay -s 10 | replay: host games written as a trace capture must replay
+# move for move. Fails unless both ends exit 0 and the total line reports
+# "0 games failed".
+#
+# Usage: cmake -DREPLAY=path -P replay_roundtrip.cmake
+
+execute_process(COMMAND ${REPLAY} -s 10
+    COMMAND ${REPLAY}
+    RESULTS_VARIABLE status OUTPUT_VARIABLE output)
+message("${output}")
+if(NOT status STREQUAL "0;0")
+    message(FATAL_ERROR "replay exit status: ${status}")
+endif()
+if(NOT output MATCHES ",0 games failed,")
+    message(FATAL_ERROR "replay reports failed games")
+endif()
@@ -0,0 +1,197 @@
+/*
+ * ring_bench.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Host throughput benchmark of the SPSC ring buffer (system/ring.c) against
+ * the original byte-wise circular buffer (system/buf.c).
+ *
+ * Usage: ring_bench [megabytes]
+ *
+ * Single thread: the same thread writes a chunk and reads it back, for
+ * chunk sizes from 1 to 256 bytes, through a 512-byte buffer like the SCI
+ * buffers. Two threads: a producer and a consumer thread stream data
+ * through the ring and the consumer checks every byte, which exercises
+ * the acquire/release index handling (buf.c has no such guarantee and is
+ * not run this way).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "buf.h"
+#include "ring.h"
+
+#define BUFFER_LENGTH   512
+
+static const uint32_t chunk_sizes[] = { 1, 4, 16, 64, 256 };
+
+static uint8_t buf_array[BUFFER_LENGTH];
+static uint8_t ring_array[BUFFER_LENGTH];
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ------------------- Single thread ---------------------
+
+static double bench_buf(uint64_t total, uint32_t chunk) {
+    buf_handle_t buf;
+    uint8_t in[256], out[256];
+    uint64_t check = 0;
+
+    memset(in, 0x5A, sizeof(in));
+    BUF_init(&buf, buf_array, BUFFER_LENGTH);
+
+    double start = now_seconds();
+    for (uint64_t done = 0; done < total; done += chunk) {
+        if (chunk == 1) {
+            BUF_store_byte(&buf, in[0]);
+            BUF_get_byte(&buf, out);
+        } else {
+            BUF_store_bytes(&buf, in, chunk);
+            BUF_get_bytes(&buf, out, chunk);
+        }
+        check += out[chunk - 1];
+    }
+    double elapsed = now_seconds() - start;
+
+    if (check != total / chunk * 0x5A) {
+        printf("buf.c: data mismatch\n");
+    }
+    return total / elapsed / 1e6;
+}
+
+static double bench_ring(uint64_t total, uint32_t chunk) {
+    ring_handle_t ring;
+    uint8_t in[256], out[256];
+    uint64_t check = 0;
+
+    memset(in, 0x5A, sizeof(in));
+    RING_init(&ring, ring_array, BUFFER_LENGTH);
+
+    double start = now_seconds();
+    for (uint64_t done = 0; done < total; done += chunk) {
+        if (chunk == 1) {
+            RING_put(&ring, in[0]);
+            RING_get(&ring, out);
+        } else {
+            RING_write(&ring, in, chunk);
+            RING_read(&ring, out, chunk);
+        }
+        check += out[chunk - 1];
+    }
+    double elapsed = now_seconds() - start;
+
+    if (check != total / chunk * 0x5A) {
+        printf("ring.c: data mismatch\n");
+    }
+    return total / elapsed / 1e6;
+}
+
+// ------------------- Two threads ---------------------
+
+typedef struct {
+    ring_handle_t ring;
+    uint64_t total;
+    uint32_t chunk;
+    uint64_t errors;
+} stream_t;
+
+static void* producer(void* arg) {
+    stream_t* s = arg;
+    uint8_t data[256];
+    uint64_t sent = 0;
+
+    while (sent < s->total) {
+        uint32_t n = s->chunk;
+        for (uint32_t i = 0; i < n; i++) {
+            data[i] = (uint8_t)(sent + i);
+        }
+        while (RING_write(&s->ring, data, n) != BUFFER_OK) {
+            sched_yield();      // the consumer will make space
+        }
+        sent += n;
+    }
+    return NULL;
+}
+
+static void* consumer(void* arg) {
+    stream_t* s = arg;
+    uint64_t received = 0;
+
+    // Zero-copy side: consume directly from the ring array
+    while (received < s->total) {
+        const uint8_t* data;
+        uint32_t n = RING_peek_read(&s->ring, &data);
+        if (n == 0) {
+            sched_yield();
+            continue;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            if (data[i] != (uint8_t)(received + i)) {
+                s->errors++;
+            }
+        }
+        RING_commit_read(&s->ring, n);
+        received += n;
+    }
+    return NULL;
+}
+
+static double bench_threads(uint64_t total, uint32_t chunk, uint64_t* errors) {
+    static stream_t s;
+    pthread_t p, c;
+
+    RING_init(&s.ring, ring_array, BUFFER_LENGTH);
+    s.total = total;
+    s.chunk = chunk;
+    s.errors = 0;
+
+    double start = now_seconds();
+    pthread_create(&c, NULL, consumer, &s);
+    pthread_create(&p, NULL, producer, &s);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+    double elapsed = now_seconds() - start;
+
+    *errors = s.errors;
+    return total / elapsed / 1e6;
+}
+
+// ------------------- Main ---------------------
+
+int main(int argc, char** argv) {
+    uint64_t megabytes = (argc > 1) ? strtoull(argv[1], NULL, 10) : 64;
+    uint64_t total = megabytes << 20;
+    int failed = 0;
+
+    printf("%u-byte buffer, %llu MB per run, MB/s\n\n", BUFFER_LENGTH, (unsigned long long)megabytes);
+    setvbuf(stdout, NULL, _IONBF, 0);
+    printf("%6s %10s %10s %8s %14s\n", "chunk", "buf.c", "ring.c", "speedup", "ring 2 threads");
+
+    for (unsigned i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++) {
+        uint32_t chunk = chunk_sizes[i];
+        uint64_t run = total - total % chunk;
+        uint64_t errors;
+
+        double buf_rate = bench_buf(run, chunk);
+        double ring_rate = bench_ring(run, chunk);
+        double thread_rate = bench_threads(run, chunk, &errors);
+
+        printf("%6u %10.1f %10.1f %7.1fx %14.1f\n", chunk, buf_rate, ring_rate,
+               ring_rate / buf_rate, thread_rate);
+        if (errors) {
+            printf("  %llu corrupted bytes in the two-thread run\n", (unsigned long long)errors);
+            failed = 1;
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,274 @@
+/*
+ * selfplay.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Self-play training data for python_model, on all cores. The network plays
+ * both sides, sampling its moves from a softmax of its outputs so the games
+ * spread out, after a few random opening plies. Every position after the
+ * opening becomes a record of tools/dataset: the position and the threats
+ * get_state() encodes for the network (side to move as PLAYER_AI), the move
+ * played, the game's outcome for the side to move and, with -v, what
+ * search.c proves at that depth.
+ *
+ * Usage: selfplay [-j threads] [-g games] [-s seed] [-o plies] [-t temp]
+ *                 [-v depth] [-r records] [-O prefix]
+ *   -j threads  worker threads, default the number of cores
+ *   -g games    default 10000
+ *   -s seed     default 1; game i is reproducible from the seed and i
+ *   -o plies    random opening plies, not recorded, default 2
+ *   -t temp     softmax temperature, 0 plays the greedy move, default 1
+ *   -v depth    label positions with a depth-limited search, default off
+ *   -r records  records per shard, default 1048576
+ *   -O prefix   shard files are <prefix>-<thread>-<n>.c4ds, default "selfplay"
+ *
+ * Each thread writes its own shards (dataset.h format, header seed = -s).
+ * Which thread plays a game depends on scheduling, so the shards differ
+ * between runs in order only. The search value is +1 or -1 when proven,
+ * 0 otherwise.
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "game.h"
+#include "bitboard.h"
+#include "search.h"
+#include "ai_kernel.h"
+#include "dataset.h"
+
+#define MAX_THREADS          256
+#define GAMES_PER_CLAIM      16
+
+typedef struct {
+    dataset_writer_t out;
+    int thread;
+    int shard;
+    uint64_t total;
+} shard_writer_t;
+
+static long game_count = 10000;
+static uint64_t base_seed = 1;
+static int opening_plies = 2;
+static float temperature = 1;
+static int value_depth;
+static uint32_t shard_records = 1u << 20;
+static const char* prefix = "selfplay";
+
+static atomic_long next_game;
+static atomic_int failed;
+
+// ------------------- Helpers ---------------------
+
+static uint64_t splitmix64(uint64_t* s) {
+    uint64_t z = (*s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform in [0, 1)
+static double random_unit(uint64_t* rng) {
+    return (splitmix64(rng) >> 11) * (1.0 / (1ULL << 53));
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ------------------- Shards ---------------------
+
+static int shard_write(shard_writer_t* w, const dataset_record_t* records, int count) {
+    if (w->out.file && w->out.header.records >= shard_records && dataset_finish(&w->out) != 0) {
+        return -1;
+    }
+    if (!w->out.file) {
+        char path[256];
+
+        snprintf(path, sizeof(path), "%s-%02d-%04d.c4ds", prefix, w->thread, w->shard++);
+        if (dataset_create(&w->out, path, base_seed) != 0) {
+            return -1;
+        }
+    }
+    if (dataset_write(&w->out, records, count) != 0) {
+        return -1;
+    }
+    w->total += count;
+    return 0;
+}
+
+static int shard_close(shard_writer_t* w) {
+    return w->out.file ? dataset_finish(&w->out) : 0;
+}
+
+// ------------------- Games ---------------------
+
+// The network's move, sampled at `temperature`
+static int network_move(const bitboard_t* pos, uint64_t* rng) {
+    ai_i8 state[AI_KERNEL_INPUTS];
+    float input[AI_KERNEL_INPUTS], values[AI_KERNEL_OUTPUTS];
+    double weight[COLS], sum = 0, pick;
+    int best;
+
+    bb_to_board(pos, game.board, game.PLAYER_AI, game.PLAYER_HUMAN);
+    get_state(state);
+    ai_kernel_input_from_state(state, input);
+    ai_kernel_run(input, values);
+    best = ai_kernel_best_move(values);
+    if (temperature <= 0) {
+        return best;
+    }
+
+    for (int col = 0; col < COLS; col++) {
+        weight[col] = bb_can_play(pos, col) ? exp((values[col] - values[best]) / temperature) : 0;
+        sum += weight[col];
+    }
+    pick = random_unit(rng) * sum;
+    for (int col = 0; col < COLS; col++) {
+        if (weight[col] > 0 && (pick -= weight[col]) < 0) {
+            return col;
+        }
+    }
+    return best;
+}
+
+static int8_t search_value(const bitboard_t* pos) {
+    int open = 0;
+
+    search_start(pos, 0);
+    search_set_max_depth(value_depth);
+    while (!search_run(1000000)) {
+    }
+    for (int col = 0; col < COLS; col++) {
+        if (search_get_result(col) == SEARCH_WIN) {
+            return 1;
+        }
+        open += search_get_result(col) == SEARCH_UNKNOWN;
+    }
+    return open ? 0 : -1;
+}
+
+// Plays game `index` and writes its positions; returns -1 on a write error
+static int play_game(long index, shard_writer_t* w) {
+    dataset_record_t records[BB_CELLS];
+    uint64_t rng = base_seed * 0x100000001B3ULL + (uint64_t)index;
+    bitboard_t pos = { 0, 0, 0 };
+    int count = 0, winner = -1;       // winner: ply parity of the winning move
+
+    splitmix64(&rng);
+    while (pos.moves < BB_CELLS) {
+        int col;
+
+        if (pos.moves < opening_plies) {
+            do {
+                col = splitmix64(&rng) % COLS;
+            } while (!bb_can_play(&pos, col));
+        } else {
+            dataset_record_t* r = &records[count++];
+
+            col = network_move(&pos, &rng);
+            dataset_from_bitboard(&pos, r);
+            r->move = col;
+            if (value_depth) {
+                r->value = search_value(&pos);
+            }
+        }
+        if (bb_is_winning_move(&pos, col)) {
+            winner = pos.moves % 2;
+            break;
+        }
+        bb_play(&pos, col);
+    }
+
+    for (int i = 0; i < count; i++) {
+        records[i].outcome = (winner < 0) ? 0 : (records[i].ply % 2 == winner) ? 1 : -1;
+    }
+    return count ? shard_write(w, records, count) : 0;
+}
+
+static void* worker(void* arg) {
+    shard_writer_t* w = arg;
+
+    while (!atomic_load(&failed)) {
+        long first = atomic_fetch_add(&next_game, GAMES_PER_CLAIM);
+        if (first >= game_count) {
+            break;
+        }
+        for (long g = first; g < first + GAMES_PER_CLAIM && g < game_count; g++) {
+            if (play_game(g, w) != 0) {
+                atomic_store(&failed, 1);
+                break;
+            }
+        }
+    }
+    if (shard_close(w) != 0) {
+        atomic_store(&failed, 1);
+    }
+    return NULL;
+}
+
+// ------------------- Driver ---------------------
+
+int main(int argc, char** argv) {
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    static shard_writer_t writers[MAX_THREADS];
+    pthread_t tid[MAX_THREADS];
+    uint64_t records = 0;
+    double start, seconds;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "j:g:s:o:t:v:r:O:")) != -1) {
+        switch (opt) {
+            case 'j': threads = atoi(optarg); break;
+            case 'g': game_count = atol(optarg); break;
+            case 's': base_seed = strtoull(optarg, NULL, 0); break;
+            case 'o': opening_plies = atoi(optarg); break;
+            case 't': temperature = atof(optarg); break;
+            case 'v': value_depth = atoi(optarg); break;
+            case 'r': shard_records = strtoul(optarg, NULL, 0); break;
+            case 'O': prefix = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-j threads] [-g games] [-s seed] [-o plies] [-t temp]\n"
+                                "       [-v depth] [-r records] [-O prefix]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (threads < 1 || game_count < 1 || opening_plies < 0 ||
+        value_depth < 0 || value_depth > BB_CELLS || shard_records < 1) {
+        fprintf(stderr, "bad option value\n");
+        return 2;
+    }
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+
+    start = now_seconds();
+    for (int t = 0; t < threads; t++) {
+        writers[t].thread = t;
+        pthread_create(&tid[t], NULL, worker, &writers[t]);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tid[t], NULL);
+        records += writers[t].total;
+    }
+    seconds = now_seconds() - start;
+
+    if (atomic_load(&failed)) {
+        fprintf(stderr, "writing the shards failed\n");
+        return 1;
+    }
+    printf("selfplay,games,records,threads,seconds,records_per_min\n");
+    printf("selfplay,%ld,%llu,%d,%.3f,%.0f\n", game_count, (unsigned long long)records,
+           threads, seconds, records / seconds * 60);
+    return 0;
+}
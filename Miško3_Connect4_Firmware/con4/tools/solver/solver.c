@@ -0,0 +1,415 @@
+/*
+ * solver.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Labels dataset positions (tools/dataset) with their exact game-theoretic
+ * value: win, draw or loss for the side to move, and how many plies the game
+ * lasts with perfect play (the winner wins as fast as it can, the loser
+ * holds out as long as it can). The targets for training python_model
+ * beyond what self-play outcomes can teach.
+ *
+ * The solver is the usual strong Connect 4 one on the bitboard.h layout:
+ * negamax alpha-beta over exact scores, null-window searches that narrow
+ * the score down, only moves that do not hand the opponent a win, moves
+ * that make the most threats first, and a transposition table. Threads
+ * label different positions and share one table; every entry is a single
+ * 64-bit word (key and bounded score) written and read atomically, so
+ * there are no locks and a torn entry cannot occur.
+ *
+ * Usage: solver [-j threads] [-t table_mb] [-k chunk] [-m min_ply] input.c4ds prefix
+ *   -j threads   default the number of cores
+ *   -t table_mb  transposition table size, default 256
+ *   -k chunk     records per output part, default 4096
+ *   -m min_ply   leave positions with fewer discs unlabelled, default 0
+ *
+ * The output is <prefix>-<n>.c4ds, one part per chunk of the input in the
+ * same order, with value (+1, 0, -1) and distance set. A part appears under
+ * its name only when it is complete, so a run that is stopped carries on
+ * from the first missing part when it is started again.
+ *
+ * Output CSV per part and for the run:
+ *   solve,part,records,labelled,seconds,positions_per_s,nodes,tt_hit_rate
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dataset.h"
+
+#define MAX_THREADS    256
+
+// Score: 22 - own discs at the win for the side to move (negative: the opponent wins), 0 draw
+#define MIN_SCORE      (-(BB_CELLS) / 2 + 3)
+#define MAX_SCORE      ((BB_CELLS + 1) / 2 - 3)
+
+typedef struct {
+    uint64_t nodes;
+    uint64_t probes;
+    uint64_t hits;
+} solver_stats_t;
+
+static const uint8_t move_order[COLS] = { 3, 2, 4, 1, 5, 0, 6 };
+
+static uint64_t bottom_mask;
+static uint64_t board_mask;
+
+static _Atomic uint64_t* table;
+static int table_bits;
+
+static dataset_record_t* chunk;
+static size_t chunk_count;
+static atomic_size_t next_record;
+static int min_ply;
+
+// ------------------- Transposition table ---------------------
+
+// Entry: key (49 bits, current + mask) << 8 | encoded bound, 0 = empty
+static unsigned table_get(uint64_t key, solver_stats_t* st) {
+    uint64_t e = atomic_load_explicit(&table[(key * 0x9E3779B97F4A7C15ULL) >> (64 - table_bits)],
+                                      memory_order_relaxed);
+
+    st->probes++;
+    if ((e >> 8) == key) {
+        st->hits++;
+        return e & 0xFF;
+    }
+    return 0;
+}
+
+static void table_put(uint64_t key, unsigned value) {
+    atomic_store_explicit(&table[(key * 0x9E3779B97F4A7C15ULL) >> (64 - table_bits)],
+                          key << 8 | value, memory_order_relaxed);
+}
+
+// ------------------- Solver ---------------------
+
+static uint64_t key_of(const bitboard_t* p) {
+    return p->current + p->mask;
+}
+
+static uint64_t possible(const bitboard_t* p) {
+    return (p->mask + bottom_mask) & board_mask;
+}
+
+// Empty cells that complete four of `discs`
+static uint64_t winning_cells(uint64_t discs, uint64_t mask) {
+    static const int directions[3] = { BB_HEIGHT - 1, BB_HEIGHT, BB_HEIGHT + 1 };
+    uint64_t r = (discs << 1) & (discs << 2) & (discs << 3);
+
+    for (int i = 0; i < 3; i++) {
+        int d = directions[i];
+        uint64_t p = (discs << d) & (discs << 2 * d);
+
+        r |= p & (discs << 3 * d);
+        r |= p & (discs >> d);
+        p = (discs >> d) & (discs >> 2 * d);
+        r |= p & (discs << d);
+        r |= p & (discs >> 3 * d);
+    }
+    return r & (board_mask ^ mask);
+}
+
+// Playable cells that do not let the opponent win next; 0 if every move loses
+static uint64_t non_losing_moves(const bitboard_t* p) {
+    uint64_t moves = possible(p);
+    uint64_t threats = winning_cells(p->current ^ p->mask, p->mask);
+    uint64_t forced = moves & threats;
+
+    if (forced) {
+        if (forced & (forced - 1)) {
+            return 0;                 // two threats at once
+        }
+        moves = forced;
+    }
+    return moves & ~(threats >> 1);
+}
+
+static int popcount(uint64_t x) {
+    return __builtin_popcountll(x);
+}
+
+static void play_cell(bitboard_t* p, uint64_t cell) {
+    p->current ^= p->mask;
+    p->mask |= cell;
+    p->moves++;
+}
+
+// Exact score if it is inside (alpha, beta), else a bound on the same side.
+// The side to move cannot win on this move.
+static int negamax(const bitboard_t* p, int alpha, int beta, solver_stats_t* st) {
+    uint64_t next = non_losing_moves(p);
+    uint64_t moves[COLS];
+    int scores[COLS], count = 0;
+    unsigned entry;
+    int bound;
+
+    st->nodes++;
+    if (next == 0) {
+        return -(BB_CELLS - p->moves) / 2;
+    }
+    if (p->moves >= BB_CELLS - 2) {
+        return 0;
+    }
+
+    // The opponent cannot win on the next move, so neither that fast
+    bound = -(BB_CELLS - 2 - p->moves) / 2;
+    if (alpha < bound) {
+        alpha = bound;
+        if (alpha >= beta) {
+            return alpha;
+        }
+    }
+    entry = table_get(key_of(p), st);
+    if (entry > MAX_SCORE - MIN_SCORE + 1) {
+        bound = entry + 2 * MIN_SCORE - MAX_SCORE - 2;
+        if (alpha < bound) {
+            alpha = bound;
+            if (alpha >= beta) {
+                return alpha;
+            }
+        }
+    }
+    // Nor can the side to move win on this move
+    bound = (BB_CELLS - 1 - p->moves) / 2;
+    if (entry && entry <= MAX_SCORE - MIN_SCORE + 1) {
+        bound = entry + MIN_SCORE - 1;
+    }
+    if (beta > bound) {
+        beta = bound;
+        if (alpha >= beta) {
+            return beta;
+        }
+    }
+
+    // Moves that make the most threats first, centre first among equals
+    for (int i = 0; i < COLS; i++) {
+        uint64_t cell = next & bb_column_mask(move_order[i]);
+        int score, k;
+
+        if (!cell) {
+            continue;
+        }
+        score = popcount(winning_cells(p->current | cell, p->mask));
+        for (k = count++; k > 0 && scores[k - 1] < score; k--) {
+            moves[k] = moves[k - 1];
+            scores[k] = scores[k - 1];
+        }
+        moves[k] = cell;
+        scores[k] = score;
+    }
+
+    for (int i = 0; i < count; i++) {
+        bitboard_t child = *p;
+        int score;
+
+        play_cell(&child, moves[i]);
+        score = -negamax(&child, -beta, -alpha, st);
+        if (score >= beta) {
+            table_put(key_of(p), score + MAX_SCORE - 2 * MIN_SCORE + 2);
+            return score;
+        }
+        if (score > alpha) {
+            alpha = score;
+        }
+    }
+    table_put(key_of(p), alpha - MIN_SCORE + 1);
+    return alpha;
+}
+
+static int solve(const bitboard_t* p, solver_stats_t* st) {
+    int min = -(BB_CELLS - p->moves) / 2;
+    int max = (BB_CELLS + 1 - p->moves) / 2;
+
+    if (possible(p) & winning_cells(p->current, p->mask)) {
+        return (BB_CELLS + 1 - p->moves) / 2;
+    }
+    // Null-window searches, first around 0 to settle win/draw/loss quickly
+    while (min < max) {
+        int med = min + (max - min) / 2;
+        int r;
+
+        if (med <= 0 && min / 2 < med) {
+            med = min / 2;
+        } else if (med >= 0 && max / 2 > med) {
+            med = max / 2;
+        }
+        r = negamax(p, med, med + 1, st);
+        if (r <= med) {
+            max = r;
+        } else {
+            min = r;
+        }
+    }
+    return min;
+}
+
+// Plies until the game ends with perfect play from a position with `moves` discs
+static int distance_of(int score, int moves) {
+    if (score > 0) {
+        return 2 * ((BB_CELLS / 2 + 1 - score) - moves / 2) - 1;
+    }
+    if (score < 0) {
+        return 2 * ((BB_CELLS / 2 + 1 + score) - (moves + 1) / 2);
+    }
+    return BB_CELLS - moves;
+}
+
+// ------------------- Driver ---------------------
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void* worker(void* arg) {
+    solver_stats_t* st = arg;
+    size_t i;
+
+    while ((i = atomic_fetch_add(&next_record, 1)) < chunk_count) {
+        dataset_record_t* r = &chunk[i];
+        bitboard_t pos;
+        int score;
+
+        if (r->ply < min_ply) {
+            r->value = DATASET_NO_VALUE;
+            r->distance = DATASET_NO_DISTANCE;
+            continue;
+        }
+        dataset_to_bitboard(r, &pos);
+        score = solve(&pos, st);
+        r->value = (score > 0) - (score < 0);
+        r->distance = distance_of(score, pos.moves);
+    }
+    return NULL;
+}
+
+static void print_stats(const char* part, size_t records, size_t labelled, double seconds,
+                        const solver_stats_t* st) {
+    printf("solve,%s,%zu,%zu,%.3f,%.1f,%llu,%.3f\n", part, records, labelled, seconds,
+           seconds > 0 ? labelled / seconds : 0, (unsigned long long)st->nodes,
+           st->probes ? (double)st->hits / st->probes : 0);
+    fflush(stdout);
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [-j threads] [-t table_mb] [-k chunk] [-m min_ply] input.c4ds prefix\n", argv0);
+}
+
+int main(int argc, char** argv) {
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    long table_mb = 256, chunk_size = 4096;
+    static solver_stats_t stats[MAX_THREADS];
+    pthread_t tid[MAX_THREADS];
+    solver_stats_t total = { 0 };
+    size_t total_labelled = 0, total_records = 0;
+    dataset_reader_t in;
+    const dataset_record_t* batch;
+    const char* prefix;
+    double run_start;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "j:t:k:m:")) != -1) {
+        switch (opt) {
+            case 'j': threads = atoi(optarg); break;
+            case 't': table_mb = atol(optarg); break;
+            case 'k': chunk_size = atol(optarg); break;
+            case 'm': min_ply = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if (argc - optind != 2 || threads < 1 || table_mb < 1 || chunk_size < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+    prefix = argv[optind + 1];
+    if (dataset_open(&in, argv[optind], 1) != 0) {
+        return 1;
+    }
+
+    for (int col = 0; col < COLS; col++) {
+        bottom_mask |= bb_bottom_mask(col);
+        board_mask |= bb_column_mask(col);
+    }
+    for (table_bits = 10; (8ULL << (table_bits + 1)) <= (uint64_t)table_mb << 20; table_bits++) {
+    }
+    table = calloc(1ULL << table_bits, sizeof(*table));
+    chunk = malloc(chunk_size * sizeof(*chunk));
+    if (!table || !chunk) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("solve,part,records,labelled,seconds,positions_per_s,nodes,tt_hit_rate\n");
+    run_start = now_seconds();
+    for (int part = 0; (chunk_count = dataset_next_batch(&in, chunk_size, &batch)) > 0; part++) {
+        char path[256], tmp[264], name[16];
+        solver_stats_t sum = { 0 };
+        dataset_reader_t done;
+        dataset_writer_t out;
+        size_t labelled = 0;
+        double start;
+
+        snprintf(path, sizeof(path), "%s-%04d.c4ds", prefix, part);
+        snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+        snprintf(name, sizeof(name), "%04d", part);
+        if (access(path, F_OK) == 0 && dataset_open(&done, path, 1) == 0) {
+            int complete = done.header.records == chunk_count;
+
+            dataset_close(&done);
+            if (complete) {
+                continue;             // from an earlier run
+            }
+        }
+
+        memcpy(chunk, batch, chunk_count * sizeof(*chunk));
+        memset(stats, 0, sizeof(stats));
+        atomic_store(&next_record, 0);
+        start = now_seconds();
+        for (int t = 0; t < threads; t++) {
+            pthread_create(&tid[t], NULL, worker, &stats[t]);
+        }
+        for (int t = 0; t < threads; t++) {
+            pthread_join(tid[t], NULL);
+            sum.nodes += stats[t].nodes;
+            sum.probes += stats[t].probes;
+            sum.hits += stats[t].hits;
+        }
+        for (size_t i = 0; i < chunk_count; i++) {
+            labelled += chunk[i].value != DATASET_NO_VALUE;
+        }
+
+        if (dataset_create(&out, tmp, in.header.seed) != 0 ||
+            dataset_write(&out, chunk, chunk_count) != 0 ||
+            dataset_finish(&out) != 0) {
+            return 1;
+        }
+        if (rename(tmp, path) != 0) {
+            perror(path);
+            return 1;
+        }
+        print_stats(name, chunk_count, labelled, now_seconds() - start, &sum);
+
+        total.nodes += sum.nodes;
+        total.probes += sum.probes;
+        total.hits += sum.hits;
+        total_labelled += labelled;
+        total_records += chunk_count;
+    }
+    print_stats("total", total_records, total_labelled, now_seconds() - run_start, &total);
+    dataset_close(&in);
+    return 0;
+}
@@ -0,0 +1,38 @@
+# solver_threads.cmake
+#
+#  Created on: 19 Oct 2026
+#
+# Labels INPUT with one thread and with four and fails unless every output
+# part is the same byte for byte: the shared transposition table may change
+# the search, never the labels.
+#
+# Usage: cmake -DSOLVER=path -DINPUT=file.c4ds -P solver_threads.cmake
+# The solver carries on from existing parts, so old output is removed first.
+
+file(GLOB old j1-*.c4ds j4-*.c4ds)
+if(old)
+    file(REMOVE ${old})
+endif()
+
+foreach(threads 1 4)
+    execute_process(COMMAND ${SOLVER} -j${threads} -t 16 -k 128 -m 14 ${INPUT} j${threads}
+        OUTPUT_QUIET RESULT_VARIABLE status)
+    if(NOT status EQUAL 0)
+        message(FATAL_ERROR "solver -j${threads} failed: ${status}")
+    endif()
+endforeach()
+
+file(GLOB parts RELATIVE ${CMAKE_CURRENT_BINARY_DIR} j1-*.c4ds)
+if(NOT parts)
+    message(FATAL_ERROR "solver wrote no output")
+endif()
+foreach(part ${parts})
+    string(REGEX REPLACE "^j1-" "j4-" other ${part})
+    execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${part} ${other}
+        RESULT_VARIABLE status)
+    if(NOT status EQUAL 0)
+        message(FATAL_ERROR "${part} and ${other} differ")
+    endif()
+endforeach()
+list(LENGTH parts count)
+message(STATUS "solver -j1 and -j4: ${count} parts identical")
@@ -0,0 +1,458 @@
+/*
+ * tournament.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Self-play tournament between AI configurations, on all cores, to measure
+ * playing strength and speed offline. Every pair of configurations plays
+ * -n games round robin. Games come in pairs that share a random opening of
+ * -o plies with the colours swapped, so neither side profits from a lucky
+ * opening. Players:
+ *
+ *   random      a random legal move
+ *   mlp         the network's greedy move, as ai_model.c plays it
+ *   mlp8        the same with int8 weights (one scale per output row)
+ *   search:N    search.c to depth N with the network as the prior, as the
+ *               ai task plays it, but to a fixed depth instead of a think time
+ *
+ * Each game is reproducible from its number: the opening and the random
+ * player are seeded from -s and the game number, and the search stops at a
+ * depth, not a time. -g replays one game and prints its moves.
+ *
+ * Usage: tournament [-j threads] [-n games] [-s seed] [-o plies] [-g game] player...
+ *   -j threads  worker threads, default the number of cores
+ *   -n games    games per pairing, rounded up to even, default 200
+ *   -s seed     default 1
+ *   -o plies    random opening plies, default 4
+ *   -g game     play only this game (numbered as in the loop over pairings)
+ *
+ * Output CSV:
+ *   pairing,a,b,games,wins,draws,losses,score,elo,elo_lo,elo_hi   (for a, 95% interval;
+ *                        the score is clamped to [0.5/games, 1 - 0.5/games] so sweeps stay finite)
+ *   latency,player,moves,p50_us,p90_us,p99_us,max_us
+ *   summary,games,threads,seconds,games_per_s
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "game.h"
+#include "bitboard.h"
+#include "search.h"
+#include "ai_kernel.h"
+
+#define MAX_PLAYERS        8
+#define MAX_THREADS        256
+#define LATENCY_BUCKETS    160     // 4 per octave from 1 ns
+#define GAMES_PER_CLAIM    4
+
+typedef enum {
+    PLAYER_RANDOM,
+    PLAYER_MLP,
+    PLAYER_MLP8,
+    PLAYER_SEARCH
+} player_kind_t;
+
+typedef struct {
+    char name[32];
+    player_kind_t kind;
+    int depth;
+} player_t;
+
+typedef struct {
+    int8_t winner;                 // 0 first player of the pairing, 1 second, -1 draw
+    uint8_t plies;
+    uint8_t moves[BB_CELLS];
+} game_result_t;
+
+typedef struct {
+    uint64_t moves;
+    uint64_t max_ns;
+    uint64_t buckets[LATENCY_BUCKETS];
+} latency_t;
+
+static player_t players[MAX_PLAYERS];
+static int player_count;
+static int games_per_pairing = 200;
+static int opening_plies = 4;
+static uint64_t base_seed = 1;
+
+static int pairing_count;
+static int pairing_a[MAX_PLAYERS * MAX_PLAYERS];
+static int pairing_b[MAX_PLAYERS * MAX_PLAYERS];
+
+static game_result_t* results;
+static atomic_long next_game;
+static long total_games;
+
+static latency_t latency[MAX_THREADS][MAX_PLAYERS];
+
+// ------------------- Helpers ---------------------
+
+static uint64_t splitmix64(uint64_t* s) {
+    uint64_t z = (*s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int random_legal_move(const bitboard_t* pos, uint64_t* rng) {
+    int legal[COLS], n = 0;
+
+    for (int col = 0; col < COLS; col++) {
+        if (bb_can_play(pos, col)) {
+            legal[n++] = col;
+        }
+    }
+    return legal[splitmix64(rng) % n];
+}
+
+// ------------------- Network players ---------------------
+
+// int8 copy of python_model, one scale per output row
+static struct {
+    int8_t* weights;
+    float* scale;
+} quant[AI_KERNEL_LAYERS];
+
+static void quantize_model(void) {
+    for (int l = 0; l < AI_KERNEL_LAYERS; l++) {
+        const ai_kernel_layer_t* layer = ai_kernel_layer(l);
+
+        quant[l].weights = malloc((size_t)layer->inputs * layer->outputs);
+        quant[l].scale = malloc(sizeof(float) * layer->outputs);
+        for (int o = 0; o < layer->outputs; o++) {
+            const float* row = layer->weights + o * layer->inputs;
+            float max = 0;
+
+            for (int i = 0; i < layer->inputs; i++) {
+                max = fmaxf(max, fabsf(row[i]));
+            }
+            quant[l].scale[o] = max > 0 ? max / 127 : 1;
+            for (int i = 0; i < layer->inputs; i++) {
+                quant[l].weights[o * layer->inputs + i] = (int8_t)lrintf(row[i] / quant[l].scale[o]);
+            }
+        }
+    }
+}
+
+static void dense_int8(int l, const float* in, float* out) {
+    const ai_kernel_layer_t* layer = ai_kernel_layer(l);
+
+    for (int o = 0; o < layer->outputs; o++) {
+        const int8_t* row = quant[l].weights + o * layer->inputs;
+        float sum = 0;
+
+        for (int i = 0; i < layer->inputs; i++) {
+            sum += row[i] * in[i];
+        }
+        sum = sum * quant[l].scale[o] + layer->bias[o];
+        out[o] = (layer->relu && sum < 0) ? 0 : sum;
+    }
+}
+
+// Network values for `pos`, the side to move playing as PLAYER_AI
+static void network_values(const bitboard_t* pos, int int8, float* values) {
+    ai_i8 state[AI_KERNEL_INPUTS];
+    float input[AI_KERNEL_INPUTS];
+    float hidden1[AI_KERNEL_HIDDEN], hidden2[AI_KERNEL_HIDDEN];
+
+    bb_to_board(pos, game.board, game.PLAYER_AI, game.PLAYER_HUMAN);
+    get_state(state);
+    ai_kernel_input_from_state(state, input);
+    if (int8) {
+        dense_int8(0, input, hidden1);
+        dense_int8(1, hidden1, hidden2);
+        dense_int8(2, hidden2, values);
+    } else {
+        ai_kernel_run(input, values);
+    }
+}
+
+// ------------------- Games ---------------------
+
+static int choose_move(const player_t* p, const bitboard_t* pos, uint64_t* rng) {
+    float values[AI_KERNEL_OUTPUTS];
+
+    switch (p->kind) {
+        case PLAYER_RANDOM:
+            return random_legal_move(pos, rng);
+        case PLAYER_MLP:
+        case PLAYER_MLP8:
+            // game.board holds the position, so check_if_valid() in the move choice sees it
+            network_values(pos, p->kind == PLAYER_MLP8, values);
+            return ai_kernel_best_move(values);
+        case PLAYER_SEARCH:
+            network_values(pos, 0, values);
+            search_start(pos, 0);
+            search_set_max_depth(p->depth);
+            while (!search_run(1000000)) {
+            }
+            return search_best_move(values);
+    }
+    return -1;
+}
+
+// Plays game `index`; latencies go to `lat` (this thread's row)
+static void play_game(long index, latency_t* lat) {
+    int pairing = index / games_per_pairing;
+    int swap = index % 2;
+    int side[2] = { pairing_a[pairing], pairing_b[pairing] };
+    game_result_t* r = &results[index];
+    uint64_t seed = base_seed * 0x100000001B3ULL + (uint64_t)(index / 2);
+    uint64_t rng[2];
+    bitboard_t pos = { 0, 0, 0 };
+
+    // Both games of a pair get the same opening and the same random players
+    splitmix64(&seed);
+    rng[0] = splitmix64(&seed);
+    rng[1] = splitmix64(&seed);
+
+    r->winner = -1;
+    r->plies = 0;
+    for (int ply = 0; pos.moves < BB_CELLS; ply++) {
+        int mover = (ply % 2) ^ swap;         // 0 = first player of the pairing
+        int col;
+
+        if (ply < opening_plies) {
+            col = random_legal_move(&pos, &seed);
+            if (bb_is_winning_move(&pos, col)) {
+                break;                        // a lucky opening: leave it drawn
+            }
+        } else {
+            const player_t* p = &players[side[mover]];
+            uint64_t start = now_ns(), ns;
+
+            col = choose_move(p, &pos, &rng[mover]);
+            ns = now_ns() - start;
+            if (col < 0 || !bb_can_play(&pos, col)) {
+                fprintf(stderr, "game %ld: %s played an illegal move\n", index, p->name);
+                r->winner = !mover;
+                break;
+            }
+            latency_t* l = &lat[side[mover]];
+            int bucket = ns ? (int)(4 * log2((double)ns)) : 0;
+            l->moves++;
+            l->buckets[bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1]++;
+            if (ns > l->max_ns) {
+                l->max_ns = ns;
+            }
+        }
+
+        r->moves[r->plies++] = col;
+        if (bb_is_winning_move(&pos, col)) {
+            r->winner = mover;
+            break;
+        }
+        bb_play(&pos, col);
+    }
+}
+
+static void* worker(void* arg) {
+    latency_t* lat = latency[(intptr_t)arg];
+
+    for (;;) {
+        long first = atomic_fetch_add(&next_game, GAMES_PER_CLAIM);
+        if (first >= total_games) {
+            return NULL;
+        }
+        for (long g = first; g < first + GAMES_PER_CLAIM && g < total_games; g++) {
+            play_game(g, lat);
+        }
+    }
+}
+
+// ------------------- Report ---------------------
+
+// A sweep (or an interval edge past 0 or 1) has no finite Elo. The score is
+// clamped half a game inside, so n games bound the difference at about
+// 400 * log10(2n - 1): +-1040 Elo for 200 games.
+static double elo_of_score(double score, int n) {
+    double limit = 0.5 / n;
+
+    if (score < limit) {
+        score = limit;
+    }
+    if (score > 1 - limit) {
+        score = 1 - limit;
+    }
+    return -400 * log10(1 / score - 1);
+}
+
+static void report_pairing(int pairing) {
+    int wins = 0, draws = 0, losses = 0, n;
+    double score, deviation = 0, margin;
+
+    for (long g = (long)pairing * games_per_pairing; g < (long)(pairing + 1) * games_per_pairing; g++) {
+        wins += results[g].winner == 0;
+        draws += results[g].winner < 0;
+        losses += results[g].winner == 1;
+    }
+    n = wins + draws + losses;
+    score = (wins + 0.5 * draws) / n;
+    deviation = (wins * pow(1 - score, 2) + draws * pow(0.5 - score, 2) + losses * pow(score, 2)) / n;
+    margin = 1.96 * sqrt(deviation / n);
+
+    printf("pairing,%s,%s,%d,%d,%d,%d,%.3f,%.0f,%.0f,%.0f\n",
+           players[pairing_a[pairing]].name, players[pairing_b[pairing]].name,
+           n, wins, draws, losses, score,
+           elo_of_score(score, n), elo_of_score(score - margin, n), elo_of_score(score + margin, n));
+}
+
+// Upper edge of the bucket holding the `fraction` quantile, in microseconds
+static double latency_quantile(const latency_t* l, double fraction) {
+    uint64_t target = (uint64_t)ceil(fraction * l->moves), seen = 0;
+
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += l->buckets[b];
+        if (seen >= target) {
+            return fmin(pow(2, (b + 1) / 4.0), (double)l->max_ns) / 1000;
+        }
+    }
+    return l->max_ns / 1000.0;
+}
+
+static void report_latency(int threads) {
+    for (int p = 0; p < player_count; p++) {
+        latency_t sum = { 0 };
+
+        for (int t = 0; t < threads; t++) {
+            sum.moves += latency[t][p].moves;
+            if (latency[t][p].max_ns > sum.max_ns) {
+                sum.max_ns = latency[t][p].max_ns;
+            }
+            for (int b = 0; b < LATENCY_BUCKETS; b++) {
+                sum.buckets[b] += latency[t][p].buckets[b];
+            }
+        }
+        if (sum.moves == 0) {
+            continue;
+        }
+        printf("latency,%s,%llu,%.2f,%.2f,%.2f,%.2f\n", players[p].name,
+               (unsigned long long)sum.moves, latency_quantile(&sum, 0.5),
+               latency_quantile(&sum, 0.9), latency_quantile(&sum, 0.99), sum.max_ns / 1000.0);
+    }
+}
+
+// ------------------- Driver ---------------------
+
+static int parse_player(const char* arg, player_t* p) {
+    snprintf(p->name, sizeof(p->name), "%s", arg);
+    if (strcmp(arg, "random") == 0) {
+        p->kind = PLAYER_RANDOM;
+    } else if (strcmp(arg, "mlp") == 0) {
+        p->kind = PLAYER_MLP;
+    } else if (strcmp(arg, "mlp8") == 0) {
+        p->kind = PLAYER_MLP8;
+    } else if (strncmp(arg, "search:", 7) == 0 && atoi(arg + 7) > 0 && atoi(arg + 7) <= BB_CELLS) {
+        p->kind = PLAYER_SEARCH;
+        p->depth = atoi(arg + 7);
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [-j threads] [-n games] [-s seed] [-o plies] [-g game] player...\n"
+                    "players: random mlp mlp8 search:N\n", argv0);
+}
+
+int main(int argc, char** argv) {
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    long replay = -1;
+    pthread_t tid[MAX_THREADS];
+    double start, seconds;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "j:n:s:o:g:")) != -1) {
+        switch (opt) {
+            case 'j': threads = atoi(optarg); break;
+            case 'n': games_per_pairing = atoi(optarg); break;
+            case 's': base_seed = strtoull(optarg, NULL, 0); break;
+            case 'o': opening_plies = atoi(optarg); break;
+            case 'g': replay = atol(optarg); break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    for (; optind < argc && player_count < MAX_PLAYERS; optind++) {
+        if (!parse_player(argv[optind], &players[player_count++])) {
+            fprintf(stderr, "unknown player %s\n", argv[optind]);
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (player_count < 2 || games_per_pairing < 1 || opening_plies < 0 || threads < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+    games_per_pairing += games_per_pairing % 2;
+
+    for (int a = 0; a < player_count; a++) {
+        for (int b = a + 1; b < player_count; b++) {
+            pairing_a[pairing_count] = a;
+            pairing_b[pairing_count++] = b;
+        }
+    }
+    total_games = (long)pairing_count * games_per_pairing;
+    results = calloc(total_games, sizeof(*results));
+    quantize_model();
+
+    if (replay >= 0) {
+        game_result_t* r;
+
+        if (replay >= total_games) {
+            fprintf(stderr, "there are %ld games\n", total_games);
+            return 2;
+        }
+        play_game(replay, latency[0]);
+        r = &results[replay];
+        printf("game %ld: %s vs %s, %s moves first\nmoves ", replay,
+               players[pairing_a[replay / games_per_pairing]].name,
+               players[pairing_b[replay / games_per_pairing]].name,
+               (replay % 2) ? "second" : "first");
+        for (int i = 0; i < r->plies; i++) {
+            printf("%d", r->moves[i] + 1);
+        }
+        printf("\nresult %s\n", r->winner < 0 ? "draw" : r->winner == 0 ? "first wins" : "second wins");
+        return 0;
+    }
+
+    start = now_ns() * 1e-9;
+    for (intptr_t t = 0; t < threads; t++) {
+        pthread_create(&tid[t], NULL, worker, (void*)t);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tid[t], NULL);
+    }
+    seconds = now_ns() * 1e-9 - start;
+
+    printf("pairing,a,b,games,wins,draws,losses,score,elo,elo_lo,elo_hi\n");
+    for (int p = 0; p < pairing_count; p++) {
+        report_pairing(p);
+    }
+    printf("latency,player,moves,p50_us,p90_us,p99_us,max_us\n");
+    report_latency(threads);
+    printf("summary,games,threads,seconds,games_per_s\n");
+    printf("summary,%ld,%d,%.3f,%.1f\n", total_games, threads, seconds, total_games / seconds);
+    return 0;
+}
@@ -0,0 +1,37 @@
+# tournament_replay.cmake
+#
+#  Created on: 19 Oct 2026
+#
+# Every game is reproducible from -s and its number: -g must print the same
+# moves on every run, and a whole tournament must give the same pairing
+# lines with one thread and with four.
+#
+# Usage: cmake -DTOURNAMENT=path -P tournament_replay.cmake
+
+set(players random search:4 mlp)
+
+foreach(game 0 5 11)
+    foreach(run 1 2)
+        execute_process(COMMAND ${TOURNAMENT} -s 7 -g ${game} ${players}
+            RESULT_VARIABLE status OUTPUT_VARIABLE moves_${run})
+        if(NOT status EQUAL 0)
+            message(FATAL_ERROR "tournament -g ${game} failed: ${status}")
+        endif()
+    endforeach()
+    if(NOT moves_1 STREQUAL moves_2)
+        message(FATAL_ERROR "game ${game} differs between runs:\n${moves_1}\n${moves_2}")
+    endif()
+    message("${moves_1}")
+endforeach()
+
+foreach(threads 1 4)
+    execute_process(COMMAND ${TOURNAMENT} -j${threads} -n 4 -s 7 ${players}
+        RESULT_VARIABLE status OUTPUT_VARIABLE output)
+    if(NOT status EQUAL 0)
+        message(FATAL_ERROR "tournament -j${threads} failed: ${status}")
+    endif()
+    string(REGEX MATCHALL "pairing,[^\n]*" pairings_${threads} "${output}")
+endforeach()
+if(NOT pairings_1 STREQUAL pairings_4)
+    message(FATAL_ERROR "-j1 and -j4 differ:\n${pairings_1}\n${pairings_4}")
+endif()
@@ -0,0 +1,308 @@
+/*
+ * trace_decode.c
+ *
+ *  Created on: 19 Oct 2026
+ *
+ * Turns the binary trace stream written by system/trace.c back into a
+ * readable log. Bytes outside records (text sent with SCI_send_string()
+ * before or around the trace) are passed through unchanged.
+ *
+ * Usage: trace_decode [-c hz] [-a] [file]
+ *   -c hz    timestamp clock, default 170000000 (DWT cycle counter at HCLK)
+ *   -a       print only the network runs, one CSV line per TRACE_AI_INPUT
+ *            and the TRACE_AI_OUTPUT after it: 147 inputs, 7 outputs with
+ *            every float digit, the reference format of tools/ai_check
+ *   file     capture to decode, default stdin, e.g.
+ *              stty -F /dev/ttyACM0 115200 raw && trace_decode /dev/ttyACM0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "trace_events.h"
+#include "game.h"
+#include "game_record.h"
+
+typedef struct {
+    const char* name;
+    const char* format;
+} event_info_t;
+
+#define TRACE_EVENT_INFO(id, format) [id] = { #id, format },
+
+static const event_info_t events[TRACE_EVENT_END] = {
+    TRACE_EVENT_LIST(TRACE_EVENT_INFO)
+};
+
+static double clock_hz = 170e6;
+static uint64_t time_base;          // unwrapped cycles of the first record
+static uint64_t time_wraps;         // DWT->CYCCNT wraps every ~25 s at 170 MHz
+static uint32_t last_timestamp;
+static int have_time;
+static int at_line_start = 1;
+
+static int ai_pairs_only;
+static uint8_t ai_input[ROWS * COLS * 3 + 3 * COLS];
+static int have_ai_input;
+
+// ------------------- Output helpers ---------------------
+
+static double seconds(uint32_t timestamp) {
+    if (!have_time) {
+        time_base = timestamp;
+        have_time = 1;
+    } else if (timestamp < last_timestamp) {
+        time_wraps += 1ULL << 32;
+    }
+    last_timestamp = timestamp;
+    return (double)(time_wraps + timestamp - time_base) / clock_hz;
+}
+
+static void end_line(void) {
+    if (!at_line_start) {
+        putchar('\n');
+        at_line_start = 1;
+    }
+}
+
+static void print_text(const uint8_t* text, uint32_t size, double t) {
+    for (uint32_t i = 0; i < size; i++) {
+        if (at_line_start) {
+            printf("[%11.6f] ", t);
+            at_line_start = 0;
+        }
+        putchar(text[i]);
+        if (text[i] == '\n') {
+            at_line_start = 1;
+        }
+    }
+}
+
+static void print_hex(const uint8_t* payload, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) {
+        printf(" %02x", payload[i]);
+    }
+    printf("\n");
+}
+
+// Same layout as printf_render()
+static void print_board(const uint8_t* payload, uint32_t size) {
+    if (size != ROWS * COLS) {
+        print_hex(payload, size);
+        return;
+    }
+    printf("\n");
+    for (int row = ROWS - 1; row >= 0; row--) {
+        printf("              |");
+        for (int col = 0; col < COLS; col++) {
+            int8_t cell = (int8_t)payload[row * COLS + col];
+            if (cell == 0) {
+                printf(" |");
+            } else {
+                printf("%d|", cell);
+            }
+        }
+        printf("\n");
+    }
+    printf("               1 2 3 4 5 6 7\n");
+}
+
+// One-hot board (3 per cell), then valid, blocking and winning moves (7 each)
+static void print_ai_input(const uint8_t* payload, uint32_t size) {
+    static const char* const blocks[] = { "valid", "block", "win" };
+
+    if (size != ROWS * COLS * 3 + 3 * COLS) {
+        print_hex(payload, size);
+        return;
+    }
+    printf("\n              board:");
+    for (int cell = 0; cell < ROWS * COLS; cell++) {
+        const uint8_t* hot = &payload[cell * 3];
+        printf("%s%c", (cell % COLS) ? "" : " ", hot[1] ? 'A' : hot[2] ? 'H' : '.');
+    }
+    for (int b = 0; b < 3; b++) {
+        printf("\n              %5s:", blocks[b]);
+        for (int col = 0; col < COLS; col++) {
+            printf(" %d", (int8_t)payload[ROWS * COLS * 3 + b * COLS + col]);
+        }
+    }
+    printf("\n");
+}
+
+static void print_ai_output(const uint8_t* payload, uint32_t size) {
+    float p[COLS];
+
+    if (size != sizeof(p)) {
+        print_hex(payload, size);
+        return;
+    }
+    memcpy(p, payload, sizeof(p));
+    for (int col = 0; col < COLS; col++) {
+        printf(" %d:%.2f", col + 1, p[col]);
+    }
+    printf("\n");
+}
+
+// One "x,y" line per sample, the input format of tools/joy_replay
+static void print_joy_samples(const uint8_t* payload, uint32_t size) {
+    uint16_t sample[2];
+
+    if (size % sizeof(sample) != 0) {
+        print_hex(payload, size);
+        return;
+    }
+    printf("\n");
+    for (uint32_t i = 0; i < size; i += sizeof(sample)) {
+        memcpy(sample, &payload[i], sizeof(sample));
+        printf("              %u,%u\n", sample[0], sample[1]);
+    }
+}
+
+// Columns from 1 like the board, AI moves marked with *; tools/replay checks the record
+static void print_game_record(const uint8_t* payload, uint32_t size) {
+    static const char* const results[] = { "human won", "AI won", "draw", "unfinished" };
+    game_record_t rec;
+
+    memcpy(&rec, payload, size < sizeof(rec) ? size : sizeof(rec));
+    if (size != sizeof(rec) || rec.magic != GAME_RECORD_MAGIC || rec.plies > GAME_RECORD_MAX_PLIES ||
+        rec.result > GAME_RECORD_UNFINISHED) {
+        print_hex(payload, size);
+        return;
+    }
+    printf(": seq=%u result=%u (%s) plies=%u\n              moves:", rec.sequence, rec.result,
+           results[rec.result], rec.plies);
+    for (int ply = 0; ply < rec.plies; ply++) {
+        printf(" %d%s", game_record_move(&rec, ply) + 1, game_record_ai_index(&rec, ply) >= 0 ? "*" : "");
+    }
+    printf("\n              ms:   ");
+    for (int ply = 0; ply < rec.plies; ply++) {
+        printf(" %u", rec.ply_ms[ply]);
+    }
+    printf("\n");
+}
+
+// -a: an input is held until the output of the same run arrives
+static void print_ai_pair(uint8_t id, const uint8_t* payload, uint32_t size) {
+    float p[COLS];
+
+    if (id == TRACE_AI_INPUT && size == sizeof(ai_input)) {
+        memcpy(ai_input, payload, size);
+        have_ai_input = 1;
+        return;
+    }
+    if (id != TRACE_AI_OUTPUT || size != sizeof(p) || !have_ai_input) {
+        return;
+    }
+    memcpy(p, payload, sizeof(p));
+    for (uint32_t i = 0; i < sizeof(ai_input); i++) {
+        printf("%d,", (int8_t)ai_input[i]);
+    }
+    for (int col = 0; col < COLS; col++) {
+        printf("%.9g%s", p[col], col < COLS - 1 ? "," : "\n");
+    }
+    have_ai_input = 0;
+}
+
+static void print_record(uint8_t id, const uint8_t* payload, uint32_t size, uint32_t timestamp) {
+    double t = seconds(timestamp);
+
+    if (id == TRACE_ID_TEXT) {
+        print_text(payload, size, t);
+        return;
+    }
+
+    end_line();
+    printf("[%11.6f] ", t);
+
+    if (id == TRACE_ID_OVERFLOW && size == 4) {
+        uint32_t lost;
+        memcpy(&lost, payload, 4);
+        printf("*** %u trace records lost (buffer full)\n", lost);
+        return;
+    }
+    if (id >= TRACE_EVENT_END || events[id].name == NULL) {
+        printf("event %u:", id);
+        print_hex(payload, size);
+        return;
+    }
+
+    printf("%s", events[id].name + strlen("TRACE_"));
+    switch (id) {
+        case TRACE_BOARD:     print_board(payload, size); return;
+        case TRACE_AI_INPUT:  print_ai_input(payload, size); return;
+        case TRACE_AI_OUTPUT: print_ai_output(payload, size); return;
+        case TRACE_JOY_SAMPLES: print_joy_samples(payload, size); return;
+        case TRACE_GAME_RECORD: print_game_record(payload, size); return;
+        default: break;
+    }
+
+    if (events[id].format == NULL || size % 4 != 0 || size > 16) {
+        print_hex(payload, size);
+        return;
+    }
+    uint32_t args[4] = { 0 };
+    memcpy(args, payload, size);
+    printf(": ");
+    printf(events[id].format, args[0], args[1], args[2], args[3]);
+    printf("\n");
+}
+
+// ------------------- Main ---------------------
+
+int main(int argc, char** argv) {
+    FILE* in = stdin;
+    uint8_t record[TRACE_HEADER_SIZE + TRACE_MAX_PAYLOAD];
+    uint32_t records = 0;
+    int opt, c;
+
+    while ((opt = getopt(argc, argv, "c:a")) != -1) {
+        switch (opt) {
+            case 'c': clock_hz = atof(optarg); break;
+            case 'a': ai_pairs_only = 1; break;
+            default:
+                fprintf(stderr, "usage: %s [-c hz] [-a] [file]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind < argc && !(in = fopen(argv[optind], "rb"))) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    while ((c = fgetc(in)) != EOF) {
+        if (c != TRACE_SYNC) {
+            // Text sent around the trace, e.g. by the polling SCI functions
+            if (ai_pairs_only) {
+                continue;
+            }
+            putchar(c);
+            at_line_start = (c == '\n');
+            continue;
+        }
+        if (fread(&record[1], 1, TRACE_HEADER_SIZE - 1, in) != TRACE_HEADER_SIZE - 1) {
+            break;
+        }
+        uint8_t id = record[1];
+        uint8_t size = record[2];
+        uint32_t timestamp;
+        memcpy(&timestamp, &record[3], 4);
+        if (fread(&record[TRACE_HEADER_SIZE], 1, size, in) != size) {
+            break;
+        }
+        if (ai_pairs_only) {
+            print_ai_pair(id, &record[TRACE_HEADER_SIZE], size);
+        } else {
+            print_record(id, &record[TRACE_HEADER_SIZE], size, timestamp);
+        }
+        records++;
+        fflush(stdout);
+    }
+    if (!ai_pairs_only) {
+        end_line();
+    }
+    fprintf(stderr, "%u records\n", records);
+    return 0;
+}